@@ -16,8 +16,9 @@ namespace FastSatSolver {
   * @htmlonly
   * <ul>
   * <li>Module <a class="el" href="group__SatSolver.html">SatSolver</a> -
-  * Class AbstractSatSolver with its derived classes BlindSatSolver and
-  * GaSatSolver and their observers.</li>
+  * Class AbstractSatSolver with its derived classes BlindSatSolver,
+  * CdclSatSolver, GaSatSolver and LocalSearchSatSolver and their
+  * observers.</li>
   * <li>Module <a class="el" href="group__SatProblem.html">SatProblem</a> -
   * Internal SAT Problem representation with necessary tools for reading
   * and working with SAT Problems.</li>
@@ -40,7 +41,11 @@ namespace FastSatSolver {
   * - Class GaSatSolver - solver using GAlib library to solve SAT problem
   * - Class BlindSatSolver - solver using brute force method to solve SAT
   * problem
-  * - Class AbstractSatSolver - common interface of both solvers
+  * - Class CdclSatSolver - complete solver using conflict-driven clause
+  * learning on CNF of SAT problem
+  * - Class LocalSearchSatSolver - solver using stochastic local search
+  * (WalkSAT generalized to non-clausal formulas)
+  * - Class AbstractSatSolver - common interface of all solvers
   * 
   * @b Observers:
   * - Class TimedStop - observer which stops process after specified time
@@ -52,8 +57,8 @@ namespace FastSatSolver {
   * value is increased.
   * - Class ResultsWatch - Observer which write out message when solution is
   * found.
-   * @brief Class AbstractSatSolver with its derived classes BlindSatSolver and
-   * GaSatSolver and their observers.
+   * @brief Class AbstractSatSolver with its derived classes BlindSatSolver,
+   * CdclSatSolver, GaSatSolver and LocalSearchSatSolver and their observers.
   */
  
  /**
@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <assert.h>
+#include <limits.h>
+#include <algorithm>
+#include "BigNumber.h"
+
+namespace FastSatSolver {
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // BigNumber implementation
+  namespace {
+    const int WORD_BITS = sizeof(unsigned long) * CHAR_BIT;
+
+    // Products of half-words fit to word
+    const int HALF_BITS = WORD_BITS/2;
+    const unsigned long HALF_MASK = (1UL << HALF_BITS) - 1UL;
+
+    // The greatest power of ten, which fits to half-word
+    unsigned long decimalBase(int &digits) {
+      unsigned long base = 10UL;
+      digits = 1;
+      while (base*10UL <= HALF_MASK) {
+        base *= 10UL;
+        digits++;
+      }
+      return base;
+    }
+  }
+  BigNumber::BigNumber(unsigned long value) {
+    if (value)
+      words_.push_back(value);
+  }
+  BigNumber BigNumber::power2(int exponent) {
+    BigNumber number;
+    number.words_.resize(exponent / WORD_BITS + 1, 0UL);
+    number.words_.back() = 1UL << (exponent % WORD_BITS);
+    return number;
+  }
+  bool BigNumber::isZero() const {
+    return words_.empty();
+  }
+  bool BigNumber::getBit(int index) const {
+    const unsigned word = index / WORD_BITS;
+    if (word >= words_.size())
+      return false;
+    return (words_[word] >> (index % WORD_BITS)) & 1UL;
+  }
+  void BigNumber::setBit(int index) {
+    const unsigned word = index / WORD_BITS;
+    if (word >= words_.size())
+      words_.resize(word + 1, 0UL);
+    words_[word] |= 1UL << (index % WORD_BITS);
+  }
+  int BigNumber::getLowestBit() const {
+    for(unsigned i=0; i<words_.size(); i++) {
+      const unsigned long word = words_[i];
+      if (!word)
+        continue;
+      int bit = 0;
+      while (!((word >> bit) & 1UL))
+        bit++;
+      return i*WORD_BITS + bit;
+    }
+    return -1;
+  }
+  unsigned long BigNumber::getLowWord() const {
+    return (words_.empty())
+      ? 0UL
+      : words_[0];
+  }
+  double BigNumber::toDouble() const {
+    double value = 0.0;
+    for(int i=words_.size()-1; 0<=i; i--)
+      value = value * 2.0 * static_cast<double>(1UL << (WORD_BITS-1)) + words_[i];
+    return value;
+  }
+  std::string BigNumber::toString() const {
+    if (words_.empty())
+      return "0";
+    int digits;
+    const unsigned long base = decimalBase(digits);
+    BigNumber number(*this);
+    std::string text;
+    while (!number.isZero()) {
+      unsigned long rest = number.divide(base);
+      for(int i=0; i<digits && (rest || !number.isZero()); i++) {
+        text += static_cast<char>('0' + rest % 10UL);
+        rest /= 10UL;
+      }
+    }
+    std::reverse(text.begin(), text.end());
+    return text;
+  }
+  bool BigNumber::fromString(const std::string &text) {
+    if (text.empty())
+      return false;
+    const BigNumber ten(10UL);
+    BigNumber number;
+    for(unsigned i=0; i<text.size(); i++) {
+      const char c = text[i];
+      if (c < '0' || '9' < c)
+        return false;
+      number *= ten;
+      number += static_cast<unsigned long>(c - '0');
+    }
+    *this = number;
+    return true;
+  }
+  void BigNumber::clearLowBits(int count) {
+    const unsigned full = count / WORD_BITS;
+    for(unsigned i=0; i<full && i<words_.size(); i++)
+      words_[i] = 0UL;
+    const int rest = count % WORD_BITS;
+    if (rest && full < words_.size())
+      words_[full] &= ~0UL << rest;
+    this->normalize();
+  }
+  void BigNumber::addPower2(int exponent) {
+    unsigned word = exponent / WORD_BITS;
+    unsigned long value = 1UL << (exponent % WORD_BITS);
+    if (word >= words_.size())
+      words_.resize(word + 1, 0UL);
+    for(; value && word<words_.size(); word++) {
+      words_[word] += value;
+      value = (words_[word] < value);
+    }
+    if (value)
+      words_.push_back(value);
+  }
+  unsigned long BigNumber::divide(unsigned long divisor) {
+    assert(divisor);
+    // Long division by half-words to avoid overflow
+    assert(divisor <= HALF_MASK);
+    unsigned long rem = 0UL;
+    for(int i=words_.size()-1; 0<=i; i--) {
+      const unsigned long hi = (rem << HALF_BITS) | (words_[i] >> HALF_BITS);
+      const unsigned long qHi = hi / divisor;
+      rem = hi % divisor;
+      const unsigned long lo = (rem << HALF_BITS) | (words_[i] & HALF_MASK);
+      const unsigned long qLo = lo / divisor;
+      rem = lo % divisor;
+      words_[i] = (qHi << HALF_BITS) | qLo;
+    }
+    this->normalize();
+    return rem;
+  }
+  BigNumber& BigNumber::operator+= (const BigNumber &other) {
+    if (words_.size() < other.words_.size())
+      words_.resize(other.words_.size(), 0UL);
+    unsigned long carry = 0UL;
+    for(unsigned i=0; i<words_.size(); i++) {
+      const unsigned long add = (i < other.words_.size())
+        ? other.words_[i]
+        : 0UL;
+      if (!carry && i >= other.words_.size())
+        break;
+      const unsigned long sum = words_[i] + add;
+      const unsigned long c1 = sum < add;
+      words_[i] = sum + carry;
+      carry = c1 | (words_[i] < carry);
+    }
+    if (carry)
+      words_.push_back(1UL);
+    return *this;
+  }
+  BigNumber& BigNumber::operator+= (unsigned long value) {
+    for(unsigned i=0; value && i<words_.size(); i++) {
+      words_[i] += value;
+      value = (words_[i] < value);
+    }
+    if (value)
+      words_.push_back(value);
+    return *this;
+  }
+  BigNumber& BigNumber::operator-= (const BigNumber &other) {
+    assert(*this >= other);
+    unsigned long borrow = 0UL;
+    for(unsigned i=0; i<words_.size(); i++) {
+      const unsigned long sub = (i < other.words_.size())
+        ? other.words_[i]
+        : 0UL;
+      if (!sub && !borrow && i >= other.words_.size())
+        break;
+      const unsigned long word = words_[i];
+      const unsigned long diff = word - sub;
+      const unsigned long b1 = word < sub;
+      words_[i] = diff - borrow;
+      borrow = b1 | (diff < borrow);
+    }
+    this->normalize();
+    return *this;
+  }
+  BigNumber& BigNumber::operator*= (const BigNumber &other) {
+    if (words_.empty() || other.words_.empty()) {
+      words_.clear();
+      return *this;
+    }
+
+    // Schoolbook multiplication of half-words
+    const unsigned n = 2*words_.size();
+    const unsigned m = 2*other.words_.size();
+    std::vector<unsigned long> result(n + m, 0UL);
+    for(unsigned i=0; i<n; i++) {
+      const unsigned long a = (words_[i/2] >> (i%2 * HALF_BITS)) & HALF_MASK;
+      if (!a)
+        continue;
+      unsigned long carry = 0UL;
+      for(unsigned j=0; j<m; j++) {
+        const unsigned long b = (other.words_[j/2] >> (j%2 * HALF_BITS)) & HALF_MASK;
+        const unsigned long t = result[i+j] + a*b + carry;
+        result[i+j] = t & HALF_MASK;
+        carry = t >> HALF_BITS;
+      }
+      result[i+m] = carry;
+    }
+    words_.assign((n + m)/2, 0UL);
+    for(unsigned i=0; i<n+m; i++)
+      words_[i/2] |= result[i] << (i%2 * HALF_BITS);
+    this->normalize();
+    return *this;
+  }
+  BigNumber& BigNumber::operator<<= (int count) {
+    if (words_.empty() || !count)
+      return *this;
+    const int full = count / WORD_BITS;
+    const int rest = count % WORD_BITS;
+    words_.resize(words_.size() + full + 1, 0UL);
+    for(int i=words_.size()-1; 0<=i; i--) {
+      unsigned long word = 0UL;
+      if (i-full >= 0)
+        word = words_[i-full] << rest;
+      if (rest && i-full-1 >= 0)
+        word |= words_[i-full-1] >> (WORD_BITS-rest);
+      words_[i] = word;
+    }
+    this->normalize();
+    return *this;
+  }
+  BigNumber& BigNumber::operator>>= (int count) {
+    const unsigned full = count / WORD_BITS;
+    const int rest = count % WORD_BITS;
+    if (full >= words_.size()) {
+      words_.clear();
+      return *this;
+    }
+    const unsigned size = words_.size() - full;
+    for(unsigned i=0; i<size; i++) {
+      unsigned long word = words_[i+full] >> rest;
+      if (rest && i+full+1 < words_.size())
+        word |= words_[i+full+1] << (WORD_BITS-rest);
+      words_[i] = word;
+    }
+    words_.resize(size);
+    this->normalize();
+    return *this;
+  }
+  int BigNumber::compare(const BigNumber &other) const {
+    if (words_.size() != other.words_.size())
+      return (words_.size() < other.words_.size()) ? -1 : 1;
+    for(int i=words_.size()-1; 0<=i; i--)
+      if (words_[i] != other.words_[i])
+        return (words_[i] < other.words_[i]) ? -1 : 1;
+    return 0;
+  }
+  void BigNumber::normalize() {
+    while (!words_.empty() && !words_.back())
+      words_.pop_back();
+  }
+
+} // namespace FastSatSolver
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef BIGNUMBER_H
+#define BIGNUMBER_H
+
+/**
+ * @file BigNumber.h
+ * @brief Unsigned integer of arbitrary width
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-17
+ * @ingroup SatSolver
+ */
+
+#include <string>
+#include <vector>
+
+namespace FastSatSolver {
+
+  /**
+   * Number is stored as sequence of machine words (the least significant
+   * word first). It is used to index spaces of assignments with more
+   * variables than bits in long. Operators taking reference modify the
+   * number in place without allocation (as long as it does not grow), so
+   * they are preferred in time-critical parts of code.
+   * @brief Unsigned integer of arbitrary width.
+   * @ingroup SatSolver
+   */
+  class BigNumber {
+    public:
+      /**
+       * @param value Initial value.
+       */
+      BigNumber(unsigned long value = 0UL);
+
+      /**
+       * @brief @return Returns 2^exponent.
+       * @param exponent Non-negative exponent.
+       */
+      static BigNumber power2(int exponent);
+
+      /**
+       * @brief @return Returns true if number is zero.
+       */
+      bool isZero() const;
+
+      /**
+       * @brief @return Returns value of desired bit.
+       * @param index Index of bit, the least significant one is 0.
+       */
+      bool getBit(int index) const;
+
+      /**
+       * @brief Set desired bit to 1.
+       * @param index Index of bit, the least significant one is 0.
+       */
+      void setBit(int index);
+
+      /**
+       * @brief @return Returns index of the least significant bit set, -1
+       * if number is zero.
+       */
+      int getLowestBit() const;
+
+      /**
+       * @brief @return Returns the least significant machine word.
+       */
+      unsigned long getLowWord() const;
+
+      /**
+       * @brief @return Returns (approximate) value as double.
+       */
+      double toDouble() const;
+
+      /**
+       * @brief @return Returns decimal representation of number.
+       */
+      std::string toString() const;
+
+      /**
+       * @brief Set number to value given by its decimal representation.
+       * @param text Decimal representation as returned by toString().
+       * @return Returns false (and keeps number unchanged) if text is not
+       * a decimal number.
+       */
+      bool fromString(const std::string &text);
+
+      /**
+       * @brief Set the least significant bits to zero.
+       * @param count Count of bits to clear.
+       */
+      void clearLowBits(int count);
+
+      /**
+       * @brief Add 2^exponent to number.
+       * @param exponent Non-negative exponent.
+       */
+      void addPower2(int exponent);
+
+      /**
+       * @brief Divide number by small divisor.
+       * @param divisor Non-zero divisor.
+       * @return Returns remainder.
+       */
+      unsigned long divide(unsigned long divisor);
+
+      BigNumber& operator+= (const BigNumber &);
+      BigNumber& operator+= (unsigned long);
+
+      /**
+       * @attention Result has to be non-negative.
+       */
+      BigNumber& operator-= (const BigNumber &);
+      BigNumber& operator*= (const BigNumber &);
+      BigNumber& operator<<= (int);
+      BigNumber& operator>>= (int);
+
+      /**
+       * @brief @return Returns negative number, zero or positive number if
+       * this number is less than, equal to or greater than other one.
+       */
+      int compare(const BigNumber &) const;
+
+    private:
+      std::vector<unsigned long> words_;  ///< without leading zero words
+
+      void normalize();
+  };
+
+  inline BigNumber operator+ (BigNumber a, const BigNumber &b) { return a += b; }
+  inline BigNumber operator- (BigNumber a, const BigNumber &b) { return a -= b; }
+  inline BigNumber operator* (BigNumber a, const BigNumber &b) { return a *= b; }
+  inline BigNumber operator<< (BigNumber a, int n) { return a <<= n; }
+  inline BigNumber operator>> (BigNumber a, int n) { return a >>= n; }
+  inline bool operator== (const BigNumber &a, const BigNumber &b) { return 0 == a.compare(b); }
+  inline bool operator!= (const BigNumber &a, const BigNumber &b) { return 0 != a.compare(b); }
+  inline bool operator<  (const BigNumber &a, const BigNumber &b) { return a.compare(b) <  0; }
+  inline bool operator<= (const BigNumber &a, const BigNumber &b) { return a.compare(b) <= 0; }
+  inline bool operator>  (const BigNumber &a, const BigNumber &b) { return a.compare(b) >  0; }
+  inline bool operator>= (const BigNumber &a, const BigNumber &b) { return a.compare(b) >= 0; }
+
+} // namespace FastSatSolver
+
+#endif // BIGNUMBER_H
@@ -20,62 +20,839 @@
 #include <assert.h>
 #include <limits.h>
 #include <math.h>
+#include <pthread.h>
+#include <algorithm>
+#include <vector>
 #include "fssIO.h"
 #include "SatProblem.h"
+#include "LaneKernel.h"
+#include "FormulaCode.h"
+#include "FormulaIndex.h"
+#include "Checkpoint.h"
 #include "BlindSatSolver.h"
 
 namespace FastSatSolver {
 
+  namespace {
+    const char CHECKPOINT_KIND = 'B';
+
+    // Gray code order applies to blocks of 2^GRAY_BLOCK_BITS assignments
+    // (the widest kernel), assignments inside of block are in natural order
+    const int GRAY_BLOCK_BITS = 9;
+    const int GRAY_BLOCK_WORDS = (1 << GRAY_BLOCK_BITS) / LANE_BITS;
+  }
+
   // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-  // LongSatItem implementation
-  LongSatItem::LongSatItem(int length, long fromNumber):
+  // PackedSatItem implementation
+  PackedSatItem::PackedSatItem(int length, const BigNumber &fromNumber):
     length_(length),
-    lNumber_(fromNumber)
+    number_(fromNumber)
   {
   }
-  LongSatItem::~LongSatItem() {
+  PackedSatItem::~PackedSatItem() {
   }
-  int LongSatItem::getLength() const {
+  int PackedSatItem::getLength() const {
     return length_;
   }
-  bool LongSatItem::getBit(int index) const {
+  bool PackedSatItem::getBit(int index) const {
     assert(index < length_);
-    return (1L<<index) & lNumber_;
+    return number_.getBit(index);
   }
-  LongSatItem* LongSatItem::clone() const {
-    return new LongSatItem(length_, lNumber_);
+  PackedSatItem* PackedSatItem::clone() const {
+    return new PackedSatItem(length_, number_);
   }
 
   // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   // BlindSatSolver implementation
   struct BlindSatSolver::Private {
+    struct Worker;
+    typedef std::pair<BigNumber, BigNumber> TRange;
+
     SatProblem        *problem;
     int               stepWidth;
-    long              end;
-    long              current;
+    BigNumber         begin;        ///< range of assignments to explore
+    BigNumber         end;
+    BigNumber         current;      ///< count of explored (or pruned) assignments
     float             minFitness;
     float             maxFitness;
     double            sumFitness;
     SatItemVector     resultSet;
+    int               minSats;
+    int               maxSats;
+
+    // Gray code and branch-and-bound enumeration (null index if not used)
+    Mode                      mode;
+    FormulaIndex              *index;
+    std::vector<int>          order;        ///< variables in order of assignment
+
+    // Gray code enumeration, code of formulas containing each variable
+    // (one more item for all formulas) and code counting formulas whose
+    // lane masks are given as variables
+    std::vector<FormulaCode>        grayCode;
+    std::vector<std::vector<int> >  grayForms;
+    FormulaCode                     countCode;
+
+    // Pool of workers, each of them explores its own range of assignments
+    // (in order given by mode) and steals ranges of others if it runs out
+    // of work
+    std::vector<Worker *>     workers;
+    int                       chunkBits;    ///< ranges are aligned to 2^chunkBits
+    std::vector<TRange>       pending;      ///< ranges restored from checkpoint
+    pthread_mutex_t           mutex;        ///< guards ranges of all workers
+    pthread_cond_t            startCond;
+    pthread_cond_t            doneCond;
+    int                       generation;   ///< count of steps started
+    int                       active;       ///< workers not done with step yet
+    bool                      quit;
+
+    Private(SatProblem *problem_, int stepWidth_, Mode mode_);
+    ~Private();
+    void init();
+    void initOrder();
+    void initGray();
+    void startThreads();
+    void stopThreads();
+    static void* threadMain(void *);
+
+    // Take next chunk of worker's range or steal a range, return false if
+    // there is no work left
+    bool claim(Worker *, BigNumber &from, BigNumber &to);
+
+    // Extend chunk being explored by worker up to want (if it is still in
+    // worker's range), return new end of chunk
+    BigNumber extend(Worker *, const BigNumber &to, const BigNumber &want);
+  };
 
-    void init() {
-      current = 0L;
-      minFitness = INFINITY;
-      maxFitness = 0.0;
-      sumFitness = 0.0;
+  /**
+   * Worker keeps its own state of evaluation, statistics and solutions
+   * found. Statistics and solutions are merged by doStep() once all
+   * workers are done with the step, so observers never see partial
+   * results. Positions of assignments are multiword numbers, but
+   * offsets inside of one chunk fit to long.
+   */
+  struct BlindSatSolver::Private::Worker {
+    Private                   *d;
+    pthread_t                 thread;
+    BigNumber                 next;         ///< range of assignments to explore
+    BigNumber                 last;
+
+    // Results of current step
+    BigNumber                 explored;
+    double                    sumSats;
+    int                       minSats;
+    int                       maxSats;
+    std::vector<ISatItem *>   solutions;    ///< owned until merged
+
+    // Bit-parallel evaluation
+    int                       width;
+    std::vector<TLaneMask>    laneVars;
+    std::vector<LaneCounter>  counters;
+
+    // Gray code enumeration, block is split to sub-blocks of kernel's width
+    std::vector<TLaneMask>    grayVars;     ///< lane masks of variables of each sub-block
+    std::vector<TLaneMask>    grayMasks;    ///< lane masks of formulas of each sub-block
+
+    // Gray code and branch-and-bound enumeration
+    std::vector<char>         assigns;
+    std::vector<char>         values;       ///< cached value of each formula
+    std::vector<char>         stack;
+    int                       satsCount;    ///< satisfied formulas (running tally)
+    BigNumber                 pos;          ///< position following the loaded one
+    bool                      loaded;
+
+    // Branch-and-bound enumeration
+    std::vector<int>          trail;        ///< formulas decided by assignments
+    std::vector<int>          trailLim;     ///< trail size before each level
+    int                       level;        ///< count of assigned variables
+    bool                      conflict;     ///< some formula is false
+    bool                      rootConflict; ///< some formula is always false
+    BigNumber                 subtreeEnd;   ///< scratch numbers (no allocation per leaf)
+    BigNumber                 count;
+    BigNumber                 number;
+
+    Worker(Private *d_);
+    ~Worker();
+    void init(const BigNumber &from, const BigNumber &to);
+    void doStep();
+
+    // Results of one assignment (or more assignments with the same count
+    // of satisfied formulas)
+    void addSats(int sats, double count) {
+      sumSats += sats*count;
+      if (sats < minSats)
+        minSats = sats;
+      if (sats > maxSats)
+        maxSats = sats;
     }
+
+    // Solution given by assignment of all variables
+    void addSolution();
+
+    // Bit-parallel evaluation
+    void setLaneVars(const BigNumber &base, long offset);
+    TLaneMask addLanes(const LaneCounter &, TLaneMask lanes);
+    void processLanes(const LaneCounter &, const BigNumber &base, long offset, TLaneMask lanes);
+    void exploreLanes(const BigNumber &from, long count);
+
+    // Gray code enumeration
+    void resizeGray();
+    void setGrayVar(int var);
+    void evalGray(int var);
+    void loadGray(const BigNumber &base);
+    void flip(int var);
+    void processGray(long block, long count);
+    void exploreGray(const BigNumber &from, long count);
+
+    // Branch-and-bound enumeration
+    void loadRoot();
+    void assign(char value);
+    void undo();
+    bool backtrack();
+    void seek(const BigNumber &p);
+    void exploreBranchAndBound(const BigNumber &from, BigNumber to);
   };
-  BlindSatSolver::BlindSatSolver(SatProblem *problem, int stepWidth):
-    d(new Private)
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // BlindSatSolver::Private implementation
+  BlindSatSolver::Private::Private(SatProblem *problem_, int stepWidth_, Mode mode_):
+    problem(problem_),
+    stepWidth(std::min<int>(stepWidth_, sizeof(long)*CHAR_BIT - 2)),
+    end(BigNumber::power2(problem_->getVarsCount())),
+    mode(mode_),
+    index(0),
+    chunkBits(std::min(stepWidth, problem_->getVarsCount())),
+    generation(0),
+    active(0),
+    quit(false)
+  {
+    if (MODE_LANES == mode) {
+      // Do not split blocks evaluated at once
+      int blockBits = 0;
+      while ((1L<<blockBits) < problem->getLaneKernel()->getWidth() * LANE_BITS)
+        blockBits++;
+      chunkBits = std::max(chunkBits, blockBits);
+    } else {
+      index = new FormulaIndex(problem);
+    }
+    if (MODE_GRAY_CODE == mode) {
+      // Do not split blocks in Gray code order
+      chunkBits = std::max(chunkBits, std::min(GRAY_BLOCK_BITS, problem->getVarsCount()));
+      this->initGray();
+    }
+    if (MODE_BRANCH_AND_BOUND == mode)
+      this->initOrder();
+    pthread_mutex_init(&mutex, 0);
+    pthread_cond_init(&startCond, 0);
+    pthread_cond_init(&doneCond, 0);
+  }
+  BlindSatSolver::Private::~Private() {
+    this->stopThreads();
+    for(unsigned i=0; i<workers.size(); i++)
+      delete workers[i];
+    pthread_cond_destroy(&doneCond);
+    pthread_cond_destroy(&startCond);
+    pthread_mutex_destroy(&mutex);
+    delete index;
+  }
+  void BlindSatSolver::Private::init() {
+    current = BigNumber();
+    minFitness = INFINITY;
+    maxFitness = 0.0;
+    sumFitness = 0.0;
+    minSats = INT_MAX;
+    maxSats = 0;
+
+    // Split range of assignments to equal ranges (aligned to chunks)
+    pending.clear();
+    const unsigned count = workers.size();
+    BigNumber chunks = end - begin;
+    chunks += (1UL << chunkBits) - 1UL;
+    chunks >>= chunkBits;
+    const unsigned long rest = chunks.divide(count);
+    BigNumber from = begin;
+    for(unsigned i=0; i<count; i++) {
+      BigNumber size = chunks;
+      if (i < rest)
+        size += 1UL;
+      size <<= chunkBits;
+      size += from;
+      const BigNumber to = std::min(end, size);
+      workers[i]->init(from, to);
+      from = to;
+    }
+  }
+  // Order variables for branch-and-bound, variables of short formulas
+  // first (so that they are decided early), then the most frequent ones
+  void BlindSatSolver::Private::initOrder() {
+    const int varsCount = index->getVarsCount();
+    std::vector<std::pair<std::pair<int, int>, int> > keys;
+    for(int i=0; i<varsCount; i++) {
+      const std::vector<int> &occs = index->getVarOccurrences(i);
+      int minLength = INT_MAX;
+      for(unsigned o=0; o<occs.size(); o++) {
+        const int f = index->getOccFormula(occs[o]);
+        const int length = index->getOccEnd(f) - index->getOccBegin(f);
+        if (length < minLength)
+          minLength = length;
+      }
+      const int occsCount = occs.size();
+      keys.push_back(std::make_pair(std::make_pair(minLength, -occsCount), i));
+    }
+    std::sort(keys.begin(), keys.end());
+    order.resize(varsCount);
+    for(int i=0; i<varsCount; i++)
+      order[i] = keys[i].second;
+  }
+  // Split code of formulas by variables, so that only formulas containing
+  // variable are reevaluated when it is flipped
+  void BlindSatSolver::Private::initGray() {
+    const int varsCount = index->getVarsCount();
+    const int formulasCount = index->getFormulasCount();
+    grayCode.resize(varsCount + 1);
+    grayForms.resize(varsCount + 1);
+    for(int i=0; i<varsCount; i++) {
+      const std::vector<int> &occs = index->getVarOccurrences(i);
+      for(unsigned o=0; o<occs.size(); o++) {
+        const int f = index->getOccFormula(occs[o]);
+        index->writeCode(f, grayCode[i]);
+        grayForms[i].push_back(f);
+      }
+    }
+    for(int f=0; f<formulasCount; f++) {
+      index->writeCode(f, grayCode[varsCount]);
+      grayForms[varsCount].push_back(f);
+      countCode.append(OP_VAR, f);
+      countCode.append(OP_COUNT);
+    }
+  }
+  void BlindSatSolver::Private::startThreads() {
+    // The first worker is run by thread calling doStep()
+    for(unsigned i=1; i<workers.size(); i++) {
+      if (0!= pthread_create(&workers[i]->thread, 0, threadMain, workers[i])) {
+        // Run with workers created so far
+        for(unsigned j=i; j<workers.size(); j++)
+          delete workers[j];
+        workers.resize(i);
+        break;
+      }
+    }
+  }
+  void BlindSatSolver::Private::stopThreads() {
+    pthread_mutex_lock(&mutex);
+    quit = true;
+    pthread_cond_broadcast(&startCond);
+    pthread_mutex_unlock(&mutex);
+    for(unsigned i=1; i<workers.size(); i++)
+      pthread_join(workers[i]->thread, 0);
+  }
+  void* BlindSatSolver::Private::threadMain(void *arg) {
+    Worker *worker = static_cast<Worker *>(arg);
+    Private *d = worker->d;
+    int generation = 0;
+    pthread_mutex_lock(&d->mutex);
+    for(;;) {
+      while (!d->quit && generation == d->generation)
+        pthread_cond_wait(&d->startCond, &d->mutex);
+      if (d->quit)
+        break;
+      generation = d->generation;
+      pthread_mutex_unlock(&d->mutex);
+
+      worker->doStep();
+
+      pthread_mutex_lock(&d->mutex);
+      if (0 == --d->active)
+        pthread_cond_signal(&d->doneCond);
+    }
+    pthread_mutex_unlock(&d->mutex);
+    return 0;
+  }
+  bool BlindSatSolver::Private::claim(Worker *worker, BigNumber &from, BigNumber &to) {
+    pthread_mutex_lock(&mutex);
+    if (worker->next >= worker->last && !pending.empty()) {
+      // Take range restored from checkpoint
+      worker->next = pending.back().first;
+      worker->last = pending.back().second;
+      pending.pop_back();
+    } else if (worker->next >= worker->last) {
+      // Steal the second half of the largest range
+      const BigNumber minSize = BigNumber::power2(chunkBits + 1);
+      Worker *victim = 0;
+      BigNumber victimSize;
+      for(unsigned i=0; i<workers.size(); i++) {
+        Worker *w = workers[i];
+        if (w->next >= w->last)
+          continue;
+        const BigNumber size = w->last - w->next;
+        if (size >= minSize && (!victim || size > victimSize)) {
+          victim = w;
+          victimSize = size;
+        }
+      }
+      if (victim) {
+        BigNumber half = victimSize >> 1;
+        half.clearLowBits(chunkBits);
+        worker->next = victim->last - half;
+        worker->last = victim->last;
+        victim->last = worker->next;
+      } else {
+        // Take the whole range if it is too small to split
+        for(unsigned i=0; i<workers.size(); i++) {
+          Worker *w = workers[i];
+          if (w->next < w->last) {
+            worker->next = w->next;
+            worker->last = w->last;
+            w->next = w->last;
+            break;
+          }
+        }
+      }
+    }
+    const bool found = worker->next < worker->last;
+    if (found) {
+      from = worker->next;
+      to = from;
+      to.addPower2(chunkBits);
+      if (to > worker->last)
+        to = worker->last;
+      worker->next = to;
+    }
+    pthread_mutex_unlock(&mutex);
+    return found;
+  }
+  BigNumber BlindSatSolver::Private::extend(Worker *worker, const BigNumber &to, const BigNumber &want) {
+    BigNumber result = to;
+    pthread_mutex_lock(&mutex);
+    if (worker->next == to) {
+      result = std::min(want, worker->last);
+      worker->next = result;
+    }
+    pthread_mutex_unlock(&mutex);
+    return result;
+  }
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // BlindSatSolver::Private::Worker implementation
+  BlindSatSolver::Private::Worker::Worker(Private *d_):
+    d(d_),
+    loaded(false)
   {
-    const unsigned varsCount= problem->getVarsCount();
-    if (varsCount+2 >= LONG_BIT) {
-      delete d;
-      throw GenericException("Too much variables - can't use blind solver on this machine!");
-    }
-    d->problem = problem;
-    d->stepWidth = stepWidth;
-    d->end = 1L<<varsCount;
+    width = d->problem->getLaneKernel()->getWidth();
+    laneVars.resize(d->problem->getVarsCount() * width);
+    counters.resize(width);
+    if (MODE_GRAY_CODE == d->mode)
+      this->resizeGray();
+    if (d->index) {
+      assigns.resize(d->problem->getVarsCount());
+      values.resize(d->index->getFormulasCount());
+      stack.resize(d->index->getStackSize());
+      trailLim.resize(d->problem->getVarsCount());
+    }
+    if (MODE_BRANCH_AND_BOUND == d->mode)
+      this->loadRoot();
+  }
+  BlindSatSolver::Private::Worker::~Worker() {
+    for(unsigned i=0; i<solutions.size(); i++)
+      delete solutions[i];
+  }
+  void BlindSatSolver::Private::Worker::init(const BigNumber &from, const BigNumber &to) {
+    next = from;
+    last = to;
+
+    // Set block width according to kernel used by problem
+    width = d->problem->getLaneKernel()->getWidth();
+    laneVars.resize(d->problem->getVarsCount() * width);
+    counters.resize(width);
+    if (MODE_GRAY_CODE == d->mode)
+      this->resizeGray();
+  }
+  void BlindSatSolver::Private::Worker::doStep() {
+    explored = BigNumber();
+    sumSats = 0.0;
+    minSats = INT_MAX;
+    maxSats = 0;
+
+    // Explore at least 2^stepWidth assignments (or all remaining)
+    const BigNumber countPerStep = BigNumber::power2(d->stepWidth);
+    BigNumber from, to;
+    while (explored < countPerStep && d->claim(this, from, to)) {
+      switch (d->mode) {
+        case MODE_LANES:
+          this->exploreLanes(from, (to - from).getLowWord());
+          break;
+        case MODE_GRAY_CODE:
+          this->exploreGray(from, (to - from).getLowWord());
+          break;
+        case MODE_BRANCH_AND_BOUND:
+          this->exploreBranchAndBound(from, to);
+          break;
+      }
+    }
+  }
+
+  void BlindSatSolver::Private::Worker::addSolution() {
+    number = BigNumber();
+    for(unsigned v=0; v<assigns.size(); v++)
+      if (1 == assigns[v])
+        number.setBit(v);
+    solutions.push_back(new PackedSatItem(assigns.size(), number));
+  }
+
+  // Set lane masks of all variables for block of width*LANE_BITS
+  // assignments starting at base+offset (base is aligned to chunk, offset
+  // to block size)
+  void BlindSatSolver::Private::Worker::setLaneVars(const BigNumber &base, long offset) {
+    const int nVars = d->problem->getVarsCount();
+    for(int i=0; i<nVars; i++) {
+      TLaneMask *vars = &(laneVars[i*width]);
+      if ((1L<<i) < LANE_BITS) {
+        // Variable changes inside of word
+        TLaneMask mask = 0UL;
+        for(int j=0; j<LANE_BITS; j++)
+          if ((j>>i) & 1)
+            mask |= 1UL<<j;
+        for(int w=0; w<width; w++)
+          vars[w] = mask;
+      } else if (i < d->chunkBits) {
+        // Variable is constant inside of word
+        for(int w=0; w<width; w++) {
+          const long wordOffset = offset + w*LANE_BITS;
+          vars[w] = ((wordOffset>>i) & 1L) ? ~0UL : 0UL;
+        }
+      } else {
+        // Variable is constant inside of chunk
+        const TLaneMask mask = (base.getBit(i)) ? ~0UL : 0UL;
+        for(int w=0; w<width; w++)
+          vars[w] = mask;
+      }
+    }
+  }
+  void BlindSatSolver::Private::Worker::exploreLanes(const BigNumber &from, long count) {
+    const long blockSize = width * LANE_BITS;
+    for(long block=0; block<count; block+=blockSize) {
+      // Evaluate all formulas for whole block at once
+      this->setLaneVars(from, block);
+      d->problem->getSatsCountLanes(&(laneVars[0]), &(counters[0]));
+
+      for(int w=0; w<width; w++) {
+        // Select lanes of current word to explore
+        const long wordOffset = block + w*LANE_BITS;
+        if (count <= wordOffset)
+          break;
+        TLaneMask lanes = ~0UL;
+        if (count - wordOffset < LANE_BITS)
+          lanes = ~(~0UL << (count - wordOffset));
+
+        this->processLanes(counters[w], from, wordOffset, lanes);
+      }
+    }
+    explored += count;
+  }
+  // Add statistics of selected lanes, return lanes of solutions
+  TLaneMask BlindSatSolver::Private::Worker::addLanes(const LaneCounter &counter, TLaneMask lanes) {
+    sumSats += counter.sum(lanes);
+    const int min = counter.min(lanes);
+    if (min < minSats)
+      minSats = min;
+    const int max = counter.max(lanes);
+    if (max > maxSats)
+      maxSats = max;
+
+    const int nForms= d->problem->getFormulasCount();
+    return counter.equalTo(nForms) & lanes;
+  }
+  void BlindSatSolver::Private::Worker::processLanes(const LaneCounter &counter, const BigNumber &base, long offset, TLaneMask lanes) {
+    TLaneMask found = this->addLanes(counter, lanes);
+    for(int j=0; found; j++) {
+      const TLaneMask bit = 1UL<<j;
+      if (!(found & bit))
+        continue;
+      found &= ~bit;
+
+      // Solution found
+      number = base;
+      number += offset + j;
+      solutions.push_back(new PackedSatItem(d->problem->getVarsCount(), number));
+    }
+  }
+
+  // Gray code enumeration works with the whole block (GRAY_BLOCK_WORDS
+  // words per variable), which is split to sub-blocks evaluated by kernel
+  void BlindSatSolver::Private::Worker::resizeGray() {
+    const int subBlocks = GRAY_BLOCK_WORDS / width;
+    grayVars.resize(subBlocks * d->index->getVarsCount() * width);
+    grayMasks.resize(subBlocks * d->index->getFormulasCount() * width);
+    loaded = false;
+  }
+  // Set lane masks of variable in all sub-blocks
+  void BlindSatSolver::Private::Worker::setGrayVar(int var) {
+    const int nVars = d->index->getVarsCount();
+    const int subBlocks = GRAY_BLOCK_WORDS / width;
+    for(int s=0; s<subBlocks; s++) {
+      TLaneMask *vars = &grayVars[(s*nVars + var)*width];
+      for(int w=0; w<width; w++) {
+        const long wordOffset = (s*width + w) * LANE_BITS;
+        TLaneMask mask = 0UL;
+        if (GRAY_BLOCK_BITS <= var) {
+          // Variable is constant inside of block
+          if (assigns[var])
+            mask = ~0UL;
+        } else if ((1L<<var) < LANE_BITS) {
+          // Variable changes inside of word
+          for(int j=0; j<LANE_BITS; j++)
+            if ((j>>var) & 1)
+              mask |= 1UL<<j;
+        } else if ((wordOffset>>var) & 1L) {
+          // Variable is constant inside of word
+          mask = ~0UL;
+        }
+        vars[w] = mask;
+      }
+    }
+  }
+  // Reevaluate formulas containing variable (or all formulas if var is
+  // count of variables) in all sub-blocks
+  void BlindSatSolver::Private::Worker::evalGray(int var) {
+    const FormulaCode &code = d->grayCode[var];
+    if (!code.getLength())
+      return;
+    ILaneKernel *kernel = d->problem->getLaneKernel();
+    const int nVars = d->index->getVarsCount();
+    const int nForms = d->index->getFormulasCount();
+    const int subBlocks = GRAY_BLOCK_WORDS / width;
+    for(int s=0; s<subBlocks; s++) {
+      const bool ok = kernel->runMasks(
+          code.getData(),
+          code.getLength(),
+          code.getMaxDepth(),
+          &grayVars[s*nVars*width],
+          &d->grayForms[var][0],
+          &grayMasks[s*nForms*width]);
+      if (!ok)
+        throw GenericException("BlindSatSolver::exploreGray(): out of memory");
+    }
+  }
+  // Load block of assignments starting at base (aligned to block) and
+  // evaluate all formulas. Variable v above the block is bit v xor bit
+  // v+1 of block's position.
+  void BlindSatSolver::Private::Worker::loadGray(const BigNumber &base) {
+    const int nVars = assigns.size();
+    for(int v=0; v<nVars; v++) {
+      assigns[v] = (GRAY_BLOCK_BITS <= v)
+        && (base.getBit(v) ^ base.getBit(v+1));
+      this->setGrayVar(v);
+    }
+    this->evalGray(nVars);
+    loaded = true;
+  }
+  // Flip variable above the block and reevaluate only formulas containing it
+  void BlindSatSolver::Private::Worker::flip(int var) {
+    assigns[var] ^= 1;
+    this->setGrayVar(var);
+    this->evalGray(var);
+  }
+  // Count satisfied formulas of loaded block at given offset of chunk
+  void BlindSatSolver::Private::Worker::processGray(long block, long count) {
+    ILaneKernel *kernel = d->problem->getLaneKernel();
+    const int nVars = assigns.size();
+    const int nForms = d->index->getFormulasCount();
+    const int satsOffset = d->index->getSatsOffset();
+    const int subBlocks = GRAY_BLOCK_WORDS / width;
+    for(int s=0; s<subBlocks; s++) {
+      const bool ok = kernel->run(
+          d->countCode.getData(),
+          d->countCode.getLength(),
+          d->countCode.getMaxDepth(),
+          0,
+          &grayMasks[s*nForms*width],
+          &(counters[0]));
+      if (!ok)
+        throw GenericException("BlindSatSolver::exploreGray(): out of memory");
+
+      for(int w=0; w<width; w++) {
+        // Select lanes of current word to explore
+        const long wordIndex = s*width + w;
+        const long wordOffset = block + wordIndex*LANE_BITS;
+        if (count <= wordOffset)
+          return;
+        TLaneMask lanes = ~0UL;
+        if (count - wordOffset < LANE_BITS)
+          lanes = ~(~0UL << (count - wordOffset));
+
+        // Tautologies are satisfied by each assignment
+        for(int i=0; i<satsOffset; i++)
+          counters[w].add(~0UL);
+
+        TLaneMask found = this->addLanes(counters[w], lanes);
+        for(int j=0; found; j++) {
+          const TLaneMask bit = 1UL<<j;
+          if (!(found & bit))
+            continue;
+          found &= ~bit;
+
+          // Solution found, variables inside of block in natural order
+          const long inBlock = wordIndex*LANE_BITS + j;
+          number = BigNumber();
+          for(int v=0; v<nVars; v++)
+            if ((v < GRAY_BLOCK_BITS) ? ((inBlock>>v) & 1L) : assigns[v])
+              number.setBit(v);
+          solutions.push_back(new PackedSatItem(nVars, number));
+        }
+      }
+    }
+  }
+  void BlindSatSolver::Private::Worker::exploreGray(const BigNumber &from, long count) {
+    const long blockSize = 1L << GRAY_BLOCK_BITS;
+    for(long block=0; block<count; block+=blockSize) {
+      // Gray codes of blocks k-1 and k differ in the lowest set bit of k
+      if (block) {
+        int var = GRAY_BLOCK_BITS;
+        while (!((block>>var) & 1L))
+          var++;
+        this->flip(var);
+      } else if (loaded && pos == from) {
+        this->flip(from.getLowestBit());
+      } else {
+        this->loadGray(from);
+      }
+      this->processGray(block, count);
+    }
+    pos = from;
+    pos += count;
+    explored += count;
+  }
+
+  // Start with no variable assigned, some formulas can be decided yet
+  void BlindSatSolver::Private::Worker::loadRoot() {
+    std::fill(assigns.begin(), assigns.end(), FormulaIndex::UNKNOWN);
+    trail.clear();
+    level = 0;
+    rootConflict = false;
+    satsCount = d->index->getSatsOffset();
+    for(unsigned f=0; f<values.size(); f++) {
+      values[f] = d->index->evalPartial(f, &assigns[0], &stack[0]);
+      if (0 == values[f])
+        rootConflict = true;
+      else if (1 == values[f])
+        satsCount++;
+    }
+    conflict = rootConflict;
+    pos = BigNumber();
+  }
+  // Assign value to next variable in order and decide formulas
+  // containing it (if possible)
+  void BlindSatSolver::Private::Worker::assign(char value) {
+    const int var = d->order[level];
+    trailLim[level++] = trail.size();
+    assigns[var] = value;
+    const std::vector<int> &occs = d->index->getVarOccurrences(var);
+    for(unsigned i=0; i<occs.size(); i++) {
+      const int f = d->index->getOccFormula(occs[i]);
+      if (FormulaIndex::UNKNOWN != values[f])
+        continue;
+      const char result = d->index->evalPartial(f, &assigns[0], &stack[0]);
+      if (FormulaIndex::UNKNOWN == result)
+        continue;
+      values[f] = result;
+      trail.push_back(f);
+      if (result)
+        satsCount++;
+      else
+        conflict = true;
+    }
+  }
+  // Undo assignment of the last assigned variable
+  void BlindSatSolver::Private::Worker::undo() {
+    assigns[d->order[--level]] = FormulaIndex::UNKNOWN;
+    const int lim = trailLim[level];
+    while (static_cast<int>(trail.size()) > lim) {
+      const int f = trail.back();
+      trail.pop_back();
+      satsCount -= values[f];
+      values[f] = FormulaIndex::UNKNOWN;
+    }
+    conflict = rootConflict;
+  }
+  // Undo assignments up to the last variable set to 0 and set it to 1,
+  // return false if there is no such variable (search is complete)
+  bool BlindSatSolver::Private::Worker::backtrack() {
+    while (level) {
+      const char value = assigns[d->order[level-1]];
+      this->undo();
+      if (0 == value) {
+        this->assign(1);
+        return true;
+      }
+    }
+    return false;
+  }
+  // Go to subtree containing p-th assignment (in order of variables)
+  void BlindSatSolver::Private::Worker::seek(const BigNumber &p) {
+    while (level)
+      this->undo();
+    const int nVars = d->problem->getVarsCount();
+    const int lowest = p.getLowestBit();
+    while (!conflict && level < nVars && 0 <= lowest && lowest < nVars - level) {
+      const int shift = nVars - level - 1;
+      this->assign(p.getBit(shift));
+    }
+    pos = p;
+  }
+  void BlindSatSolver::Private::Worker::exploreBranchAndBound(const BigNumber &from, BigNumber to) {
+    if (pos != from)
+      this->seek(from);
+
+    const int nVars= d->problem->getVarsCount();
+    const int nForms= d->problem->getFormulasCount();
+    long leaves = 0L;
+    while (pos < to) {
+      // Go deeper
+      while (!conflict && level < nVars)
+        this->assign(0);
+
+      if (level == nVars) {
+        // Leaf
+        this->addSats(satsCount, 1.0);
+        leaves++;
+        pos += 1UL;
+        if (!conflict && satsCount == nForms)
+          // Solution found
+          this->addSolution();
+        if (!this->backtrack())
+          // all space explored
+          break;
+        continue;
+      }
+
+      // Pruned subtree (can exceed the range explored)
+      const int height = nVars - level;
+      subtreeEnd = pos;
+      subtreeEnd.clearLowBits(height);
+      subtreeEnd.addPower2(height);
+      if (subtreeEnd > to)
+        to = d->extend(this, to, subtreeEnd);
+      count = std::min(subtreeEnd, to);
+      count -= pos;
+      this->addSats(satsCount, count.toDouble());
+      explored += count;
+      pos += count;
+
+      if (pos == subtreeEnd && !this->backtrack())
+        // all space explored
+        break;
+    }
+    explored += leaves;
+  }
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // BlindSatSolver implementation
+  BlindSatSolver::BlindSatSolver(SatProblem *problem, int stepWidth, Mode mode, int threadsCount):
+    d(0)
+  {
+    d = new Private(problem, stepWidth, mode);
+    for(int i=0; i<std::max(1, threadsCount); i++)
+      d->workers.push_back(new Private::Worker(d));
+    d->startThreads();
     d->init();
   }
   BlindSatSolver::~BlindSatSolver() {
@@ -94,11 +871,131 @@ namespace FastSatSolver {
     return d->minFitness;
   }
   float BlindSatSolver::avgFitness() {
-    return d->sumFitness / d->current;
+    return d->sumFitness / d->current.toDouble();
   }
   float BlindSatSolver::maxFitness() {
     return d->maxFitness;
   }
+  double BlindSatSolver::getProgress() {
+    const BigNumber size = d->end - d->begin;
+    return (size.isZero())
+      ? 1.0
+      : d->current.toDouble() / size.toDouble();
+  }
+  bool BlindSatSolver::isExhausted() {
+    return d->current >= d->end - d->begin;
+  }
+  int BlindSatSolver::getThreadsCount() {
+    return d->workers.size();
+  }
+  int BlindSatSolver::getChunkBits() {
+    return d->chunkBits;
+  }
+  BlindSatSolver::Mode BlindSatSolver::getMode() {
+    return d->mode;
+  }
+  void BlindSatSolver::setRange(const BigNumber &from, const BigNumber &to) {
+    const BigNumber space = BigNumber::power2(d->problem->getVarsCount());
+    BigNumber alignedFrom = from;
+    alignedFrom.clearLowBits(d->chunkBits);
+    BigNumber alignedTo = to;
+    alignedTo.clearLowBits(d->chunkBits);
+    if (to > space || from > to)
+      throw GenericException("Range of assignments out of space");
+    if (alignedFrom != from || (alignedTo != to && to != space))
+      throw GenericException("Range of assignments not aligned to chunks of "
+          + BigNumber::power2(d->chunkBits).toString() + " assignments");
+    d->begin = from;
+    d->end = to;
+  }
+  void BlindSatSolver::saveCheckpoint(const std::string &fileName) {
+    CheckpointWriter writer(CHECKPOINT_KIND);
+    writer.writeUnsigned(d->problem->getVarsCount());
+    writer.writeUnsigned(d->mode);
+    writer.writeNumber(d->begin);
+    writer.writeNumber(d->end);
+    writer.writeNumber(d->current);
+    writer.writeUnsigned(d->minSats);
+    writer.writeUnsigned(d->maxSats);
+    writer.writeDouble(d->sumFitness);
+
+    // Ranges not explored yet
+    std::vector<Private::TRange> ranges(d->pending);
+    for(unsigned i=0; i<d->workers.size(); i++) {
+      Private::Worker *worker = d->workers[i];
+      if (worker->next < worker->last)
+        ranges.push_back(Private::TRange(worker->next, worker->last));
+    }
+    writer.writeUnsigned(ranges.size());
+    for(unsigned i=0; i<ranges.size(); i++) {
+      writer.writeNumber(ranges[i].first);
+      writer.writeNumber(ranges[i].second);
+    }
+
+    writer.writeUnsigned(d->resultSet.getLength());
+    for(int i=0; i<d->resultSet.getLength(); i++)
+      writer.writeItem(*d->resultSet.getItem(i));
+    writer.commit(fileName);
+  }
+  void BlindSatSolver::loadCheckpoint(const std::string &fileName) {
+    CheckpointReader reader(fileName, CHECKPOINT_KIND);
+    const int nVars = d->problem->getVarsCount();
+    if (static_cast<unsigned long>(nVars) != reader.readUnsigned())
+      throw GenericException("Checkpoint of another SAT problem: " + fileName);
+    if (static_cast<unsigned long>(d->mode) != reader.readUnsigned())
+      throw GenericException("Checkpoint of blind solver in another mode: " + fileName);
+    const BigNumber begin = reader.readNumber();
+    const BigNumber end = reader.readNumber();
+    const BigNumber current = reader.readNumber();
+    const int minSats = reader.readUnsigned();
+    const int maxSats = reader.readUnsigned();
+    const double sumFitness = reader.readDouble();
+
+    // Only branch-and-bound can explore ranges not aligned to chunks
+    const BigNumber space = BigNumber::power2(nVars);
+    std::vector<Private::TRange> ranges(reader.readUnsigned());
+    for(unsigned i=0; i<ranges.size(); i++) {
+      const BigNumber from = reader.readNumber();
+      const BigNumber to = reader.readNumber();
+      BigNumber aligned = from;
+      aligned.clearLowBits(d->chunkBits);
+      if (to > space || from >= to)
+        throw GenericException("Invalid checkpoint file: " + fileName);
+      if (aligned != from && MODE_BRANCH_AND_BOUND != d->mode)
+        throw GenericException("Checkpoint does not match step_width: " + fileName);
+      ranges[i] = Private::TRange(from, to);
+    }
+
+    std::vector<ISatItem *> solutions(reader.readUnsigned());
+    std::vector<char> bits;
+    for(unsigned i=0; i<solutions.size(); i++) {
+      reader.readItem(bits, nVars);
+      BigNumber number;
+      for(int v=0; v<nVars; v++)
+        if (bits[v])
+          number.setBit(v);
+      solutions[i] = new PackedSatItem(nVars, number);
+    }
+
+    // Checkpoint is valid, restore the state
+    const int nForms= d->problem->getFormulasCount();
+    d->begin = begin;
+    d->end = end;
+    d->current = current;
+    d->minSats = minSats;
+    d->maxSats = maxSats;
+    d->minFitness = (INT_MAX == minSats)
+      ? INFINITY
+      : static_cast<float>(minSats)/nForms;
+    d->maxFitness = static_cast<float>(maxSats)/nForms;
+    d->sumFitness = sumFitness;
+    for(unsigned i=0; i<d->workers.size(); i++)
+      d->workers[i]->init(begin, begin);
+    d->pending.swap(ranges);
+    d->resultSet.clear();
+    for(unsigned i=0; i<solutions.size(); i++)
+      d->resultSet.addItem(solutions[i]);
+  }
   // protected
   void BlindSatSolver::initialize() {
     d->init();
@@ -106,40 +1003,60 @@ namespace FastSatSolver {
   }
   // protected
   void BlindSatSolver::doStep() {
-    const int nVars= d->problem->getVarsCount();
-    const int nForms= d->problem->getFormulasCount();
-    const int countPerStep = 1 << d->stepWidth;
-    for(int i=0; i< countPerStep; i++) {
-      if (d->current >= d->end) {
-        // all space explored
-        this->stop();
-        break;
-      }
+    std::vector<Private::Worker *> &workers = d->workers;
+    if (1 < workers.size()) {
+      // Wake up other workers
+      pthread_mutex_lock(&d->mutex);
+      d->active = workers.size() - 1;
+      d->generation++;
+      pthread_cond_broadcast(&d->startCond);
+      pthread_mutex_unlock(&d->mutex);
+    }
 
-      // Evalueate fitness
-      LongSatItem data(nVars, d->current++);
-      const int nSats= d->problem->getSatsCount(&data);
-      const float fitness= static_cast<float>(nSats)/nForms;
+    workers[0]->doStep();
 
-      // Update statistics
-      d->sumFitness += fitness;
-      if (fitness < d->minFitness)
-        d->minFitness = fitness;
+    if (1 < workers.size()) {
+      // Wait for other workers
+      pthread_mutex_lock(&d->mutex);
+      while (d->active)
+        pthread_cond_wait(&d->doneCond, &d->mutex);
+      pthread_mutex_unlock(&d->mutex);
+    }
 
-      if (fitness > d->maxFitness) {
-        // maxFitness increased
-        d->maxFitness = fitness;
-        this->notify();
+    // Merge statistics of all workers
+    const int nForms= d->problem->getFormulasCount();
+    bool maxIncreased = false;
+    for(unsigned i=0; i<workers.size(); i++) {
+      Private::Worker *worker = workers[i];
+      d->current += worker->explored;
+      d->sumFitness += worker->sumSats / nForms;
+      if (!worker->explored.isZero() && worker->minSats < d->minSats) {
+        d->minSats = worker->minSats;
+        d->minFitness = static_cast<float>(d->minSats)/nForms;
+      }
+      if (worker->maxSats > d->maxSats) {
+        d->maxSats = worker->maxSats;
+        d->maxFitness = static_cast<float>(d->maxSats)/nForms;
+        maxIncreased = true;
       }
+    }
+    if (maxIncreased)
+      this->notify();
 
-      if (nSats == nForms) {
-        // Solution found
-        d->resultSet.addItem(data.clone());
+    // Merge solutions of all workers
+    for(unsigned i=0; i<workers.size(); i++) {
+      std::vector<ISatItem *> &solutions = workers[i]->solutions;
+      for(unsigned j=0; j<solutions.size(); j++) {
+        d->resultSet.addItem(solutions[j]);
         this->notify();
       }
+      solutions.clear();
     }
+
+    if (this->isExhausted())
+      // all range explored
+      this->stop();
   }
 
 
 } // namespace FastSatSolver
-
@@ -29,6 +29,9 @@
  */
 
 #include "SatSolver.h"
+#include "SatProblem.h"
+#include "BigNumber.h"
+#include "Checkpoint.h"
 
 namespace FastSatSolver {
 
@@ -36,36 +39,74 @@ namespace FastSatSolver {
    * @brief ISatItem implementation used by BlindSatSolver
    * @ingroup SatSolver
    */
-  class LongSatItem: public ISatItem {
+  class PackedSatItem: public ISatItem {
     public:
       /**
        * @param length Item length responds the count of variables.
-       * @param fromNumber Long number representing item's data (bit by bit).
+       * @param fromNumber Number representing item's data (bit by bit),
+       * there is no limit of its width.
        */
-      LongSatItem(int length, long fromNumber);
-      virtual ~LongSatItem();
+      PackedSatItem(int length, const BigNumber &fromNumber);
+      virtual ~PackedSatItem();
       virtual int getLength() const;
       virtual bool getBit(int index) const;
-      virtual LongSatItem* clone() const;
+      virtual PackedSatItem* clone() const;
     private:
-      int  length_;
-      long lNumber_;
+      int       length_;
+      BigNumber number_;
   };
 
   /**
+   * Assignments are indexed by multiword numbers, so there is no limit of
+   * count of variables (except of time, of course).
    * @brief Solver using brute force method to solve SAT problem.
    * @ingroup SatSolver
    */
-  class BlindSatSolver: public AbstractSatSolver
+  class BlindSatSolver:
+    public AbstractSatSolver,
+    public IProgressIndicator,
+    public ICheckpointable
   {
     public:
+      /**
+       * @brief Order in which assignments are explored.
+       */
+      enum Mode {
+        /// Blocks of assignments in natural order are evaluated at once
+        /// (bit-parallel).
+        MODE_LANES,
+
+        /// Blocks of 512 assignments are enumerated in Gray code order
+        /// (natural order inside a block). Exactly one variable is changed
+        /// between two blocks, so only formulas containing it are
+        /// reevaluated (bit-parallel) and the others are kept from the
+        /// previous block. Chunks of work are aligned to whole blocks.
+        MODE_GRAY_CODE,
+
+        /// Variables are assigned one by one (depth-first). Formulas are
+        /// evaluated under Kleene's three-valued logic and whole subtree is
+        /// pruned as soon as any formula is false. Search is still
+        /// exhaustive, but statistics of pruned subtrees are only estimated
+        /// by formulas known to be satisfied.
+        MODE_BRANCH_AND_BOUND
+      };
+
       /**
        * @param problem SatProblem instance containing SAT problem to solve.
        * @param stepWidth Number of bits explored in one step. This influences
        * the granullarity of notifications and process control. Recomended
        * value for ordinary machines is 16.
+       * @param mode Order in which assignments are explored.
+       * @param threadsCount Count of threads exploring the space of
+       * assignments. Each of them explores its own range and steals ranges
+       * of others if it runs out of work. Results of threads are merged at
+       * the end of each step.
        */
-      BlindSatSolver(SatProblem *problem, int stepWidth);
+      BlindSatSolver(
+                     SatProblem         *problem,
+                     int                stepWidth,
+                     Mode               mode = MODE_LANES,
+                     int                threadsCount = 1);
       virtual ~BlindSatSolver();
       virtual SatProblem* getProblem();
       virtual int getSolutionsCount();
@@ -74,6 +115,62 @@ namespace FastSatSolver {
       virtual float avgFitness();
       virtual float maxFitness();
 
+      /**
+       * @brief @return Returns count of explored (or pruned) assignments
+       * divided by count of all assignments in range.
+       */
+      virtual double getProgress();
+
+      /**
+       * @brief @return Returns true if whole range of assignments has been
+       * explored, so there are no more solutions (in range) than solutions
+       * already found.
+       */
+      bool isExhausted();
+
+      /**
+       * @brief @return Returns count of threads exploring the space.
+       */
+      int getThreadsCount();
+
+      /**
+       * @brief @return Returns binary logarithm of size of chunks, which
+       * the space of assignments is split to.
+       */
+      int getChunkBits();
+
+      /**
+       * @brief @return Returns order in which assignments are explored.
+       */
+      Mode getMode();
+
+      /**
+       * Positions of assignments are counted in order given by mode, so
+       * that ranges of all solvers of the same problem and mode are
+       * compatible. Range is used since next reset() (whole space of
+       * assignments is explored by default).
+       * @brief Restrict exploration to range of assignments.
+       * @param from The first position, it has to be aligned to chunks
+       * (see getChunkBits()).
+       * @param to Position following the last one, it has to be aligned
+       * to chunks or equal to 2^(count of variables).
+       */
+      void setRange(const BigNumber &from, const BigNumber &to);
+
+      /**
+       * Checkpoint holds range of assignments, ranges not explored yet,
+       * statistics and solutions found.
+       */
+      virtual void saveCheckpoint(const std::string &fileName);
+
+      /**
+       * Range of assignments is restored from checkpoint as well.
+       * @attention Checkpoint has to be saved by solver of the same problem
+       * and mode. Unless mode is MODE_BRANCH_AND_BOUND, step_width has to
+       * be the same (or smaller) too.
+       */
+      virtual void loadCheckpoint(const std::string &fileName);
+
     protected:
       virtual void initialize();
       virtual void doStep();
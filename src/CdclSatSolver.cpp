@@ -0,0 +1,737 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <assert.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "fssIO.h"
+#include "SatProblem.h"
+#include "CnfFormula.h"
+#include "CdclSatSolver.h"
+
+namespace FastSatSolver {
+
+  namespace {
+    // Literal of variable v is 2*v (positive) or 2*v+1 (negative)
+    typedef int TLit;
+    inline TLit mkLit(int var, bool neg) { return var+var+neg; }
+    inline int  litVar(TLit lit)         { return lit>>1; }
+    inline bool litNeg(TLit lit)         { return lit&1; }
+
+    const int     RESTART_BASE    = 100;    // conflicts per unit of Luby sequence
+    const int     REDUCE_BASE     = 2000;   // conflicts before first reduction
+    const int     REDUCE_INC      = 300;    // increment of the interval
+    const double  VAR_DECAY       = 0.95;
+    const double  CLAUSE_DECAY    = 0.999;
+    const double  RESCALE_LIMIT   = 1e100;
+
+    // Values of variables and literals
+    enum TValue {
+      V_FALSE = 0,
+      V_TRUE  = 1,
+      V_UNDEF = 2
+    };
+
+    // Literals are allocated together with clause's header
+    struct Clause {
+      double              activity;
+      int                 lbd;      // count of distinct decision levels
+      bool                learnt;
+      bool                deleted;
+      int                 size;
+      TLit                lits[1];  // watched literals are at [0] and [1]
+
+      static Clause* create(const std::vector<TLit> &lits, bool learnt) {
+        const int size = lits.size();
+        void *mem = ::operator new(sizeof(Clause) + (size-1)*sizeof(TLit));
+        Clause *c = static_cast<Clause *>(mem);
+        c->activity = 0.0;
+        c->lbd = 0;
+        c->learnt = learnt;
+        c->deleted = false;
+        c->size = size;
+        std::copy(lits.begin(), lits.end(), c->lits);
+        return c;
+      }
+      static void destroy(Clause *c) {
+        ::operator delete(c);
+      }
+    };
+
+    struct Watcher {
+      Clause  *clause;
+      TLit    blocker;  // if true, clause need not to be visited
+
+      Watcher(Clause *clause_, TLit blocker_):
+        clause(clause_), blocker(blocker_)
+      {
+      }
+    };
+
+    // Learned clauses to delete first go first
+    struct ClauseWorse {
+      bool operator() (const Clause *a, const Clause *b) const {
+        if (a->lbd != b->lbd)
+          return a->lbd > b->lbd;
+        return a->activity < b->activity;
+      }
+    };
+  }
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // CdclSatSolver implementation
+  struct CdclSatSolver::Private {
+    SatProblem                    *problem;
+    CnfFormula                    cnf;
+    int                           stepConflicts;
+    SatItemSet                    resultSet;
+
+    // Clause database
+    std::vector<Clause *>         clauses;
+    std::vector<Clause *>         learnts;
+    std::vector<std::vector<Watcher> > watches;   ///< indexed by falsified literal
+    bool                          ok;             ///< false if no (more) solutions
+
+    // Assignment
+    std::vector<char>             assigns;
+    std::vector<char>             polarity;       ///< saved phase (true if negative)
+    std::vector<int>              level;
+    std::vector<Clause *>         reason;
+    std::vector<TLit>             trail;
+    std::vector<int>              trailLim;       ///< trail size at each decision
+    unsigned                      qhead;
+
+    // VSIDS (binary heap of unassigned variables ordered by activity)
+    std::vector<double>           activity;
+    std::vector<int>              heap;
+    std::vector<int>              heapIndex;      ///< -1 if not in heap
+    double                        varInc;
+    double                        clauseInc;
+
+    // Analysis
+    std::vector<char>             seen;
+    std::vector<TLit>             learntClause;
+    std::vector<TLit>             toClear;        ///< literals marked as seen
+    std::vector<TLit>             stack;
+
+    // Search control
+    int                           restarts;
+    long                          restartConflicts;
+    long                          nextReduce;     ///< conflicts count to reduce at
+    long                          reduceInterval;
+
+    // Statistics
+    long                          conflicts;
+    long                          decisions;
+    float                         minFitness;
+    float                         maxFitness;
+    double                        sumFitness;
+    long                          samples;
+
+    Private(SatProblem *problem_, int stepConflicts_):
+      problem(problem_),
+      cnf(problem_),
+      stepConflicts(stepConflicts_)
+    {
+    }
+    ~Private() {
+      freeClauses();
+    }
+
+    void freeClauses() {
+      for(unsigned i=0; i<clauses.size(); i++)
+        Clause::destroy(clauses[i]);
+      for(unsigned i=0; i<learnts.size(); i++)
+        Clause::destroy(learnts[i]);
+      clauses.clear();
+      learnts.clear();
+    }
+
+    void init();
+
+    int varsCount() const {
+      return assigns.size();
+    }
+    int decisionLevel() const {
+      return trailLim.size();
+    }
+    TValue value(TLit lit) const {
+      const char val = assigns[litVar(lit)];
+      if (V_UNDEF == val)
+        return V_UNDEF;
+      return static_cast<TValue>(val ^ litNeg(lit));
+    }
+
+    // Heap operations
+    bool heapLess(int a, int b) const {
+      return activity[a] > activity[b];
+    }
+    void heapUp(int pos);
+    void heapDown(int pos);
+    void heapInsert(int var) {
+      if (0 <= heapIndex[var])
+        return;
+      heapIndex[var] = heap.size();
+      heap.push_back(var);
+      heapUp(heapIndex[var]);
+    }
+    int heapRemoveTop();
+
+    void bumpVar(int var);
+    void bumpClause(Clause *);
+
+    void attach(Clause *c) {
+      watches[c->lits[0]].push_back(Watcher(c, c->lits[1]));
+      watches[c->lits[1]].push_back(Watcher(c, c->lits[0]));
+    }
+    void enqueue(TLit lit, Clause *from) {
+      const int var = litVar(lit);
+      assert(V_UNDEF == assigns[var]);
+      assigns[var] = !litNeg(lit);
+      level[var] = decisionLevel();
+      reason[var] = from;
+      trail.push_back(lit);
+    }
+    // Bit set of decision levels for quick (inexact) level membership test
+    unsigned abstractLevel(int var) const {
+      return 1U << (level[var] & 31);
+    }
+    bool locked(const Clause *c) const {
+      const TLit first = c->lits[0];
+      return reason[litVar(first)] == c && V_TRUE == value(first);
+    }
+
+    // Add clause at decision level 0, returns false if problem became UNSAT
+    bool addClause(std::vector<TLit> lits);
+
+    Clause* propagate();
+    void analyze(Clause *confl, int &btLevel);
+    bool redundant(TLit lit, unsigned levels);
+    int computeLbd(const std::vector<TLit> &lits);
+    void cancelUntil(int level);
+    int pickBranchVar();
+    void reduceLearnts();
+
+    // Solution handling
+    void assignment(std::vector<bool> &data) const;
+    void sampleFitness(int satsCount);
+  };
+
+  void CdclSatSolver::Private::init() {
+    freeClauses();
+    resultSet.clear();
+    const int nVars = cnf.getVarsCount();
+    watches.assign(2*nVars, std::vector<Watcher>());
+    assigns.assign(nVars, V_UNDEF);
+    polarity.assign(nVars, true);
+    level.assign(nVars, 0);
+    reason.assign(nVars, static_cast<Clause *>(0));
+    trail.clear();
+    trailLim.clear();
+    qhead = 0;
+
+    activity.assign(nVars, 0.0);
+    heap.clear();
+    heapIndex.assign(nVars, -1);
+    for(int i=0; i<nVars; i++)
+      heapInsert(i);
+    varInc = 1.0;
+    clauseInc = 1.0;
+    seen.assign(nVars, 0);
+
+    restarts = 0;
+    restartConflicts = 0;
+    conflicts = 0;
+    decisions = 0;
+    minFitness = INFINITY;
+    maxFitness = 0.0;
+    sumFitness = 0.0;
+    samples = 0;
+
+    // Load CNF of problem
+    ok = true;
+    const int nClauses = cnf.getClausesCount();
+    for(int i=0; ok && i<nClauses; i++) {
+      const TClause &clause = cnf.getClause(i);
+      std::vector<TLit> lits;
+      for(unsigned j=0; j<clause.size(); j++) {
+        const TLiteral dimacs = clause[j];
+        lits.push_back((dimacs > 0)
+            ? mkLit(dimacs-1, false)
+            : mkLit(-dimacs-1, true));
+      }
+      ok = addClause(lits);
+    }
+    reduceInterval = REDUCE_BASE;
+    nextReduce = REDUCE_BASE;
+  }
+  bool CdclSatSolver::Private::addClause(std::vector<TLit> lits) {
+    assert(0 == decisionLevel());
+    if (!ok)
+      return false;
+
+    // Remove duplicate and false literals, skip satisfied clauses
+    std::sort(lits.begin(), lits.end());
+    unsigned j = 0;
+    for(unsigned i=0; i<lits.size(); i++) {
+      const TLit lit = lits[i];
+      const TValue val = value(lit);
+      if (V_TRUE == val || (j && lits[j-1] == (lit^1)))
+        return true;
+      if (V_FALSE == val || (j && lits[j-1] == lit))
+        continue;
+      lits[j++] = lit;
+    }
+    lits.resize(j);
+
+    switch (lits.size()) {
+      case 0:
+        return false;
+      case 1:
+        enqueue(lits[0], 0);
+        return 0 == propagate();
+      default:
+        Clause *c = Clause::create(lits, false);
+        clauses.push_back(c);
+        attach(c);
+        return true;
+    }
+  }
+  void CdclSatSolver::Private::heapUp(int pos) {
+    const int var = heap[pos];
+    while (pos) {
+      const int parent = (pos-1)>>1;
+      if (!heapLess(var, heap[parent]))
+        break;
+      heap[pos] = heap[parent];
+      heapIndex[heap[pos]] = pos;
+      pos = parent;
+    }
+    heap[pos] = var;
+    heapIndex[var] = pos;
+  }
+  void CdclSatSolver::Private::heapDown(int pos) {
+    const int var = heap[pos];
+    const int size = heap.size();
+    for(;;) {
+      int child = 2*pos+1;
+      if (child >= size)
+        break;
+      if (child+1 < size && heapLess(heap[child+1], heap[child]))
+        child++;
+      if (!heapLess(heap[child], var))
+        break;
+      heap[pos] = heap[child];
+      heapIndex[heap[pos]] = pos;
+      pos = child;
+    }
+    heap[pos] = var;
+    heapIndex[var] = pos;
+  }
+  int CdclSatSolver::Private::heapRemoveTop() {
+    const int var = heap[0];
+    heapIndex[var] = -1;
+    const int last = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+      heap[0] = last;
+      heapIndex[last] = 0;
+      heapDown(0);
+    }
+    return var;
+  }
+  void CdclSatSolver::Private::bumpVar(int var) {
+    activity[var] += varInc;
+    if (activity[var] > RESCALE_LIMIT) {
+      for(int i=0; i<varsCount(); i++)
+        activity[i] /= RESCALE_LIMIT;
+      varInc /= RESCALE_LIMIT;
+    }
+    if (0 <= heapIndex[var])
+      heapUp(heapIndex[var]);
+  }
+  void CdclSatSolver::Private::bumpClause(Clause *c) {
+    c->activity += clauseInc;
+    if (c->activity > RESCALE_LIMIT) {
+      for(unsigned i=0; i<learnts.size(); i++)
+        learnts[i]->activity /= RESCALE_LIMIT;
+      clauseInc /= RESCALE_LIMIT;
+    }
+  }
+  Clause* CdclSatSolver::Private::propagate() {
+    while (qhead < trail.size()) {
+      const TLit falseLit = trail[qhead++]^1;
+      std::vector<Watcher> &ws = watches[falseLit];
+      const unsigned size = ws.size();
+      unsigned i = 0, j = 0;
+      while (i < size) {
+        // Clause is satisfied by its blocker
+        if (V_TRUE == value(ws[i].blocker)) {
+          ws[j++] = ws[i++];
+          continue;
+        }
+
+        // Make sure the false literal is at [1]
+        Clause *c = ws[i++].clause;
+        TLit *lits = c->lits;
+        if (lits[0] == falseLit)
+          std::swap(lits[0], lits[1]);
+        const TLit first = lits[0];
+        const Watcher w(c, first);
+        if (V_TRUE == value(first)) {
+          ws[j++] = w;
+          continue;
+        }
+
+        // Look for new literal to watch
+        bool found = false;
+        for(int k=2; k<c->size; k++) {
+          if (V_FALSE != value(lits[k])) {
+            lits[1] = lits[k];
+            lits[k] = falseLit;
+            watches[lits[1]].push_back(w);
+            found = true;
+            break;
+          }
+        }
+        if (found)
+          continue;
+
+        // Clause is unit or conflicting
+        ws[j++] = w;
+        if (V_FALSE == value(first)) {
+          while (i < size)
+            ws[j++] = ws[i++];
+          ws.erase(ws.begin()+j, ws.end());
+          qhead = trail.size();
+          return c;
+        }
+        enqueue(first, c);
+      }
+      ws.erase(ws.begin()+j, ws.end());
+    }
+    return 0;
+  }
+  void CdclSatSolver::Private::analyze(Clause *confl, int &btLevel) {
+    learntClause.clear();
+    learntClause.push_back(0);    // place for asserting literal
+
+    // Resolve conflicting clause with reasons up to the first UIP
+    int pathCount = 0;
+    TLit lit = -1;
+    int index = trail.size()-1;
+    do {
+      assert(confl);
+      if (confl->learnt)
+        bumpClause(confl);
+      for(int j=(lit<0)?0:1; j<confl->size; j++) {
+        const TLit q = confl->lits[j];
+        const int var = litVar(q);
+        if (seen[var] || 0 == level[var])
+          continue;
+        bumpVar(var);
+        seen[var] = 1;
+        if (level[var] >= decisionLevel())
+          pathCount++;
+        else
+          learntClause.push_back(q);
+      }
+
+      // Select next literal to resolve on
+      while (!seen[litVar(trail[index--])]);
+      lit = trail[index+1];
+      confl = reason[litVar(lit)];
+      seen[litVar(lit)] = 0;
+      pathCount--;
+    } while (0 < pathCount);
+    learntClause[0] = lit^1;
+
+    // Remove literals implied by other literals of learned clause
+    unsigned levels = 0;
+    for(unsigned i=1; i<learntClause.size(); i++)
+      levels |= abstractLevel(litVar(learntClause[i]));
+    toClear = learntClause;
+    unsigned j = 1;
+    for(unsigned i=1; i<learntClause.size(); i++)
+      if (!redundant(learntClause[i], levels))
+        learntClause[j++] = learntClause[i];
+    learntClause.resize(j);
+    for(unsigned i=0; i<toClear.size(); i++)
+      seen[litVar(toClear[i])] = 0;
+
+    // Find backtrack level and put its literal at [1] (to be watched)
+    btLevel = 0;
+    if (1 < learntClause.size()) {
+      unsigned maxIndex = 1;
+      for(unsigned i=2; i<learntClause.size(); i++)
+        if (level[litVar(learntClause[i])] > level[litVar(learntClause[maxIndex])])
+          maxIndex = i;
+      std::swap(learntClause[1], learntClause[maxIndex]);
+      btLevel = level[litVar(learntClause[1])];
+    }
+  }
+  bool CdclSatSolver::Private::redundant(TLit lit, unsigned levels) {
+    if (!reason[litVar(lit)])
+      return false;
+
+    // Literal is redundant if all literals of its reason are (recursively)
+    // implied by literals of learned clause
+    const unsigned top = toClear.size();
+    stack.clear();
+    stack.push_back(lit);
+    while (!stack.empty()) {
+      const Clause *c = reason[litVar(stack.back())];
+      stack.pop_back();
+      for(int i=1; i<c->size; i++) {
+        const TLit q = c->lits[i];
+        const int var = litVar(q);
+        if (seen[var] || 0 == level[var])
+          continue;
+        if (reason[var] && (abstractLevel(var) & levels)) {
+          seen[var] = 1;
+          stack.push_back(q);
+          toClear.push_back(q);
+          continue;
+        }
+
+        // Literal can't be removed, undo marks made by this call
+        for(unsigned j=top; j<toClear.size(); j++)
+          seen[litVar(toClear[j])] = 0;
+        toClear.resize(top);
+        return false;
+      }
+    }
+    return true;
+  }
+  int CdclSatSolver::Private::computeLbd(const std::vector<TLit> &lits) {
+    std::vector<int> levels;
+    for(unsigned i=0; i<lits.size(); i++)
+      levels.push_back(level[litVar(lits[i])]);
+    std::sort(levels.begin(), levels.end());
+    return std::unique(levels.begin(), levels.end()) - levels.begin();
+  }
+  void CdclSatSolver::Private::cancelUntil(int toLevel) {
+    if (decisionLevel() <= toLevel)
+      return;
+    for(int i=trail.size()-1; i>=trailLim[toLevel]; i--) {
+      const int var = litVar(trail[i]);
+      assigns[var] = V_UNDEF;
+      reason[var] = 0;
+      polarity[var] = litNeg(trail[i]);
+      heapInsert(var);
+    }
+    trail.resize(trailLim[toLevel]);
+    trailLim.resize(toLevel);
+    qhead = trail.size();
+  }
+  int CdclSatSolver::Private::pickBranchVar() {
+    while (!heap.empty()) {
+      const int var = heapRemoveTop();
+      if (V_UNDEF == assigns[var])
+        return var;
+    }
+    return -1;
+  }
+  void CdclSatSolver::Private::reduceLearnts() {
+    // Delete less useful half of learned clauses, keep glue clauses
+    std::sort(learnts.begin(), learnts.end(), ClauseWorse());
+    const unsigned limit = learnts.size()/2;
+    unsigned j = 0;
+    for(unsigned i=0; i<learnts.size(); i++) {
+      Clause *c = learnts[i];
+      if (i < limit && 2 < c->lbd && 2 < c->size && !locked(c))
+        c->deleted = true;
+      else
+        learnts[j++] = c;
+    }
+    const unsigned removed = learnts.size() - j;
+    learnts.resize(j);
+    if (!removed)
+      return;
+
+    // Remove watchers of deleted clauses
+    std::vector<Clause *> toDelete;
+    for(unsigned l=0; l<watches.size(); l++) {
+      std::vector<Watcher> &ws = watches[l];
+      unsigned k = 0;
+      for(unsigned i=0; i<ws.size(); i++) {
+        if (!ws[i].clause->deleted)
+          ws[k++] = ws[i];
+        else if (ws[i].clause->lits[0] == static_cast<TLit>(l))
+          // Each clause is watched twice, collect it only once
+          toDelete.push_back(ws[i].clause);
+      }
+      ws.erase(ws.begin()+k, ws.end());
+    }
+    for(unsigned i=0; i<toDelete.size(); i++)
+      Clause::destroy(toDelete[i]);
+  }
+  void CdclSatSolver::Private::assignment(std::vector<bool> &data) const {
+    const int nVars = cnf.getProblemVarsCount();
+    data.resize(nVars);
+    for(int i=0; i<nVars; i++)
+      data[i] = (V_UNDEF == assigns[i])
+        ? !polarity[i]
+        : V_TRUE == assigns[i];
+  }
+  void CdclSatSolver::Private::sampleFitness(int satsCount) {
+    const float fitness = static_cast<float>(satsCount)/problem->getFormulasCount();
+    if (fitness < minFitness)
+      minFitness = fitness;
+    if (fitness > maxFitness)
+      maxFitness = fitness;
+    sumFitness += fitness;
+    samples++;
+  }
+
+  CdclSatSolver::CdclSatSolver(SatProblem *problem, int stepConflicts):
+    d(new Private(problem, stepConflicts))
+  {
+    d->init();
+  }
+  CdclSatSolver::~CdclSatSolver() {
+    delete d;
+  }
+  SatProblem* CdclSatSolver::getProblem() {
+    return d->problem;
+  }
+  int CdclSatSolver::getSolutionsCount() {
+    return d->resultSet.getLength();
+  }
+  SatItemVector* CdclSatSolver::getSolutionVector() {
+    return d->resultSet.createVector();
+  }
+  float CdclSatSolver::minFitness() {
+    return d->minFitness;
+  }
+  float CdclSatSolver::avgFitness() {
+    return (d->samples)
+      ? d->sumFitness / d->samples
+      : 0.0;
+  }
+  float CdclSatSolver::maxFitness() {
+    return d->maxFitness;
+  }
+  bool CdclSatSolver::isExhausted() {
+    return !d->ok;
+  }
+  long CdclSatSolver::getConflictsCount() {
+    return d->conflicts;
+  }
+  long CdclSatSolver::getDecisionsCount() {
+    return d->decisions;
+  }
+  int CdclSatSolver::getLearntsCount() {
+    return d->learnts.size();
+  }
+  // protected
+  void CdclSatSolver::initialize() {
+    d->init();
+  }
+  // protected
+  void CdclSatSolver::doStep() {
+    if (!d->ok) {
+      this->stop();
+      return;
+    }
+    const float lastMaxFitness = d->maxFitness;
+    for(int stepConflicts=0; stepConflicts < d->stepConflicts; ) {
+      Clause *confl = d->propagate();
+      if (confl) {
+        // Conflict
+        d->conflicts++;
+        d->restartConflicts++;
+        stepConflicts++;
+        if (0 == d->decisionLevel()) {
+          // No (more) solutions
+          d->ok = false;
+          this->stop();
+          return;
+        }
+        int btLevel;
+        d->analyze(confl, btLevel);
+        d->cancelUntil(btLevel);
+        const std::vector<TLit> &learnt = d->learntClause;
+        if (1 == learnt.size()) {
+          d->enqueue(learnt[0], 0);
+        } else {
+          Clause *c = Clause::create(learnt, true);
+          c->lbd = d->computeLbd(learnt);
+          d->learnts.push_back(c);
+          d->attach(c);
+          d->bumpClause(c);
+          d->enqueue(learnt[0], c);
+        }
+        d->varInc /= VAR_DECAY;
+        d->clauseInc /= CLAUSE_DECAY;
+        continue;
+      }
+
+      // Restart according to Luby sequence
+      if (d->restartConflicts >= RESTART_BASE * luby(d->restarts)) {
+        d->restartConflicts = 0;
+        d->restarts++;
+        d->cancelUntil(0);
+      }
+      if (d->conflicts >= d->nextReduce) {
+        d->reduceInterval += REDUCE_INC;
+        d->nextReduce = d->conflicts + d->reduceInterval;
+        d->reduceLearnts();
+      }
+
+      const int var = d->pickBranchVar();
+      if (var < 0) {
+        // All variables assigned, model found
+        std::vector<bool> data;
+        d->assignment(data);
+        VectorSatItem *item = new VectorSatItem(data);
+        assert(d->problem->getSatsCount(item) == d->problem->getFormulasCount());
+        d->sampleFitness(d->problem->getFormulasCount());
+        d->resultSet.addItem(item);
+        this->notify();
+
+        // Exclude solution found by blocking clause
+        std::vector<TLit> blocking;
+        for(unsigned i=0; i<data.size(); i++)
+          blocking.push_back(mkLit(i, data[i]));
+        d->cancelUntil(0);
+        d->ok = d->addClause(blocking);
+        if (!d->ok)
+          this->stop();
+        return;
+      }
+
+      // Decision
+      d->decisions++;
+      d->trailLim.push_back(d->trail.size());
+      d->enqueue(mkLit(var, d->polarity[var]), 0);
+    }
+
+    // Sample fitness of saved phases
+    std::vector<bool> data;
+    d->assignment(data);
+    VectorSatItem item(data);
+    d->sampleFitness(d->problem->getSatsCount(&item));
+    if (d->maxFitness > lastMaxFitness)
+      this->notify();
+  }
+
+} // namespace FastSatSolver
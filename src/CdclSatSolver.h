@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef CDCLSATSOLVER_H
+#define CDCLSATSOLVER_H
+
+/**
+ * @file CdclSatSolver.h
+ * @brief CdclSatSolver class using conflict-driven clause learning to solve
+ * SAT problem.
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-14
+ * @ingroup SatSolver
+ */
+
+#include "SatSolver.h"
+
+namespace FastSatSolver {
+  class SatProblem;
+
+  /**
+   * Solver works on CNF of SAT problem (consider CnfFormula) using
+   * two-watched-literal propagation, VSIDS decision heuristic with phase
+   * saving, first-UIP clause learning, Luby restarts and periodical
+   * deletion of inactive learned clauses. Each solution found is excluded
+   * by blocking clause over variables of SAT problem, so that all solutions
+   * can be enumerated. Unlike BlindSatSolver and GaSatSolver it can prove,
+   * that there are no (more) solutions.
+   * @brief Complete solver using conflict-driven clause learning.
+   * @ingroup SatSolver
+   */
+  class CdclSatSolver: public AbstractSatSolver
+  {
+    public:
+      /**
+       * @param problem SatProblem instance containing SAT problem to solve.
+       * @param stepConflicts Maximal count of conflicts in one step. This
+       * influences the granullarity of notifications and process control.
+       */
+      CdclSatSolver(SatProblem *problem, int stepConflicts);
+      virtual ~CdclSatSolver();
+      virtual SatProblem* getProblem();
+      virtual int getSolutionsCount();
+      virtual SatItemVector* getSolutionVector();
+
+      /**
+       * @brief Fitness is computed for solutions and for saved phases of
+       * variables at the end of each step.
+       */
+      virtual float minFitness();
+      virtual float avgFitness();
+      virtual float maxFitness();
+
+      /**
+       * @brief @return Returns true if solver proved, that there are no
+       * more solutions than solutions already found.
+       */
+      bool isExhausted();
+
+      /**
+       * @brief @return Returns count of conflicts since initialization.
+       */
+      long getConflictsCount();
+
+      /**
+       * @brief @return Returns count of decisions since initialization.
+       */
+      long getDecisionsCount();
+
+      /**
+       * @brief @return Returns count of learned clauses currently kept.
+       */
+      int getLearntsCount();
+
+    protected:
+      virtual void initialize();
+      virtual void doStep();
+
+    private:
+      struct Private;
+      Private *d;
+  };
+
+} // namespace FastSatSolver
+
+#endif // CDCLSATSOLVER_H
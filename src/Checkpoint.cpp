@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "fssIO.h"
+#include "BigNumber.h"
+#include "SatSolver.h"
+#include "Checkpoint.h"
+
+namespace FastSatSolver {
+
+  namespace {
+    const char MAGIC[] = "FSSCKPT1";
+    const size_t MAGIC_LENGTH = sizeof(MAGIC) - 1;
+
+    // Byte order of double is assumed to be the same as of integers
+    bool isLittleEndian() {
+      const unsigned int one = 1U;
+      unsigned char first;
+      memcpy(&first, &one, 1);
+      return 1 == first;
+    }
+  }
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // CheckpointWriter implementation
+  CheckpointWriter::CheckpointWriter(char kind):
+    data_(MAGIC)
+  {
+    data_ += kind;
+  }
+  CheckpointWriter::~CheckpointWriter() {
+  }
+  void CheckpointWriter::writeUnsigned(unsigned long value) {
+    while (0x7FUL < value) {
+      data_ += static_cast<char>(0x80 | (value & 0x7FUL));
+      value >>= 7;
+    }
+    data_ += static_cast<char>(value);
+  }
+  void CheckpointWriter::writeFloat(float value) {
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof bits);
+    for(unsigned i=0; i<sizeof bits; i++)
+      data_ += static_cast<char>(bits >> (8*i));
+  }
+  void CheckpointWriter::writeDouble(double value) {
+    // The least significant byte first (as writeFloat() does)
+    unsigned char bytes[sizeof value];
+    memcpy(bytes, &value, sizeof value);
+    const bool little = isLittleEndian();
+    for(unsigned i=0; i<sizeof bytes; i++)
+      data_ += static_cast<char>(bytes[(little) ? i : sizeof bytes - 1 - i]);
+  }
+  void CheckpointWriter::writeNumber(const BigNumber &number) {
+    // Bytes of number, the least significant one first
+    BigNumber rest = number;
+    std::string bytes;
+    while (!rest.isZero())
+      bytes += static_cast<char>(rest.divide(0x100UL));
+    this->writeUnsigned(bytes.size());
+    data_ += bytes;
+  }
+  void CheckpointWriter::writeItem(const ISatItem &item) {
+    const int length = item.getLength();
+    this->writeUnsigned(length);
+    for(int i=0; i<length; i+=8) {
+      unsigned char byte = 0;
+      for(int j=0; j<8 && i+j<length; j++)
+        if (item.getBit(i+j))
+          byte |= 1<<j;
+      data_ += static_cast<char>(byte);
+    }
+  }
+  void CheckpointWriter::commit(const std::string &fileName) {
+    const std::string tmpName = fileName + ".tmp";
+    FILE *file = fopen(tmpName.c_str(), "wb");
+    if (0 == file)
+      throw GenericException("Could not write checkpoint: " + tmpName);
+    const bool written = data_.size() == fwrite(data_.data(), 1, data_.size(), file);
+    if (0!= fclose(file) || !written) {
+      remove(tmpName.c_str());
+      throw GenericException("Could not write checkpoint: " + tmpName);
+    }
+    if (0!= rename(tmpName.c_str(), fileName.c_str()))
+      throw GenericException("Could not write checkpoint: " + fileName);
+  }
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // CheckpointReader implementation
+  CheckpointReader::CheckpointReader(const std::string &fileName, char kind):
+    fileName_(fileName),
+    pos_(0)
+  {
+    FILE *file = fopen(fileName.c_str(), "rb");
+    if (0 == file)
+      throw GenericException("Could not open file: " + fileName);
+    unsigned char buffer[4096];
+    size_t size;
+    while (0 < (size = fread(buffer, 1, sizeof buffer, file)))
+      data_.insert(data_.end(), buffer, buffer + size);
+    fclose(file);
+
+    for(unsigned i=0; i<MAGIC_LENGTH; i++)
+      if (this->readByte() != static_cast<unsigned char>(MAGIC[i]))
+        throw GenericException("Not a checkpoint file: " + fileName);
+    if (this->readByte() != static_cast<unsigned char>(kind))
+      throw GenericException("Checkpoint of another solver: " + fileName);
+  }
+  CheckpointReader::~CheckpointReader() {
+  }
+  unsigned char CheckpointReader::readByte() {
+    if (data_.size() <= pos_)
+      throw GenericException("Truncated checkpoint file: " + fileName_);
+    return data_[pos_++];
+  }
+  unsigned long CheckpointReader::readUnsigned() {
+    unsigned long value = 0UL;
+    for(int shift=0;; shift+=7) {
+      const unsigned char byte = this->readByte();
+      value |= static_cast<unsigned long>(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+        return value;
+    }
+  }
+  float CheckpointReader::readFloat() {
+    unsigned int bits = 0;
+    for(unsigned i=0; i<sizeof bits; i++)
+      bits |= static_cast<unsigned int>(this->readByte()) << (8*i);
+    float value;
+    memcpy(&value, &bits, sizeof value);
+    return value;
+  }
+  double CheckpointReader::readDouble() {
+    unsigned char bytes[sizeof(double)];
+    const bool little = isLittleEndian();
+    for(unsigned i=0; i<sizeof bytes; i++)
+      bytes[(little) ? i : sizeof bytes - 1 - i] = this->readByte();
+    double value;
+    memcpy(&value, bytes, sizeof value);
+    return value;
+  }
+  BigNumber CheckpointReader::readNumber() {
+    const unsigned long count = this->readUnsigned();
+    if (data_.size() - pos_ < count)
+      throw GenericException("Truncated checkpoint file: " + fileName_);
+
+    // The most significant byte first
+    BigNumber number;
+    for(unsigned long i=count; i>0; i--) {
+      number <<= 8;
+      number += data_[pos_ + i - 1];
+    }
+    pos_ += count;
+    return number;
+  }
+  void CheckpointReader::readItem(std::vector<char> &bits, int length) {
+    if (static_cast<unsigned long>(length) != this->readUnsigned())
+      throw GenericException("Checkpoint of another SAT problem: " + fileName_);
+    bits.resize(length);
+    for(int i=0; i<length; i+=8) {
+      const unsigned char byte = this->readByte();
+      for(int j=0; j<8 && i+j<length; j++)
+        bits[i+j] = (byte >> j) & 1;
+    }
+  }
+
+} // namespace FastSatSolver
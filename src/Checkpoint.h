@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+/**
+ * @file Checkpoint.h
+ * @brief Binary checkpoints of solver's state.
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-22
+ * @ingroup SatSolver
+ */
+
+#include <string>
+#include <vector>
+
+namespace FastSatSolver {
+  class BigNumber;
+  class ISatItem;
+
+  /**
+   * Checkpoint is built in memory and written at once by commit(). File is
+   * replaced atomically (by renaming temporary file), so that checkpoint
+   * file is always complete even if process is killed while writing.
+   * Unsigned integers are stored in variable-length encoding (7 bits per
+   * byte), floats in IEEE format, assignments packed bit by bit.
+   * @brief Writer of binary checkpoint file.
+   * @ingroup SatSolver
+   */
+  class CheckpointWriter {
+    public:
+      /**
+       * @param kind Kind of checkpoint (one per solver class).
+       */
+      CheckpointWriter(char kind);
+      ~CheckpointWriter();
+      void writeUnsigned(unsigned long);
+      void writeFloat(float);
+      void writeDouble(double);
+      void writeNumber(const BigNumber &);
+
+      /**
+       * @brief Write assignment (including its length).
+       */
+      void writeItem(const ISatItem &);
+
+      /**
+       * @brief Write checkpoint to file.
+       * @param fileName Name of file to replace.
+       */
+      void commit(const std::string &fileName);
+    private:
+      std::string data_;
+  };
+
+  /**
+   * @brief Reader of binary checkpoint file written by CheckpointWriter.
+   * @attention All methods throw GenericException if data are truncated.
+   * @ingroup SatSolver
+   */
+  class CheckpointReader {
+    public:
+      /**
+       * @param fileName Name of checkpoint file.
+       * @param kind Kind of checkpoint expected.
+       */
+      CheckpointReader(const std::string &fileName, char kind);
+      ~CheckpointReader();
+      unsigned long readUnsigned();
+      float readFloat();
+      double readDouble();
+      BigNumber readNumber();
+
+      /**
+       * @brief Read assignment written by writeItem().
+       * @param bits Values of variables (0 or 1).
+       * @param length Expected count of variables.
+       */
+      void readItem(std::vector<char> &bits, int length);
+    private:
+      std::string fileName_;
+      std::vector<unsigned char> data_;
+      unsigned pos_;
+
+      unsigned char readByte();
+  };
+
+  /**
+   * @interface ICheckpointable
+   * @brief Process able to save and restore its state.
+   * @ingroup SatSolver
+   */
+  class ICheckpointable {
+    public:
+      virtual ~ICheckpointable() { }
+
+      /**
+       * @brief Write state of process.
+       * @param fileName Name of checkpoint file to replace.
+       * @note It should be called between steps of process only.
+       */
+      virtual void saveCheckpoint(const std::string &fileName) = 0;
+
+      /**
+       * @brief Restore state of process saved by saveCheckpoint().
+       * @param fileName Name of checkpoint file.
+       * @note It should be called after reset() of process.
+       */
+      virtual void loadCheckpoint(const std::string &fileName) = 0;
+  };
+
+} // namespace FastSatSolver
+
+#endif // CHECKPOINT_H
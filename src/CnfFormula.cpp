@@ -0,0 +1,345 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <assert.h>
+#include "FormulaCode.h"
+#include "SatProblem.h"
+#include "CnfFormula.h"
+
+namespace FastSatSolver {
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // CnfFormula implementation
+  struct CnfFormula::Private {
+    // Node of expression DAG rebuilt from program
+    struct Node {
+      EOpCode           opCode;
+      int               a;            ///< operand (or index of variable)
+      int               b;            ///< second operand
+    };
+    enum EPolarity {
+      POL_NONE = 0,
+      POL_POS  = 1,
+      POL_NEG  = 2,
+      POL_BOTH = POL_POS | POL_NEG
+    };
+
+    SatProblem                  *problem;
+    bool                        full;
+    int                         problemVars;
+    int                         varsCount;
+    std::vector<TClause>        clauses;
+
+    std::vector<Node>           nodes;      ///< operands always precede their operator
+    std::vector<int>            roots;
+    std::vector<int>            refs;
+    std::vector<int>            polarity;
+    std::vector<TLiteral>       lits;       ///< zero if not encoded yet
+    TLiteral                    constLit;   ///< literal fixed to TRUE
+
+    void readProgram(const FormulaCode &program);
+    void computePolarity();
+    void gather(int id, EOpCode opCode, std::vector<int> &operands);
+    TLiteral encode(int id);
+    void assertNode(int id);
+
+    void addClause(TLiteral l1, TLiteral l2) {
+      TClause clause;
+      clause.push_back(l1);
+      clause.push_back(l2);
+      clauses.push_back(clause);
+    }
+    void addClause(TLiteral l1, TLiteral l2, TLiteral l3) {
+      TClause clause;
+      clause.push_back(l1);
+      clause.push_back(l2);
+      clause.push_back(l3);
+      clauses.push_back(clause);
+    }
+  };
+
+  // Rebuild DAG from program (temporaries refer to the same node)
+  void CnfFormula::Private::readProgram(const FormulaCode &program) {
+    const Instruction *code = program.getData();
+    const int length = program.getLength();
+    std::vector<int> stack;
+    std::vector<int> temps(program.getTempsCount(), -1);
+    for(int i=0; i<length; i++) {
+      const Instruction &instr = code[i];
+      Node node;
+      node.opCode = instr.opCode;
+      node.a = -1;
+      node.b = -1;
+      switch (instr.opCode) {
+        case OP_FALSE:
+        case OP_TRUE:
+          break;
+
+        case OP_VAR:
+          node.a = instr.var;
+          break;
+
+        case OP_NOT:
+          node.a = stack.back();
+          stack.pop_back();
+          break;
+
+        case OP_AND:
+        case OP_OR:
+        case OP_XOR:
+          node.b = stack.back();
+          stack.pop_back();
+          node.a = stack.back();
+          stack.pop_back();
+          break;
+
+        case OP_COUNT:
+          roots.push_back(stack.back());
+          stack.pop_back();
+          continue;
+
+        case OP_LOAD:
+          stack.push_back(temps[instr.var]);
+          continue;
+
+        case OP_STORE:
+          temps[instr.var] = stack.back();
+          continue;
+      }
+      stack.push_back(nodes.size());
+      nodes.push_back(node);
+    }
+    assert(stack.empty());
+
+    // Count references
+    refs.resize(nodes.size(), 0);
+    for(unsigned i=0; i<nodes.size(); i++) {
+      const Node &node = nodes[i];
+      if (0 <= node.a && OP_VAR != node.opCode)
+        refs[node.a]++;
+      if (0 <= node.b)
+        refs[node.b]++;
+    }
+    for(unsigned i=0; i<roots.size(); i++)
+      refs[roots[i]]++;
+  }
+
+  // Polarity flows from formulas down to operands
+  void CnfFormula::Private::computePolarity() {
+    polarity.resize(nodes.size(), POL_NONE);
+    for(unsigned i=0; i<roots.size(); i++)
+      polarity[roots[i]] |= POL_POS;
+    for(int i=nodes.size()-1; 0<=i; i--) {
+      const Node &node = nodes[i];
+      const int pol = (full) ? POL_BOTH : polarity[i];
+      switch (node.opCode) {
+        case OP_NOT:
+          polarity[node.a] |= ((pol & POL_POS) ? POL_NEG : POL_NONE)
+            | ((pol & POL_NEG) ? POL_POS : POL_NONE);
+          break;
+
+        case OP_AND:
+        case OP_OR:
+          polarity[node.a] |= pol;
+          polarity[node.b] |= pol;
+          break;
+
+        case OP_XOR:
+          if (pol) {
+            polarity[node.a] = POL_BOTH;
+            polarity[node.b] = POL_BOTH;
+          }
+          break;
+
+        default:
+          break;
+      }
+    }
+  }
+
+  // Collect operands of n-ary AND/OR (unshared chains of the same operator)
+  void CnfFormula::Private::gather(int id, EOpCode opCode, std::vector<int> &operands) {
+    std::vector<int> work(1, id);
+    while (!work.empty()) {
+      const int n = work.back();
+      work.pop_back();
+      if (opCode == nodes[n].opCode && (id == n || 1 == refs[n])) {
+        work.push_back(nodes[n].b);
+        work.push_back(nodes[n].a);
+      } else {
+        operands.push_back(n);
+      }
+    }
+  }
+
+  // Return literal equivalent to node, generate clauses of its gate
+  TLiteral CnfFormula::Private::encode(int id) {
+    if (lits[id])
+      return lits[id];
+
+    const Node &node = nodes[id];
+    const int pol = (full) ? POL_BOTH : polarity[id];
+    TLiteral x = 0;
+    switch (node.opCode) {
+      case OP_FALSE:
+      case OP_TRUE:
+        if (!constLit) {
+          constLit = ++varsCount;
+          clauses.push_back(TClause(1, constLit));
+        }
+        x = (OP_TRUE == node.opCode) ? constLit : -constLit;
+        break;
+
+      case OP_VAR:
+        x = node.a + 1;
+        break;
+
+      case OP_NOT:
+        x = -encode(node.a);
+        break;
+
+      case OP_AND:
+      case OP_OR:
+        {
+          std::vector<int> operands;
+          gather(id, node.opCode, operands);
+          TClause ls;
+          for(unsigned i=0; i<operands.size(); i++)
+            ls.push_back(encode(operands[i]));
+          x = ++varsCount;
+
+          // AND: x -> l_i, (l_1 & ... & l_k) -> x
+          // OR:  x -> (l_1 | ... | l_k), l_i -> x
+          const bool isAnd = (OP_AND == node.opCode);
+          const int polSingle = (isAnd) ? POL_POS : POL_NEG;
+          const TLiteral sign = (isAnd) ? 1 : -1;
+          if (pol & polSingle)
+            for(unsigned i=0; i<ls.size(); i++)
+              addClause(-sign*x, sign*ls[i]);
+          if (pol & ~polSingle & POL_BOTH) {
+            TClause clause(1, sign*x);
+            for(unsigned i=0; i<ls.size(); i++)
+              clause.push_back(-sign*ls[i]);
+            clauses.push_back(clause);
+          }
+        }
+        break;
+
+      case OP_XOR:
+        {
+          const TLiteral a = encode(node.a);
+          const TLiteral b = encode(node.b);
+          x = ++varsCount;
+          if (pol & POL_POS) {
+            // x -> a^b
+            addClause(-x, a, b);
+            addClause(-x, -a, -b);
+          }
+          if (pol & POL_NEG) {
+            // a^b -> x
+            addClause(x, -a, b);
+            addClause(x, a, -b);
+          }
+        }
+        break;
+
+      default:
+        assert(false);
+    }
+    lits[id] = x;
+    return x;
+  }
+
+  // Assert node to be true
+  void CnfFormula::Private::assertNode(int id) {
+    const Node &node = nodes[id];
+    std::vector<int> operands;
+    switch (node.opCode) {
+      case OP_AND:
+        gather(id, OP_AND, operands);
+        for(unsigned i=0; i<operands.size(); i++)
+          assertNode(operands[i]);
+        break;
+
+      case OP_OR:
+        {
+          gather(id, OP_OR, operands);
+          TClause clause;
+          for(unsigned i=0; i<operands.size(); i++)
+            clause.push_back(encode(operands[i]));
+          clauses.push_back(clause);
+        }
+        break;
+
+      default:
+        clauses.push_back(TClause(1, encode(id)));
+    }
+  }
+
+  CnfFormula::CnfFormula(SatProblem *problem, bool polarity):
+    d(new Private)
+  {
+    d->problem = problem;
+    d->full = !polarity;
+    d->problemVars = problem->getVarsCount();
+    d->varsCount = d->problemVars;
+    d->constLit = 0;
+
+    d->readProgram(problem->getProgram());
+    d->computePolarity();
+    d->lits.resize(d->nodes.size(), 0);
+    for(unsigned i=0; i<d->roots.size(); i++)
+      d->assertNode(d->roots[i]);
+
+    if (problem->getContradictionsCount())
+      // Formula simplified to FALSE, no solution exists
+      d->clauses.push_back(TClause());
+  }
+  CnfFormula::~CnfFormula() {
+    delete d;
+  }
+  int CnfFormula::getVarsCount() const {
+    return d->varsCount;
+  }
+  int CnfFormula::getProblemVarsCount() const {
+    return d->problemVars;
+  }
+  int CnfFormula::getClausesCount() const {
+    return d->clauses.size();
+  }
+  const TClause& CnfFormula::getClause(int index) const {
+    return d->clauses[index];
+  }
+  void CnfFormula::writeDimacs(std::ostream &out) const {
+    out << "c CNF generated by fss (" << ((d->full) ? "Tseitin" : "Plaisted-Greenbaum")
+      << " encoding)" << std::endl;
+    for(int i=0; i<d->problemVars; i++)
+      out << "c var " << i+1 << " " << d->problem->getVarName(i) << std::endl;
+    out << "p cnf " << d->varsCount << " " << d->clauses.size() << std::endl;
+    std::vector<TClause>::const_iterator iter;
+    for(iter=d->clauses.begin(); iter!=d->clauses.end(); iter++) {
+      const TClause &clause = *iter;
+      for(unsigned i=0; i<clause.size(); i++)
+        out << clause[i] << " ";
+      out << "0" << std::endl;
+    }
+  }
+
+} // namespace FastSatSolver
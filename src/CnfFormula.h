@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef CNFFORMULA_H
+#define CNFFORMULA_H
+
+/**
+ * @file CnfFormula.h
+ * @brief Conversion of SAT problem to conjunctive normal form
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-13
+ * @ingroup SatProblem
+ */
+
+#include <iostream>
+#include <vector>
+
+namespace FastSatSolver {
+  class SatProblem;
+
+  /**
+   * @brief Literal in DIMACS notation - positive or negative index of
+   * variable (indexed from 1).
+   * @ingroup SatProblem
+   */
+  typedef int TLiteral;
+
+  /**
+   * @brief Clause as disjunction of literals.
+   * @ingroup SatProblem
+   */
+  typedef std::vector<TLiteral> TClause;
+
+  /**
+   * Conjunction of all formulas is encoded by Tseitin transformation, so
+   * the size of CNF is linear in size of formulas. Variable of SAT problem
+   * with index @c i is CNF variable @c i+1, auxiliary variables follow.
+   * Chains of AND/OR are encoded as n-ary gates and AND/OR on top of
+   * formulas are asserted directly (without auxiliary variable).
+   *
+   * With polarity optimization (Plaisted-Greenbaum) only implications
+   * needed by polarity of each gate are generated. Resulting CNF is
+   * equisatisfiable. Without it, each auxiliary variable is fully defined
+   * by its gate, so that count of models is preserved as well.
+   * @brief Equisatisfiable CNF of SAT problem.
+   * @ingroup SatProblem
+   */
+  class CnfFormula {
+    public:
+      /**
+       * @param problem SAT problem to convert. Its program (consider
+       * SatProblem::getProgram()) is converted, so shared subexpressions
+       * are encoded only once.
+       * @param polarity If true, Plaisted-Greenbaum encoding is used.
+       * Otherwise full Tseitin encoding is used, which preserves count of
+       * models.
+       */
+      CnfFormula(SatProblem *problem, bool polarity = true);
+      ~CnfFormula();
+
+      /**
+       * @brief @return Returns count of CNF variables (including auxiliary).
+       */
+      int getVarsCount() const;
+
+      /**
+       * @brief @return Returns count of variables of original SAT problem.
+       */
+      int getProblemVarsCount() const;
+
+      /**
+       * @brief @return Returns count of clauses.
+       */
+      int getClausesCount() const;
+
+      /**
+       * @brief @return Returns clause at desired position.
+       * @param index Index in range <0, getClausesCount()-1>.
+       */
+      const TClause& getClause(int index) const;
+
+      /**
+       * @brief Write CNF in DIMACS format. Names of original variables are
+       * written as comments (c var INDEX NAME).
+       * @param streamTo Output stream to write to.
+       */
+      void writeDimacs(std::ostream &streamTo) const;
+
+    private:
+      CnfFormula(const CnfFormula &);
+      CnfFormula& operator= (const CnfFormula &);
+      struct Private;
+      Private *d;
+  };
+
+} // namespace FastSatSolver
+
+#endif // CNFFORMULA_H
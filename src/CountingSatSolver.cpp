@@ -0,0 +1,498 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <assert.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include "fssIO.h"
+#include "SatProblem.h"
+#include "CnfFormula.h"
+#include "BigNumber.h"
+#include "CountingSatSolver.h"
+
+namespace FastSatSolver {
+
+  namespace {
+    // Literal of variable v is 2*v (positive) or 2*v+1 (negative)
+    typedef int TLit;
+    inline TLit mkLit(int var, bool neg) { return var+var+neg; }
+    inline int  litVar(TLit lit)         { return lit>>1; }
+    inline bool litNeg(TLit lit)         { return lit&1; }
+
+    const unsigned CACHE_LIMIT = 1U<<18;    // count of cached components
+
+    // Values of variables and literals
+    enum TValue {
+      V_FALSE = 0,
+      V_TRUE  = 1,
+      V_UNDEF = 2
+    };
+
+    // Component is range of variables and range of clauses on stack
+    struct Component {
+      int varsBegin;
+      int varsEnd;
+      int clausesBegin;
+      int clausesEnd;
+    };
+
+    // Sorted variables and clauses of component identify it, because
+    // assigned literals of its clauses are all false
+    typedef std::vector<int> TKey;
+    typedef std::map<TKey, BigNumber> TCache;
+  }
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // CountingSatSolver implementation
+  struct CountingSatSolver::Private {
+    struct Frame;
+
+    SatProblem                    *problem;
+    CnfFormula                    cnf;
+    int                           stepDecisions;
+    SatItemVector                 resultSet;      ///< always empty
+
+    // Clause database
+    std::vector<std::vector<TLit> > clauses;
+    std::vector<std::vector<int> > occurs;        ///< clauses indexed by literal
+    std::vector<int>              satLits;        ///< count of true literals
+    std::vector<int>              falseLits;      ///< count of false literals
+
+    // Assignment
+    std::vector<char>             assigns;
+    std::vector<TLit>             trail;
+    unsigned                      qhead;
+
+    // Stack of components, children of component being decided are on top
+    std::vector<Component>        components;
+    std::vector<int>              compVars;
+    std::vector<int>              compClauses;
+    std::vector<int>              varMark;
+    std::vector<int>              clauseMark;
+    int                           stamp;
+
+    // Stack of decisions and cache of counted components
+    std::vector<Frame>            frames;
+    TCache                        cache;
+    TKey                          key;
+
+    // Results
+    bool                          done;
+    BigNumber                     models;
+    long                          decisions;
+    long                          cacheHits;
+
+    Private(SatProblem *problem_, int stepDecisions_):
+      problem(problem_),
+      cnf(problem_, false),
+      stepDecisions(stepDecisions_)
+    {
+    }
+
+    void init();
+
+    TValue value(TLit lit) const {
+      const char val = assigns[litVar(lit)];
+      if (V_UNDEF == val)
+        return V_UNDEF;
+      return static_cast<TValue>(val ^ litNeg(lit));
+    }
+    void assign(TLit lit);
+    void undo(unsigned trailSize);
+    bool propagate();
+
+    // Split unassigned rest of component to child components
+    void decompose(Component comp, Frame &);
+    void buildKey(const Component &);
+    int pickBranchVar(const Component &);
+
+    // Decide component on top of stack, explore branch of frame
+    void decide(int comp);
+    void branch(Frame &);
+  };
+
+  /**
+   * Decision on variable of component, both its branches are explored.
+   * Count of branch is product of counts of its child components and
+   * 2^(count of variables left free by the branch).
+   */
+  struct CountingSatSolver::Private::Frame {
+    int                           comp;           ///< index of component
+    int                           var;            ///< -1 for whole problem
+    int                           branch;         ///< value of var
+    unsigned                      trailSize;      ///< trail size before decision
+    int                           childBegin;
+    int                           childNext;      ///< child to count next
+    int                           varsTop;        ///< compVars size before children
+    int                           clausesTop;
+    BigNumber                     product;        ///< count of branch (so far)
+    BigNumber                     count;          ///< count of first branch
+  };
+
+  void CountingSatSolver::Private::init() {
+    const int nVars = cnf.getVarsCount();
+    assigns.assign(nVars, V_UNDEF);
+    occurs.assign(2*nVars, std::vector<int>());
+    varMark.assign(nVars, 0);
+    trail.clear();
+    qhead = 0;
+    components.clear();
+    compVars.clear();
+    compClauses.clear();
+    frames.clear();
+    cache.clear();
+    stamp = 0;
+    done = false;
+    models = BigNumber();
+    decisions = 0;
+    cacheHits = 0;
+
+    // Load CNF of problem, remove duplicate literals and tautologies
+    clauses.clear();
+    bool ok = true;
+    const int nClauses = cnf.getClausesCount();
+    for(int i=0; i<nClauses; i++) {
+      const TClause &clause = cnf.getClause(i);
+      std::vector<TLit> lits;
+      for(unsigned j=0; j<clause.size(); j++) {
+        const TLiteral dimacs = clause[j];
+        lits.push_back((dimacs > 0)
+            ? mkLit(dimacs-1, false)
+            : mkLit(-dimacs-1, true));
+      }
+      std::sort(lits.begin(), lits.end());
+      lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+      bool tautology = false;
+      for(unsigned j=1; j<lits.size(); j++)
+        if (lits[j-1] == (lits[j]^1))
+          tautology = true;
+      if (tautology)
+        continue;
+      if (lits.empty())
+        ok = false;
+      const int index = clauses.size();
+      for(unsigned j=0; j<lits.size(); j++)
+        occurs[lits[j]].push_back(index);
+      clauses.push_back(lits);
+    }
+    satLits.assign(clauses.size(), 0);
+    falseLits.assign(clauses.size(), 0);
+    clauseMark.assign(clauses.size(), 0);
+
+    // Assign unit clauses
+    for(unsigned i=0; ok && i<clauses.size(); i++) {
+      if (1 != clauses[i].size())
+        continue;
+      const TLit lit = clauses[i][0];
+      if (V_FALSE == value(lit))
+        ok = false;
+      else if (V_UNDEF == value(lit))
+        assign(lit);
+    }
+    if (!ok || !propagate()) {
+      // No solutions
+      done = true;
+      return;
+    }
+
+    // The whole problem is the root component
+    Component root;
+    root.varsBegin = 0;
+    root.clausesBegin = 0;
+    for(int i=0; i<nVars; i++)
+      compVars.push_back(i);
+    for(unsigned i=0; i<clauses.size(); i++)
+      compClauses.push_back(i);
+    root.varsEnd = compVars.size();
+    root.clausesEnd = compClauses.size();
+    components.push_back(root);
+    frames.push_back(Frame());
+    Frame &f = frames.back();
+    f.comp = 0;
+    f.var = -1;
+    f.branch = 0;
+    f.trailSize = 0;
+    decompose(root, f);
+  }
+  void CountingSatSolver::Private::assign(TLit lit) {
+    assert(V_UNDEF == value(lit));
+    assigns[litVar(lit)] = !litNeg(lit);
+    trail.push_back(lit);
+    const std::vector<int> &sat = occurs[lit];
+    for(unsigned i=0; i<sat.size(); i++)
+      satLits[sat[i]]++;
+    const std::vector<int> &unsat = occurs[lit^1];
+    for(unsigned i=0; i<unsat.size(); i++)
+      falseLits[unsat[i]]++;
+  }
+  void CountingSatSolver::Private::undo(unsigned trailSize) {
+    while (trail.size() > trailSize) {
+      const TLit lit = trail.back();
+      trail.pop_back();
+      const std::vector<int> &sat = occurs[lit];
+      for(unsigned i=0; i<sat.size(); i++)
+        satLits[sat[i]]--;
+      const std::vector<int> &unsat = occurs[lit^1];
+      for(unsigned i=0; i<unsat.size(); i++)
+        falseLits[unsat[i]]--;
+      assigns[litVar(lit)] = V_UNDEF;
+    }
+    qhead = trail.size();
+  }
+  // Unit propagation, return false on conflict
+  bool CountingSatSolver::Private::propagate() {
+    while (qhead < trail.size()) {
+      const TLit lit = trail[qhead++];
+      const std::vector<int> &occs = occurs[lit^1];
+      for(unsigned i=0; i<occs.size(); i++) {
+        const int c = occs[i];
+        if (satLits[c])
+          continue;
+        const std::vector<TLit> &clause = clauses[c];
+        const int size = clause.size();
+        if (falseLits[c] == size)
+          return false;
+        if (falseLits[c] < size-1)
+          continue;
+
+        // Unit clause
+        for(int j=0; j<size; j++) {
+          if (V_UNDEF == value(clause[j])) {
+            assign(clause[j]);
+            break;
+          }
+        }
+      }
+    }
+    return true;
+  }
+  void CountingSatSolver::Private::decompose(Component comp, Frame &f) {
+    // Mark clauses of component not satisfied yet
+    stamp++;
+    for(int i=comp.clausesBegin; i<comp.clausesEnd; i++) {
+      const int c = compClauses[i];
+      if (!satLits[c])
+        clauseMark[c] = stamp;
+    }
+
+    // Search connected parts of the rest of component
+    int freeVars = 0;
+    f.varsTop = compVars.size();
+    f.clausesTop = compClauses.size();
+    f.childBegin = components.size();
+    f.childNext = f.childBegin;
+    for(int i=comp.varsBegin; i<comp.varsEnd; i++) {
+      const int var = compVars[i];
+      if (V_UNDEF != assigns[var] || stamp == varMark[var])
+        continue;
+      Component child;
+      child.varsBegin = compVars.size();
+      child.clausesBegin = compClauses.size();
+      varMark[var] = stamp;
+      compVars.push_back(var);
+      for(unsigned j=child.varsBegin; j<compVars.size(); j++) {
+        const int v = compVars[j];
+        for(int neg=0; neg<2; neg++) {
+          const std::vector<int> &occs = occurs[mkLit(v, neg)];
+          for(unsigned k=0; k<occs.size(); k++) {
+            const int c = occs[k];
+            if (stamp != clauseMark[c])
+              continue;
+            clauseMark[c] = 0;
+            compClauses.push_back(c);
+            const std::vector<TLit> &clause = clauses[c];
+            for(unsigned l=0; l<clause.size(); l++) {
+              const int w = litVar(clause[l]);
+              if (V_UNDEF == assigns[w] && stamp != varMark[w]) {
+                varMark[w] = stamp;
+                compVars.push_back(w);
+              }
+            }
+          }
+        }
+      }
+      child.varsEnd = compVars.size();
+      child.clausesEnd = compClauses.size();
+      if (child.clausesBegin == child.clausesEnd) {
+        // Variable is not constrained any more
+        freeVars += child.varsEnd - child.varsBegin;
+        compVars.resize(child.varsBegin);
+        continue;
+      }
+      std::sort(compVars.begin() + child.varsBegin, compVars.end());
+      std::sort(compClauses.begin() + child.clausesBegin, compClauses.end());
+      components.push_back(child);
+    }
+    f.product = BigNumber::power2(freeVars);
+  }
+  void CountingSatSolver::Private::buildKey(const Component &comp) {
+    key.assign(compVars.begin() + comp.varsBegin, compVars.begin() + comp.varsEnd);
+    key.push_back(-1);
+    key.insert(key.end(), compClauses.begin() + comp.clausesBegin, compClauses.begin() + comp.clausesEnd);
+  }
+  // Variable occurring in the most of clauses not satisfied yet
+  int CountingSatSolver::Private::pickBranchVar(const Component &comp) {
+    int best = -1;
+    int bestScore = -1;
+    for(int i=comp.varsBegin; i<comp.varsEnd; i++) {
+      const int var = compVars[i];
+      int score = 0;
+      for(int neg=0; neg<2; neg++) {
+        const std::vector<int> &occs = occurs[mkLit(var, neg)];
+        for(unsigned j=0; j<occs.size(); j++)
+          if (!satLits[occs[j]])
+            score++;
+      }
+      if (score > bestScore) {
+        best = var;
+        bestScore = score;
+      }
+    }
+    return best;
+  }
+  void CountingSatSolver::Private::decide(int comp) {
+    frames.push_back(Frame());
+    Frame &f = frames.back();
+    f.comp = comp;
+    f.var = pickBranchVar(components[comp]);
+    f.branch = 0;
+    f.trailSize = trail.size();
+    branch(f);
+  }
+  void CountingSatSolver::Private::branch(Frame &f) {
+    decisions++;
+    assign(mkLit(f.var, 0 == f.branch));
+    if (propagate()) {
+      decompose(components[f.comp], f);
+    } else {
+      // Conflict, there are no models in this branch
+      f.varsTop = compVars.size();
+      f.clausesTop = compClauses.size();
+      f.childBegin = components.size();
+      f.childNext = f.childBegin;
+      f.product = BigNumber();
+    }
+  }
+
+  CountingSatSolver::CountingSatSolver(SatProblem *problem, int stepDecisions):
+    d(new Private(problem, stepDecisions))
+  {
+    d->init();
+  }
+  CountingSatSolver::~CountingSatSolver() {
+    delete d;
+  }
+  SatProblem* CountingSatSolver::getProblem() {
+    return d->problem;
+  }
+  int CountingSatSolver::getSolutionsCount() {
+    return 0;
+  }
+  SatItemVector* CountingSatSolver::getSolutionVector() {
+    return new SatItemVector(d->resultSet);
+  }
+  float CountingSatSolver::minFitness() {
+    return 0.0;
+  }
+  float CountingSatSolver::avgFitness() {
+    return 0.0;
+  }
+  float CountingSatSolver::maxFitness() {
+    return (d->done && !d->models.isZero())
+      ? 1.0
+      : 0.0;
+  }
+  const BigNumber& CountingSatSolver::getModelsCount() {
+    return d->models;
+  }
+  bool CountingSatSolver::isExhausted() {
+    return d->done;
+  }
+  long CountingSatSolver::getDecisionsCount() {
+    return d->decisions;
+  }
+  long CountingSatSolver::getCacheHitsCount() {
+    return d->cacheHits;
+  }
+  // protected
+  void CountingSatSolver::initialize() {
+    d->init();
+  }
+  // protected
+  void CountingSatSolver::doStep() {
+    for(int stepDecisions=0; !d->done && stepDecisions < d->stepDecisions; ) {
+      Private::Frame &f = d->frames.back();
+      const int childEnd = d->components.size();
+      if (f.childNext < childEnd && !f.product.isZero()) {
+        // Count next child component
+        const int comp = f.childNext++;
+        d->buildKey(d->components[comp]);
+        TCache::const_iterator it = d->cache.find(d->key);
+        if (d->cache.end() != it) {
+          d->cacheHits++;
+          f.product *= it->second;
+          continue;
+        }
+        d->decide(comp);
+        stepDecisions++;
+        continue;
+      }
+
+      // Branch is complete
+      d->undo(f.trailSize);
+      d->components.resize(f.childBegin);
+      d->compVars.resize(f.varsTop);
+      d->compClauses.resize(f.clausesTop);
+      if (f.var < 0) {
+        // The whole problem is counted
+        d->models = f.product;
+        d->done = true;
+        break;
+      }
+      if (0 == f.branch) {
+        // Explore the second branch
+        f.count = f.product;
+        f.branch = 1;
+        d->branch(f);
+        stepDecisions++;
+        continue;
+      }
+
+      // Both branches are complete, cache count of component
+      f.count += f.product;
+      d->buildKey(d->components[f.comp]);
+      if (d->cache.size() >= CACHE_LIMIT)
+        d->cache.clear();
+      d->cache[d->key] = f.count;
+      const BigNumber count = f.count;
+      d->frames.pop_back();
+      d->frames.back().product *= count;
+    }
+
+    if (d->done) {
+      if (!d->models.isZero())
+        // Problem is satisfiable
+        this->notify();
+      this->stop();
+    }
+  }
+
+} // namespace FastSatSolver
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef COUNTINGSATSOLVER_H
+#define COUNTINGSATSOLVER_H
+
+/**
+ * @file CountingSatSolver.h
+ * @brief CountingSatSolver class counting all solutions of SAT problem.
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-18
+ * @ingroup SatSolver
+ */
+
+#include "SatSolver.h"
+
+namespace FastSatSolver {
+  class BigNumber;
+  class SatProblem;
+
+  /**
+   * Solver works on CNF of SAT problem encoded by full Tseitin
+   * transformation (consider CnfFormula), which preserves count of models.
+   * It searches the space of assignments depth-first. After each decision
+   * and unit propagation the rest of formula is split into components
+   * (sets of clauses which do not share variables), which are counted
+   * independently, and their counts are multiplied. Counts of components
+   * are cached, so that the same component is never counted twice.
+   * Solutions are never materialized, count of models is kept as BigNumber.
+   * @brief Complete solver counting all solutions (\#SAT).
+   * @ingroup SatSolver
+   */
+  class CountingSatSolver: public AbstractSatSolver
+  {
+    public:
+      /**
+       * @param problem SatProblem instance containing SAT problem to solve.
+       * @param stepDecisions Maximal count of decisions in one step. This
+       * influences the granullarity of notifications and process control.
+       */
+      CountingSatSolver(SatProblem *problem, int stepDecisions);
+      virtual ~CountingSatSolver();
+      virtual SatProblem* getProblem();
+
+      /**
+       * @brief @return Returns always 0, solutions are not materialized.
+       * @note Consider getModelsCount().
+       */
+      virtual int getSolutionsCount();
+
+      /**
+       * @brief @return Returns always empty vector, solutions are not
+       * materialized.
+       */
+      virtual SatItemVector* getSolutionVector();
+
+      /**
+       * @brief Fitness is not evaluated while counting, maxFitness() is 1.0
+       * once problem is known to be satisfiable.
+       */
+      virtual float minFitness();
+      virtual float avgFitness();
+      virtual float maxFitness();
+
+      /**
+       * @brief @return Returns exact count of solutions. It is valid only
+       * if isExhausted() returns true.
+       */
+      const BigNumber& getModelsCount();
+
+      /**
+       * @brief @return Returns true if counting is complete.
+       */
+      bool isExhausted();
+
+      /**
+       * @brief @return Returns count of decisions since initialization.
+       */
+      long getDecisionsCount();
+
+      /**
+       * @brief @return Returns count of components, whose count was found
+       * in cache.
+       */
+      long getCacheHitsCount();
+
+    protected:
+      virtual void initialize();
+      virtual void doStep();
+
+    private:
+      struct Private;
+      Private *d;
+  };
+
+} // namespace FastSatSolver
+
+#endif // COUNTINGSATSOLVER_H
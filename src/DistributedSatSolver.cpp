@@ -0,0 +1,756 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <netdb.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include "fssIO.h"
+#include "SatProblem.h"
+#include "DistributedSatSolver.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace FastSatSolver {
+
+  namespace {
+    const int POLL_MS = 100;              ///< max. period of notifications
+    const int LISTEN_BACKLOG = 16;
+    const int CONNECT_RETRIES = 10;       ///< coordinator may not listen yet
+    const unsigned CONNECT_DELAY = 1;     ///< in seconds
+    const unsigned MAX_LINE = 1<<16;
+    const char UNIX_PREFIX[] = "unix:";
+    const double LEASE_SLACK = 4.0;       ///< lease may take this times longer than expected
+    const long MIN_LEASE_MS = 10000;      ///< the shortest deadline of lease
+
+    long now() {
+      struct timeval tv;
+      gettimeofday(&tv, 0);
+      return tv.tv_sec * 1000L + tv.tv_usec / 1000L;
+    }
+
+    // Open socket listening on (or connected to) address, return -1 on
+    // failure (errno is set then)
+    int openSocket(const std::string &address, bool server) {
+      const size_t prefixLength = sizeof(UNIX_PREFIX) - 1;
+      if (0 == address.compare(0, prefixLength, UNIX_PREFIX)) {
+        // Unix domain socket
+        const std::string path = address.substr(prefixLength);
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof addr);
+        addr.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof addr.sun_path)
+          throw GenericException("Invalid socket path '" + path + "'");
+        strcpy(addr.sun_path, path.c_str());
+
+        const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0)
+          return -1;
+        struct sockaddr *sa = reinterpret_cast<struct sockaddr *>(&addr);
+        bool ok;
+        if (server) {
+          // Remove socket left by previous coordinator
+          struct stat st;
+          if (0 == stat(path.c_str(), &st) && S_ISSOCK(st.st_mode))
+            unlink(path.c_str());
+          ok = 0 == bind(fd, sa, sizeof addr)
+            && 0 == listen(fd, LISTEN_BACKLOG);
+        } else {
+          ok = 0 == connect(fd, sa, sizeof addr);
+        }
+        if (!ok) {
+          const int error = errno;
+          close(fd);
+          errno = error;
+          return -1;
+        }
+        return fd;
+      }
+
+      // TCP socket given by [HOST:]PORT
+      std::string host, port = address;
+      const std::string::size_type colon = address.rfind(':');
+      if (std::string::npos != colon) {
+        host = address.substr(0, colon);
+        port = address.substr(colon + 1);
+      }
+      if (host.empty() && !server)
+        host = "localhost";
+      struct addrinfo hints;
+      memset(&hints, 0, sizeof hints);
+      hints.ai_family = AF_UNSPEC;
+      hints.ai_socktype = SOCK_STREAM;
+      if (server)
+        hints.ai_flags = AI_PASSIVE;
+      struct addrinfo *list;
+      if (0!= getaddrinfo((host.empty()) ? 0 : host.c_str(), port.c_str(), &hints, &list))
+        throw GenericException("Invalid address '" + address + "'");
+      int fd = -1;
+      int error = 0;
+      for(struct addrinfo *ai = list; ai && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) {
+          error = errno;
+          continue;
+        }
+        bool ok;
+        if (server) {
+          const int yes = 1;
+          setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof yes);
+          ok = 0 == bind(fd, ai->ai_addr, ai->ai_addrlen)
+            && 0 == listen(fd, LISTEN_BACKLOG);
+        } else {
+          ok = 0 == connect(fd, ai->ai_addr, ai->ai_addrlen);
+        }
+        if (!ok) {
+          error = errno;
+          close(fd);
+          fd = -1;
+        }
+      }
+      freeaddrinfo(list);
+      if (fd < 0)
+        errno = error;
+      return fd;
+    }
+
+    // Write whole text to socket, return false on failure
+    bool sendText(int fd, const std::string &text) {
+      const char *data = text.data();
+      size_t size = text.size();
+      while (size) {
+        const ssize_t written = send(fd, data, size, MSG_NOSIGNAL);
+        if (written < 0 && EINTR == errno)
+          continue;
+        if (written <= 0)
+          return false;
+        data += written;
+        size -= written;
+      }
+      return true;
+    }
+
+    // Read what is available to buffer, return false on EOF or failure
+    bool receive(int fd, std::string &buffer) {
+      char data[4096];
+      ssize_t size;
+      do
+        size = recv(fd, data, sizeof data, 0);
+      while (size < 0 && EINTR == errno);
+      if (size <= 0)
+        return false;
+      buffer.append(data, size);
+      return true;
+    }
+
+    // Take the first complete line from buffer (without newline)
+    bool takeLine(std::string &buffer, std::string &line) {
+      const std::string::size_type newline = buffer.find('\n');
+      if (std::string::npos == newline)
+        return false;
+      line = buffer.substr(0, newline);
+      buffer.erase(0, newline + 1);
+      return true;
+    }
+
+    // Number of assignment given by item
+    BigNumber itemNumber(const ISatItem *item) {
+      BigNumber number;
+      for(int i=0; i<item->getLength(); i++)
+        if (item->getBit(i))
+          number.setBit(i);
+      return number;
+    }
+  }
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // DistributedSatSolver::Private declaration
+  struct DistributedSatSolver::Private {
+    struct Peer;
+    typedef std::pair<BigNumber, BigNumber> TLease;
+
+    SatProblem                *problem;
+    BlindSatSolver::Mode      mode;
+    int                       leaseBits;
+    int                       listenFd;
+    std::string               unixPath;     ///< removed by destructor
+    std::vector<Peer *>       peers;
+
+    // Leases not explored yet
+    BigNumber                 space;        ///< count of all assignments
+    BigNumber                 next;         ///< the first lease never issued
+    std::vector<TLease>       requeued;     ///< leases of dead or late workers
+    int                       reissued;
+
+    // Throughput of workers observed on leases done in time
+    double                    doneCount;    ///< assignments explored
+    double                    doneMs;       ///< time spent on them
+
+    // Re-issue leases of workers exceeding deadline given by throughput
+    void expireLeases();
+
+    // Merged results of leases done
+    BigNumber                 current;      ///< count of explored assignments
+    SatItemSet                resultSet;
+    float                     minFitness;
+    float                     maxFitness;
+    double                    sumFitness;
+
+    Private(SatProblem *problem_, BlindSatSolver::Mode mode_, int leaseBits_);
+    ~Private();
+    void acceptPeer();
+    void closePeer(Peer *);
+    void closePeers();
+
+    // Process one message of peer, return false if peer should be closed
+    bool handleLine(Peer *, const std::string &line);
+    bool handleHello(Peer *, std::istream &);
+    bool handleDone(Peer *, std::istream &);
+    bool refuse(Peer *, const std::string &reason);
+
+    // Hand out leases to all idle workers
+    void dispatch();
+  };
+
+  /**
+   * Solutions of lease are kept by peer until the lease is reported done.
+   */
+  struct DistributedSatSolver::Private::Peer {
+    int                       fd;
+    std::string               buffer;       ///< incomplete line received
+    bool                      ready;        ///< HELLO accepted
+    bool                      busy;         ///< exploring lease
+    bool                      dead;         ///< to be closed
+    bool                      late;         ///< lease re-issued after deadline
+    TLease                    lease;
+    long                      issued;       ///< time of LEASE in ms
+    std::vector<BigNumber>    solutions;
+
+    Peer(int fd_):
+      fd(fd_),
+      ready(false),
+      busy(false),
+      dead(false),
+      late(false),
+      issued(0)
+    {
+    }
+  };
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // DistributedSatSolver::Private implementation
+  DistributedSatSolver::Private::Private(SatProblem *problem_, BlindSatSolver::Mode mode_, int leaseBits_):
+    problem(problem_),
+    mode(mode_),
+    leaseBits(std::min(leaseBits_, problem_->getVarsCount())),
+    listenFd(-1),
+    space(BigNumber::power2(problem_->getVarsCount())),
+    reissued(0),
+    doneCount(0.0),
+    doneMs(0.0)
+  {
+  }
+  DistributedSatSolver::Private::~Private() {
+    this->closePeers();
+    if (0 <= listenFd)
+      close(listenFd);
+    if (!unixPath.empty())
+      unlink(unixPath.c_str());
+  }
+  void DistributedSatSolver::Private::acceptPeer() {
+    const int fd = accept(listenFd, 0, 0);
+    if (fd < 0)
+      return;
+    // Detect workers on dead machines as well
+    const int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &yes, sizeof yes);
+    peers.push_back(new Peer(fd));
+  }
+  void DistributedSatSolver::Private::closePeer(Peer *peer) {
+    if (peer->busy && !peer->late) {
+      // Lease will be explored by another worker
+      requeued.push_back(peer->lease);
+      reissued++;
+    }
+    close(peer->fd);
+    delete peer;
+  }
+  void DistributedSatSolver::Private::closePeers() {
+    for(unsigned i=0; i<peers.size(); i++)
+      this->closePeer(peers[i]);
+    peers.clear();
+  }
+  bool DistributedSatSolver::Private::handleLine(Peer *peer, const std::string &line) {
+    std::istringstream stream(line);
+    std::string command;
+    stream >> command;
+    if (command == "HELLO" && !peer->ready)
+      return this->handleHello(peer, stream);
+    if (command == "SOLUTION" && peer->busy) {
+      std::string text;
+      stream >> text;
+      BigNumber number;
+      if (!number.fromString(text) || number >= space)
+        return this->refuse(peer, "invalid solution");
+      peer->solutions.push_back(number);
+      return true;
+    }
+    if (command == "DONE" && peer->busy)
+      return this->handleDone(peer, stream);
+    return this->refuse(peer, "unexpected message");
+  }
+  bool DistributedSatSolver::Private::handleHello(Peer *peer, std::istream &stream) {
+    int vars = -1, formulas = -1, workerMode = -1, chunkBits = -1;
+    stream >> vars >> formulas >> workerMode >> chunkBits;
+    if (vars != problem->getVarsCount() || formulas != problem->getFormulasCount())
+      return this->refuse(peer, "different SAT problem");
+    if (workerMode != mode)
+      return this->refuse(peer, "different mode of blind solver");
+    if (chunkBits < 0 || (leaseBits < chunkBits && leaseBits < vars))
+      return this->refuse(peer, "lease too small for step_width of worker");
+    peer->ready = true;
+    return true;
+  }
+  bool DistributedSatSolver::Private::handleDone(Peer *peer, std::istream &stream) {
+    std::string text;
+    float min, avg, max;
+    stream >> text >> min >> avg >> max;
+    BigNumber explored;
+    if (!stream || !explored.fromString(text)
+        || explored != peer->lease.second - peer->lease.first)
+      return this->refuse(peer, "lease not explored");
+    peer->busy = false;
+    if (peer->late) {
+      // Result counts only if the re-issued lease is not taken yet
+      peer->late = false;
+      std::vector<TLease>::iterator it=
+        std::find(requeued.begin(), requeued.end(), peer->lease);
+      if (requeued.end() == it) {
+        peer->solutions.clear();
+        return true;
+      }
+      requeued.erase(it);
+    } else {
+      doneCount += explored.toDouble();
+      doneMs += now() - peer->issued;
+    }
+
+    // Merge statistics of lease
+    if (!explored.isZero()) {
+      minFitness = std::min(minFitness, min);
+      maxFitness = std::max(maxFitness, max);
+      sumFitness += avg * explored.toDouble();
+    }
+    current += explored;
+
+    // Merge solutions of lease
+    const int nVars = problem->getVarsCount();
+    for(unsigned i=0; i<peer->solutions.size(); i++)
+      resultSet.addItem(new PackedSatItem(nVars, peer->solutions[i]));
+    peer->solutions.clear();
+    return true;
+  }
+  bool DistributedSatSolver::Private::refuse(Peer *peer, const std::string &reason) {
+    sendText(peer->fd, "ERROR " + reason + "\n");
+    return false;
+  }
+  void DistributedSatSolver::Private::dispatch() {
+    for(unsigned i=0; i<peers.size(); i++) {
+      Peer *peer = peers[i];
+      if (!peer->ready || peer->busy || peer->dead)
+        continue;
+      if (!requeued.empty()) {
+        peer->lease = requeued.back();
+        requeued.pop_back();
+      } else if (next < space) {
+        BigNumber to = next;
+        to.addPower2(leaseBits);
+        peer->lease = TLease(next, std::min(to, space));
+        next = peer->lease.second;
+      } else {
+        // Wait for leases of other workers (they could die)
+        continue;
+      }
+      peer->busy = true;
+      peer->issued = now();
+      std::ostringstream line;
+      line << "LEASE " << peer->lease.first.toString()
+        << " " << peer->lease.second.toString() << "\n";
+      if (!sendText(peer->fd, line.str()))
+        peer->dead = true;
+    }
+  }
+  void DistributedSatSolver::Private::expireLeases() {
+    if (doneCount <= 0.0)
+      // Nothing to estimate deadline by
+      return;
+    const long time = now();
+    for(unsigned i=0; i<peers.size(); i++) {
+      Peer *peer = peers[i];
+      if (!peer->busy || peer->late)
+        continue;
+      const double size = (peer->lease.second - peer->lease.first).toDouble();
+      const double deadline = std::max<double>(MIN_LEASE_MS,
+          LEASE_SLACK * size * doneMs / doneCount);
+      if (time - peer->issued < deadline)
+        continue;
+
+      // Worker is hung (or too slow), lease will be explored by another one
+      requeued.push_back(peer->lease);
+      reissued++;
+      peer->late = true;
+    }
+  }
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // DistributedSatSolver implementation
+  DistributedSatSolver::DistributedSatSolver(SatProblem *problem, const std::string &address, BlindSatSolver::Mode mode, int leaseBits):
+    d(new Private(problem, mode, leaseBits))
+  {
+    d->listenFd = openSocket(address, true);
+    if (d->listenFd < 0) {
+      const std::string reason = strerror(errno);
+      delete d;
+      throw GenericException("Cannot listen on '" + address + "': " + reason);
+    }
+    if (0 == address.compare(0, sizeof(UNIX_PREFIX) - 1, UNIX_PREFIX))
+      d->unixPath = address.substr(sizeof(UNIX_PREFIX) - 1);
+    this->initialize();
+  }
+  DistributedSatSolver::~DistributedSatSolver() {
+    delete d;
+  }
+  SatProblem* DistributedSatSolver::getProblem() {
+    return d->problem;
+  }
+  int DistributedSatSolver::getSolutionsCount() {
+    return d->resultSet.getLength();
+  }
+  SatItemVector* DistributedSatSolver::getSolutionVector() {
+    return d->resultSet.createVector();
+  }
+  float DistributedSatSolver::minFitness() {
+    return d->minFitness;
+  }
+  float DistributedSatSolver::avgFitness() {
+    return d->sumFitness / d->current.toDouble();
+  }
+  float DistributedSatSolver::maxFitness() {
+    return d->maxFitness;
+  }
+  double DistributedSatSolver::getProgress() {
+    return d->current.toDouble() / d->space.toDouble();
+  }
+  bool DistributedSatSolver::isExhausted() {
+    return d->current >= d->space;
+  }
+  int DistributedSatSolver::getWorkersCount() {
+    return d->peers.size();
+  }
+  int DistributedSatSolver::getReissuedCount() {
+    return d->reissued;
+  }
+  // protected
+  void DistributedSatSolver::initialize() {
+    // Leases of previous run are not valid any more
+    d->closePeers();
+    d->next = BigNumber();
+    d->requeued.clear();
+    d->reissued = 0;
+    d->doneCount = 0.0;
+    d->doneMs = 0.0;
+    d->current = BigNumber();
+    d->resultSet.clear();
+    d->minFitness = INFINITY;
+    d->maxFitness = 0.0;
+    d->sumFitness = 0.0;
+  }
+  // protected
+  void DistributedSatSolver::doStep() {
+    std::vector<Private::Peer *> &peers = d->peers;
+    std::vector<struct pollfd> fds(peers.size() + 1);
+    fds[0].fd = d->listenFd;
+    fds[0].events = POLLIN;
+    for(unsigned i=0; i<peers.size(); i++) {
+      fds[i+1].fd = peers[i]->fd;
+      fds[i+1].events = POLLIN;
+    }
+    if (poll(&fds[0], fds.size(), POLL_MS) < 0 && EINTR != errno)
+      throw GenericException(std::string("poll() failed: ") + strerror(errno));
+
+    // Read messages of workers
+    const int solutionsBefore = d->resultSet.getLength();
+    const float fitnessBefore = d->maxFitness;
+    for(unsigned i=0; i<peers.size(); i++) {
+      Private::Peer *peer = peers[i];
+      if (!fds[i+1].revents)
+        continue;
+      if (!receive(peer->fd, peer->buffer)) {
+        peer->dead = true;
+        continue;
+      }
+      std::string line;
+      while (!peer->dead && takeLine(peer->buffer, line))
+        peer->dead = !d->handleLine(peer, line);
+      if (MAX_LINE < peer->buffer.size())
+        peer->dead = true;
+    }
+
+    // Close dead workers
+    std::vector<Private::Peer *> alive;
+    for(unsigned i=0; i<peers.size(); i++) {
+      if (peers[i]->dead)
+        d->closePeer(peers[i]);
+      else
+        alive.push_back(peers[i]);
+    }
+    peers.swap(alive);
+    if (fds[0].revents & POLLIN)
+      d->acceptPeer();
+
+    if (d->maxFitness > fitnessBefore)
+      this->notify();
+    for(int i=solutionsBefore; i<d->resultSet.getLength(); i++)
+      this->notify();
+
+    if (this->isExhausted()) {
+      // all space explored
+      for(unsigned i=0; i<peers.size(); i++)
+        sendText(peers[i]->fd, "QUIT\n");
+      this->stop();
+      return;
+    }
+    d->expireLeases();
+    d->dispatch();
+  }
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // DistributedWorker::Private declaration
+  struct DistributedWorker::Private {
+    struct Watch;
+
+    BlindSatSolver            *solver;
+    std::string               address;
+    int                       fd;
+    std::string               buffer;       ///< incomplete line received
+    Watch                     *watch;
+    bool                      lost;         ///< connection closed by coordinator
+
+    // Merged results of leases done
+    int                       leases;
+    BigNumber                 explored;
+    SatItemSet                resultSet;
+    float                     minFitness;
+    float                     maxFitness;
+    double                    sumFitness;
+
+    Private(BlindSatSolver *solver_, const std::string &address_);
+    ~Private();
+    void disconnect();
+    void connectTo();
+    void explore(const BigNumber &from, const BigNumber &to);
+  };
+
+  /**
+   * Watch observes solver exploring lease and stops it if coordinator
+   * closes connection. Coordinator sends nothing to busy worker.
+   */
+  struct DistributedWorker::Private::Watch: public IObserver {
+    Private                   *d;
+
+    Watch(Private *d_): d(d_) { }
+    virtual void notify() {
+      struct pollfd pfd;
+      pfd.fd = d->fd;
+      pfd.events = POLLIN;
+      if (poll(&pfd, 1, 0) <= 0)
+        return;
+      char c;
+      if (recv(d->fd, &c, 1, MSG_PEEK) <= 0) {
+        d->lost = true;
+        d->solver->stop();
+      }
+    }
+  };
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // DistributedWorker::Private implementation
+  DistributedWorker::Private::Private(BlindSatSolver *solver_, const std::string &address_):
+    solver(solver_),
+    address(address_),
+    fd(-1),
+    watch(new Watch(this)),
+    lost(false),
+    leases(0),
+    minFitness(INFINITY),
+    maxFitness(0.0),
+    sumFitness(0.0)
+  {
+    solver->addObserver(watch);
+  }
+  DistributedWorker::Private::~Private() {
+    this->disconnect();
+    delete solver;
+    delete watch;
+  }
+  void DistributedWorker::Private::disconnect() {
+    if (fd < 0)
+      return;
+    close(fd);
+    fd = -1;
+    buffer.clear();
+  }
+  void DistributedWorker::Private::connectTo() {
+    for(int i=0; fd < 0; i++) {
+      fd = openSocket(address, false);
+      if (fd < 0 && CONNECT_RETRIES <= i + 1)
+        throw GenericException("Cannot connect to '" + address + "': " + strerror(errno));
+      if (fd < 0)
+        sleep(CONNECT_DELAY);
+    }
+    SatProblem *problem = solver->getProblem();
+    std::ostringstream line;
+    line << "HELLO " << problem->getVarsCount() << " " << problem->getFormulasCount()
+      << " " << solver->getMode() << " " << solver->getChunkBits() << "\n";
+    if (!sendText(fd, line.str()))
+      this->disconnect();
+  }
+  void DistributedWorker::Private::explore(const BigNumber &from, const BigNumber &to) {
+    solver->setRange(from, to);
+    solver->reset();
+    lost = false;
+    solver->start();
+    if (lost) {
+      this->disconnect();
+      return;
+    }
+
+    // Report solutions and statistics of lease at once
+    std::ostringstream text;
+    text.precision(9);
+    SatItemVector *vect = solver->getSolutionVector();
+    for(int i=0; i<vect->getLength(); i++) {
+      const ISatItem *item = vect->getItem(i);
+      text << "SOLUTION " << itemNumber(item).toString() << "\n";
+      resultSet.addItem(item->clone());
+    }
+    delete vect;
+    const BigNumber count = to - from;
+    text << "DONE " << count.toString() << " " << solver->minFitness()
+      << " " << solver->avgFitness() << " " << solver->maxFitness() << "\n";
+    if (!count.isZero()) {
+      minFitness = std::min(minFitness, solver->minFitness());
+      maxFitness = std::max(maxFitness, solver->maxFitness());
+      sumFitness += solver->avgFitness() * count.toDouble();
+    }
+    explored += count;
+    leases++;
+    if (!sendText(fd, text.str()))
+      this->disconnect();
+  }
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // DistributedWorker implementation
+  DistributedWorker::DistributedWorker(BlindSatSolver *solver, const std::string &address):
+    d(new Private(solver, address))
+  {
+  }
+  DistributedWorker::~DistributedWorker() {
+    delete d;
+  }
+  SatProblem* DistributedWorker::getProblem() {
+    return d->solver->getProblem();
+  }
+  int DistributedWorker::getSolutionsCount() {
+    return d->resultSet.getLength();
+  }
+  SatItemVector* DistributedWorker::getSolutionVector() {
+    return d->resultSet.createVector();
+  }
+  float DistributedWorker::minFitness() {
+    return d->minFitness;
+  }
+  float DistributedWorker::avgFitness() {
+    return d->sumFitness / d->explored.toDouble();
+  }
+  float DistributedWorker::maxFitness() {
+    return d->maxFitness;
+  }
+  int DistributedWorker::getLeasesCount() {
+    return d->leases;
+  }
+  // protected
+  void DistributedWorker::initialize() {
+    d->disconnect();
+    d->leases = 0;
+    d->explored = BigNumber();
+    d->resultSet.clear();
+    d->minFitness = INFINITY;
+    d->maxFitness = 0.0;
+    d->sumFitness = 0.0;
+    d->connectTo();
+  }
+  // protected
+  void DistributedWorker::doStep() {
+    std::string line;
+    while (0 <= d->fd && !takeLine(d->buffer, line))
+      if (!receive(d->fd, d->buffer))
+        d->disconnect();
+    if (d->fd < 0) {
+      // Coordinator is gone
+      this->stop();
+      return;
+    }
+
+    std::istringstream stream(line);
+    std::string command;
+    stream >> command;
+    if (command == "LEASE") {
+      std::string from, to;
+      stream >> from >> to;
+      BigNumber numFrom, numTo;
+      if (!numFrom.fromString(from) || !numTo.fromString(to))
+        throw GenericException("Invalid lease received from coordinator");
+      d->explore(numFrom, numTo);
+      if (d->fd < 0)
+        this->stop();
+    } else if (command == "QUIT") {
+      d->disconnect();
+      this->stop();
+    } else if (command == "ERROR") {
+      std::string reason;
+      std::getline(stream, reason);
+      throw GenericException("Refused by coordinator:" + reason);
+    } else {
+      throw GenericException("Unexpected message from coordinator");
+    }
+  }
+
+} // namespace FastSatSolver
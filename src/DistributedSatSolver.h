@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef DISTRIBUTEDSATSOLVER_H
+#define DISTRIBUTEDSATSOLVER_H
+
+/**
+ * @file DistributedSatSolver.h
+ * @brief Blind search split among worker processes over sockets.
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-21
+ * @ingroup SatSolver
+ */
+
+#include <string>
+#include "SatSolver.h"
+#include "BlindSatSolver.h"
+
+namespace FastSatSolver {
+  class SatProblem;
+
+  /**
+   * Coordinator listens on socket given by address - @b unix:PATH for Unix
+   * domain socket, @b [HOST:]PORT for TCP. Space of assignments is split
+   * to leases of 2^leaseBits assignments, which are handed out to connected
+   * workers (see DistributedWorker). Solutions and statistics of lease are
+   * merged once the worker reports the lease done. Lease of worker, which
+   * disconnects before, is re-issued to another worker (and its solutions
+   * are thrown away). So is lease of connected worker, which does not
+   * report it done in 4 times the time expected by throughput observed on
+   * leases done so far (10 s at least). Result of such lease reported late
+   * is ignored, unless the re-issued lease still waits for another worker.
+   * Coordinator itself explores no assignments.
+   * Text protocol (one message per line):
+   * - worker: HELLO vars formulas mode chunkBits
+   * - coordinator: LEASE from to
+   * - worker: SOLUTION number (zero or more times)
+   * - worker: DONE explored minFitness avgFitness maxFitness
+   * - coordinator: QUIT (or ERROR text)
+   * @attention Workers have to solve the same input with the same mode
+   * of blind solver, only counts of variables and formulas are checked.
+   * @brief Coordinator of blind search distributed among processes.
+   * @ingroup SatSolver
+   */
+  class DistributedSatSolver:
+    public AbstractSatSolver,
+    public IProgressIndicator
+  {
+    public:
+      /**
+       * @param problem SatProblem instance containing SAT problem to solve.
+       * @param address Address to listen on.
+       * @param mode Order in which workers explore assignments.
+       * @param leaseBits Binary logarithm of count of assignments in one
+       * lease. It has to be at least chunk bits of workers' solvers.
+       */
+      DistributedSatSolver(
+                           SatProblem           *problem,
+                           const std::string    &address,
+                           BlindSatSolver::Mode mode,
+                           int                  leaseBits);
+      virtual ~DistributedSatSolver();
+      virtual SatProblem* getProblem();
+      virtual int getSolutionsCount();
+      virtual SatItemVector* getSolutionVector();
+      virtual float minFitness();
+      virtual float avgFitness();
+      virtual float maxFitness();
+
+      /**
+       * @brief @return Returns count of assignments explored by workers
+       * divided by count of all assignments.
+       */
+      virtual double getProgress();
+
+      /**
+       * @brief @return Returns true if whole space of assignments has been
+       * explored by workers.
+       */
+      bool isExhausted();
+
+      /**
+       * @brief @return Returns count of workers connected.
+       */
+      int getWorkersCount();
+
+      /**
+       * @brief @return Returns count of leases re-issued, because their
+       * workers disconnected or exceeded deadline.
+       */
+      int getReissuedCount();
+
+    protected:
+      virtual void initialize();
+      virtual void doStep();
+
+    private:
+      struct Private;
+      Private *d;
+  };
+
+  /**
+   * Worker connects to DistributedSatSolver at address given (see there)
+   * and explores leases by its BlindSatSolver. One step of worker explores
+   * one lease. Worker stops when coordinator has no more leases or closes
+   * connection. Exploration of lease is cancelled as soon as the connection
+   * is closed.
+   * @brief Worker process of distributed blind search.
+   * @ingroup SatSolver
+   */
+  class DistributedWorker: public AbstractSatSolver
+  {
+    public:
+      /**
+       * @param solver Blind solver exploring leases.
+       * @param address Address of coordinator.
+       * @attention On heap allocated solver is expected. It will be deleted
+       * by worker's destructor.
+       */
+      DistributedWorker(BlindSatSolver *solver, const std::string &address);
+      virtual ~DistributedWorker();
+      virtual SatProblem* getProblem();
+      virtual int getSolutionsCount();
+      virtual SatItemVector* getSolutionVector();
+      virtual float minFitness();
+      virtual float avgFitness();
+      virtual float maxFitness();
+
+      /**
+       * @brief @return Returns count of leases explored.
+       */
+      int getLeasesCount();
+
+    protected:
+      /**
+       * @brief Connect to coordinator (and forget results of previous run).
+       */
+      virtual void initialize();
+      virtual void doStep();
+
+    private:
+      struct Private;
+      Private *d;
+  };
+
+} // namespace FastSatSolver
+
+#endif // DISTRIBUTEDSATSOLVER_H
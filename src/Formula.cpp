@@ -21,18 +21,15 @@
 #include <iostream>
 #include <sstream>
 #include <vector>
-#include <stack>
-#include <list>
 #include "fssIO.h"
 #include "SatSolver.h"
 #include "Formula.h"
+#include "FormulaCode.h"
 
 using std::string;
 
 namespace FastSatSolver {
 
-  typedef std::stack<bool> TRuntimeStack;
-
   /**
    * @brief Precedence table size (2 dimensional table)
    */
@@ -149,120 +146,35 @@ namespace FastSatSolver {
       TContainer container_;
   };
 
-  class Cmd {
-    public:
-      static Cmd* fromToken(Token token);
-      virtual ~Cmd() { }
-      virtual void execute(TRuntimeStack *, ISatItem *) = 0;
-    protected:
-      Cmd() { }
-  };
-  class CmdConstant: public Cmd {
-    public:
-      CmdConstant(bool value): b(value) { }
-      virtual void execute(TRuntimeStack *stack, ISatItem *) {
-        stack->push(b);
-      }
-    private:
-      bool b;
-  };
-  class CmdVariable: public Cmd {
-    public:
-      CmdVariable(int varId): id(varId) { }
-      virtual void execute(TRuntimeStack *stack, ISatItem *data) {
-        assert(id >= 0);
-        assert(id < data->getLength());
-        bool b = data->getBit(id);
-        stack->push(b);
-      }
-    private:
-      int id;
-  };
-  class CmdUnaryNot: public Cmd {
-    public:
-      virtual void execute(TRuntimeStack *stack, ISatItem *) {
-        assert(!stack->empty());
-        bool b = stack->top();
-        stack->pop();
-        stack->push(!b);
-      }
-  };
-  class CmdBinary: public Cmd {
-    public:
-      CmdBinary(EToken e): et(e) { }
-      virtual void execute(TRuntimeStack *stack, ISatItem *) {
-        assert(!stack->empty());
-        bool a = stack->top();
-        stack->pop();
-
-        assert(!stack->empty());
-        bool b = stack->top();
-        stack->pop();
-
-        bool c;
-        switch (et) {
-          case T_AND: c = a & b; break;
-          case T_OR:  c = a | b; break;
-          case T_XOR: c = a ^ b; break;
-          default:
-            {
-              std::ostringstream stream;
-              stream << "CmdBinary::execute(): unknown token: " << et;
-              throw GenericException(stream.str());
-            }
-        }
-        stack->push(c);
-      }
-    private:
-      EToken et;
-  };
-  Cmd* Cmd::fromToken(Token token) {
+  inline EOpCode opCodeFromToken(Token token) {
     switch (token.m_token) {
-      case T_FALSE:       return new CmdConstant(false);
-      case T_TRUE:        return new CmdConstant(true);
-      case T_VARIABLE:    return new CmdVariable(token.m_ext_number);
-      case T_NOT:         return new CmdUnaryNot;
-      case T_AND:
-      case T_OR:
-      case T_XOR:
-                          return new CmdBinary(token.m_token);
+      case T_FALSE:       return OP_FALSE;
+      case T_TRUE:        return OP_TRUE;
+      case T_VARIABLE:    return OP_VAR;
+      case T_NOT:         return OP_NOT;
+      case T_AND:         return OP_AND;
+      case T_OR:          return OP_OR;
+      case T_XOR:         return OP_XOR;
       default:
                           {
                             std::ostringstream stream;
-                            stream << "Cmd::fromToken(): unknown token: " << token;
+                            stream << "opCodeFromToken(): unknown token: " << token;
                             throw GenericException(stream.str());
                           }
     }
   }
-  class CmdList: public Cmd {
-    public:
-      virtual ~CmdList() {
-        TContainer::iterator iter;
-        for(iter=container_.begin(); iter!=container_.end(); iter++)
-          delete *iter;
-      }
-      virtual void execute(TRuntimeStack *stack, ISatItem *data) {
-        TContainer::iterator iter;
-        for(iter=container_.begin(); iter!=container_.end(); iter++) {
-          Cmd *cmd = *iter;
-          cmd->execute(stack, data);
-        }
-      }
-      void operator<< (Cmd *cmd) {
-        container_.push_back(cmd);
-      }
-      void operator<< (const Token &token) {
-        operator<< (Cmd::fromToken(token));
-      }
-    private:
-      typedef std::list<Cmd *> TContainer;
-      TContainer container_;
-  };
 
   struct InterpretedFormula::Private {
     ParserStack     parserStack;
     bool            errorDetected;
-    CmdList         cmdList;
+    FormulaCode     code;
+
+    // Compile token reduced by parser
+    void emit(const Token &token) {
+      // Token's number is defined only for variables
+      const EOpCode opCode = opCodeFromToken(token);
+      code.append(opCode, (OP_VAR==opCode) ? token.m_ext_number : 0);
+    }
   };
 
   InterpretedFormula::InterpretedFormula():
@@ -311,7 +223,7 @@ namespace FastSatSolver {
                 }
 
                 // Handle operand
-                d->cmdList << opToken;
+                d->emit(opToken);
                 //std::cerr << "<<< Execute command: " << opToken << std::endl;
               }
               break;
@@ -345,7 +257,7 @@ namespace FastSatSolver {
 
                 Token t = stack.pop();
                 // Handle token
-                d->cmdList << t;
+                d->emit(t);
                 //std::cerr << "<<< Execute command: " << t << std::endl;
 
                 if (!stack.popAndCompare(T_PARSER_LT)) {
@@ -367,7 +279,7 @@ namespace FastSatSolver {
 
                 Token t = stack.pop();
                 // Handle token
-                d->cmdList << t;
+                d->emit(t);
                 //std::cerr << "<<< Execute command: " << t << std::endl;
 
                 if (!stack.popAndCompare(T_PARSER_EXPR)) {
@@ -431,6 +343,16 @@ namespace FastSatSolver {
       !(d->errorDetected);
   }
 
+  /**
+   * @return FormulaCode
+   */
+  const FormulaCode& InterpretedFormula::getCode ( ) {
+    if (!this->isValid())
+      throw GenericException("InterpretedFormula::getCode(): called for invalid formula");
+
+    return d->code;
+  }
+
   /**
    * @param  data
    */
@@ -438,18 +360,15 @@ namespace FastSatSolver {
     if (!this->isValid())
       throw GenericException("InterpretedFormula::eval(): called for invalid formula");
 
-    TRuntimeStack stack;
-    d->cmdList.execute(&stack, data);
-
     // Check stack size (should be 1)
-    const int stackSize = stack.size();
+    const int stackSize = d->code.getDepth();
     if (1!=stackSize) {
       std::ostringstream stream;
-      stream << "InterpretedFormula::eval(): incorrect stack size after cmdList.execute(): " << stackSize;
+      stream << "InterpretedFormula::eval(): incorrect stack size after code execution: " << stackSize;
       throw GenericException(stream.str());
     }
 
-    return stack.top();
+    return d->code.eval(data);
   }
 
 
@@ -32,6 +32,7 @@
 
 
 namespace FastSatSolver {
+  class FormulaCode;
 
   /**
    * @brief Interpreted formula's interface for parser which can read it.
@@ -77,12 +78,19 @@ namespace FastSatSolver {
        * @link FastSatSolver::ISatItem ISatItem @endlink interface for detail.
        */
       virtual bool eval (ISatItem *data ) = 0;
+
+      /**
+       * @brief @return Returns formula compiled to postfix bytecode. It is
+       * used to build program for bit-parallel evaluation.
+       */
+      virtual const FormulaCode& getCode ( ) = 0;
   };
 
   /**
    * @brief Interpreted formula implementation.
-   * @note Implementation of this class is not the Fastest one, but there
-   * hasn't been any request for a better implementation yet.
+   * @note Formula is compiled to flat postfix bytecode (FormulaCode) while
+   * it is being parsed. Evaluation is then a switch-dispatched loop without
+   * any dynamic memory allocation.
    * @ingroup SatProblem
    */
   class InterpretedFormula:
@@ -108,6 +116,11 @@ namespace FastSatSolver {
        */
       bool eval (ISatItem *data );
 
+      /**
+       * @brief @copydoc FastSatSolver::IFormulaEvaluator::getCode()
+       */
+      const FormulaCode& getCode ( );
+
     private:
       struct Private;
       Private *const d;
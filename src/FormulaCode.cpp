@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <assert.h>
+#include <vector>
+#include "SatSolver.h"
+#include "FormulaCode.h"
+
+namespace FastSatSolver {
+
+  namespace {
+    static const int LOCAL_STACK_SIZE = 64;
+    static const int LOCAL_VARS_SIZE = 256;
+
+    // Fixed-size buffer (on heap only if local storage is too small)
+    template <typename T, int N>
+    class LocalBuffer {
+      public:
+        LocalBuffer(int size): heap_(0) {
+          if (size > N)
+            heap_ = new T[size];
+        }
+        ~LocalBuffer() {
+          delete[] heap_;
+        }
+        T* get() {
+          return (heap_) ? heap_ : local_;
+        }
+      private:
+        LocalBuffer(const LocalBuffer &);
+        LocalBuffer& operator= (const LocalBuffer &);
+        T local_[N];
+        T *heap_;
+    };
+
+    // Values of variables read directly from ISatItem
+    class SatItemSource {
+      public:
+        SatItemSource(const ISatItem *data): data_(data) { }
+        bool operator[] (int index) const {
+          assert(index < data_->getLength());
+          return data_->getBit(index);
+        }
+      private:
+        const ISatItem *data_;
+    };
+
+    // Values of variables read from plain array
+    class ArraySource {
+      public:
+        ArraySource(const bool *values): values_(values) { }
+        bool operator[] (int index) const {
+          return values_[index];
+        }
+      private:
+        const bool *values_;
+    };
+
+    // Switch-dispatched interpreter of postfix bytecode, returns count of
+    // values popped by OP_COUNT
+    template <class TSource>
+    int execute(
+        const Instruction   *code,
+        int                 length,
+        bool                *stack,
+        bool                *temps,
+        const TSource       &vars)
+    {
+      int sp = 0;
+      int counter = 0;
+      for(int i=0; i<length; i++) {
+        const Instruction &instr = code[i];
+        switch (instr.opCode) {
+          case OP_FALSE:  stack[sp++] = false;                  break;
+          case OP_TRUE:   stack[sp++] = true;                   break;
+          case OP_VAR:    stack[sp++] = vars[instr.var];        break;
+          case OP_NOT:    stack[sp-1] = !stack[sp-1];           break;
+          case OP_AND:    sp--; stack[sp-1] &= stack[sp];       break;
+          case OP_OR:     sp--; stack[sp-1] |= stack[sp];       break;
+          case OP_XOR:    sp--; stack[sp-1] ^= stack[sp];       break;
+          case OP_COUNT:  counter += stack[--sp];               break;
+          case OP_LOAD:   stack[sp++] = temps[instr.var];       break;
+          case OP_STORE:  temps[instr.var] = stack[sp-1];       break;
+        }
+      }
+      return counter;
+    }
+  } // namespace
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // FormulaCode implementation
+  struct FormulaCode::Private {
+    typedef std::vector<Instruction> TContainer;
+    TContainer  code;
+    int         depth;
+    int         maxDepth;
+    int         temps;
+
+    Private(): depth(0), maxDepth(0), temps(0) { }
+  };
+  FormulaCode::FormulaCode():
+    d(new Private)
+  {
+  }
+  FormulaCode::FormulaCode(const FormulaCode &other):
+    d(new Private(*(other.d)))
+  {
+  }
+  FormulaCode::~FormulaCode() {
+    delete d;
+  }
+  FormulaCode& FormulaCode::operator= (const FormulaCode &other) {
+    *d = *(other.d);
+    return *this;
+  }
+  void FormulaCode::append(EOpCode opCode, int var) {
+    Instruction instr;
+    instr.opCode = opCode;
+    instr.var = (OP_VAR==opCode || OP_LOAD==opCode || OP_STORE==opCode)
+      ? var
+      : 0;
+    d->code.push_back(instr);
+
+    // Track depth of runtime stack
+    switch (opCode) {
+      case OP_FALSE:
+      case OP_TRUE:
+      case OP_VAR:
+        d->depth++;
+        break;
+
+      case OP_LOAD:
+        d->depth++;
+        // fall through
+      case OP_STORE:
+        if (d->temps <= var)
+          d->temps = var + 1;
+        break;
+
+      case OP_NOT:
+        break;
+
+      case OP_AND:
+      case OP_OR:
+      case OP_XOR:
+      case OP_COUNT:
+        d->depth--;
+        break;
+    }
+    assert(0 <= d->depth);
+    if (d->maxDepth < d->depth)
+      d->maxDepth = d->depth;
+  }
+  void FormulaCode::append(const FormulaCode &other) {
+    const Private &src = *(other.d);
+    d->code.insert(d->code.end(), src.code.begin(), src.code.end());
+    if (d->maxDepth < d->depth + src.maxDepth)
+      d->maxDepth = d->depth + src.maxDepth;
+    d->depth += src.depth;
+    if (d->temps < src.temps)
+      d->temps = src.temps;
+  }
+  void FormulaCode::clear() {
+    d->code.clear();
+    d->depth = 0;
+    d->maxDepth = 0;
+    d->temps = 0;
+  }
+  int FormulaCode::getLength() const {
+    return d->code.size();
+  }
+  const Instruction* FormulaCode::getData() const {
+    if (d->code.empty())
+      return 0;
+    return &(d->code[0]);
+  }
+  int FormulaCode::getMaxDepth() const {
+    return d->maxDepth;
+  }
+  int FormulaCode::getNodesCount() const {
+    int count = 0;
+    Private::TContainer::const_iterator iter;
+    for(iter=d->code.begin(); iter!=d->code.end(); iter++) {
+      switch (iter->opCode) {
+        case OP_COUNT:
+        case OP_LOAD:
+        case OP_STORE:
+          break;
+        default:
+          count++;
+      }
+    }
+    return count;
+  }
+  int FormulaCode::getTempsCount() const {
+    return d->temps;
+  }
+  int FormulaCode::getDepth() const {
+    return d->depth;
+  }
+  bool FormulaCode::eval(const ISatItem *data) const {
+    assert(1 == d->depth);
+    LocalBuffer<bool, LOCAL_STACK_SIZE> stack(d->maxDepth);
+    LocalBuffer<bool, LOCAL_STACK_SIZE> temps(d->temps);
+    execute(this->getData(), this->getLength(), stack.get(), temps.get(),
+        SatItemSource(data));
+
+    // Value of formula is left on top of stack
+    return stack.get()[0];
+  }
+  int FormulaCode::evalCount(const ISatItem *data) const {
+    assert(0 == d->depth);
+
+    // Read all variables at once (only one virtual call per variable)
+    const int nVars = data->getLength();
+    LocalBuffer<bool, LOCAL_VARS_SIZE> vars(nVars);
+    bool *values = vars.get();
+    for(int i=0; i<nVars; i++)
+      values[i] = data->getBit(i);
+
+    LocalBuffer<bool, LOCAL_STACK_SIZE> stack(d->maxDepth);
+    LocalBuffer<bool, LOCAL_VARS_SIZE> temps(d->temps);
+    return execute(this->getData(), this->getLength(), stack.get(), temps.get(),
+        ArraySource(values));
+  }
+
+} // namespace FastSatSolver
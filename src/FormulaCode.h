@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef FORMULACODE_H
+#define FORMULACODE_H
+
+/**
+ * @file FormulaCode.h
+ * @brief Formula compiled to flat postfix bytecode
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-05
+ * @ingroup SatProblem
+ */
+
+namespace FastSatSolver {
+  class ISatItem;
+
+  /**
+   * @brief Instruction set of formula bytecode.
+   * @ingroup SatProblem
+   */
+  enum EOpCode {
+    OP_FALSE,             ///< push @c FALSE
+    OP_TRUE,              ///< push @c TRUE
+    OP_VAR,               ///< push value of variable Instruction::var
+    OP_NOT,               ///< negate value on top of stack
+    OP_AND,               ///< replace two values on top of stack by @c AND
+    OP_OR,                ///< replace two values on top of stack by @c OR
+    OP_XOR,               ///< replace two values on top of stack by @c XOR
+    OP_COUNT,             ///< pop value and count it as satisfied formula
+    OP_LOAD,              ///< push value of temporary Instruction::var
+    OP_STORE              ///< copy value on top of stack to temporary Instruction::var
+  };
+
+  /**
+   * @brief Single instruction of formula bytecode.
+   * @ingroup SatProblem
+   */
+  struct Instruction {
+    EOpCode       opCode;         ///< operation
+    int           var;            ///< index of variable (OP_VAR) or temporary (OP_LOAD, OP_STORE)
+  };
+
+  /**
+   * Instructions are stored in one contiguous array. Maximal depth of
+   * runtime stack is computed while code is being built, so evaluator can
+   * use fixed-size stack.
+   * @brief Formula (or more formulas) compiled to postfix bytecode.
+   * @ingroup SatProblem
+   */
+  class FormulaCode {
+    public:
+      FormulaCode();
+      FormulaCode(const FormulaCode &); ///< @brief Deep copy.
+      ~FormulaCode();
+      FormulaCode& operator= (const FormulaCode &);
+
+      /**
+       * @brief Append instruction to the end of code.
+       * @param opCode Operation to append.
+       * @param var Index of variable (OP_VAR) or temporary (OP_LOAD,
+       * OP_STORE), otherwise ignored.
+       */
+      void append(EOpCode opCode, int var = 0);
+
+      /**
+       * @brief Append another code to the end of code.
+       * @param code Code to append.
+       */
+      void append(const FormulaCode &code);
+
+      /**
+       * @brief Remove all instructions.
+       */
+      void clear();
+
+      /**
+       * @brief @return Returns count of instructions.
+       */
+      int getLength() const;
+
+      /**
+       * @brief @return Returns pointer to array of getLength() instructions.
+       */
+      const Instruction* getData() const;
+
+      /**
+       * @brief @return Returns maximal depth of runtime stack.
+       */
+      int getMaxDepth() const;
+
+      /**
+       * @brief @return Returns count of instructions computing a value
+       * (constants, variables and operators), it is count of nodes of
+       * evaluated expressions.
+       */
+      int getNodesCount() const;
+
+      /**
+       * @brief @return Returns count of temporaries used by code.
+       * @note Temporaries hold values of subexpressions shared by more
+       * formulas (or more times by one formula). Consider FormulaDag.
+       */
+      int getTempsCount() const;
+
+      /**
+       * @brief @return Returns count of values left on stack after execution.
+       * @note This should be 1 for valid formula.
+       */
+      int getDepth() const;
+
+      /**
+       * @brief Evaluate code of single formula.
+       * @param data Evaluation data to use for evaluation. Consider
+       * FastSatSolver::ISatItem interface for detail.
+       * @return Returns value left on top of stack.
+       */
+      bool eval(const ISatItem *data) const;
+
+      /**
+       * @brief Evaluate code of more formulas, each of them terminated by
+       * OP_COUNT instruction.
+       * @param data Evaluation data to use for evaluation. Consider
+       * FastSatSolver::ISatItem interface for detail.
+       * @return Returns count of satisfied formulas.
+       */
+      int evalCount(const ISatItem *data) const;
+
+    private:
+      struct Private;
+      Private *d;
+  };
+
+} // namespace FastSatSolver
+
+#endif // FORMULACODE_H
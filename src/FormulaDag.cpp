@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <assert.h>
+#include <map>
+#include <utility>
+#include <vector>
+#include "FormulaDag.h"
+
+namespace FastSatSolver {
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // FormulaDag implementation
+  struct FormulaDag::Private {
+    // Node of DAG, operands are indexes of nodes (or index of variable)
+    struct Node {
+      EOpCode     opCode;
+      int         a;
+      int         b;
+
+      bool operator< (const Node &other) const {
+        if (opCode != other.opCode)
+          return opCode < other.opCode;
+        if (a != other.a)
+          return a < other.a;
+        return b < other.b;
+      }
+    };
+    typedef std::vector<Node> TNodes;
+    typedef std::map<Node, int> TIndex;
+
+    TNodes              nodes;          ///< children always precede parents
+    TIndex              index;          ///< structural hashing
+    std::vector<int>    roots;
+    bool                simplify;
+
+    Private(): simplify(false) { }
+    int create(EOpCode opCode, int a = -1, int b = -1);
+    int lookup(EOpCode opCode, int a = -1, int b = -1);
+    int rewriteBinary(EOpCode opCode, int a, int b);
+    int countRoots(EOpCode opCode) const;
+
+    static bool isLeaf(EOpCode opCode) {
+      return OP_FALSE==opCode || OP_TRUE==opCode || OP_VAR==opCode;
+    }
+    bool isConst(int id) const {
+      return OP_FALSE==nodes[id].opCode || OP_TRUE==nodes[id].opCode;
+    }
+    // True if node a is negation of node b (or vice versa)
+    bool isComplement(int a, int b) const {
+      return (OP_NOT==nodes[a].opCode && b==nodes[a].a)
+        || (OP_NOT==nodes[b].opCode && a==nodes[b].a);
+    }
+    // True if node is binary operation opCode with operand x
+    bool hasOperand(int id, EOpCode opCode, int x) const {
+      const Node &node = nodes[id];
+      return opCode==node.opCode && (x==node.a || x==node.b);
+    }
+  };
+
+  // Return node of given structure, simplify it first if enabled
+  int FormulaDag::Private::create(EOpCode opCode, int a, int b) {
+    if (!simplify)
+      return lookup(opCode, a, b);
+
+    switch (opCode) {
+      case OP_NOT:
+        switch (nodes[a].opCode) {
+          case OP_FALSE:  return lookup(OP_TRUE);
+          case OP_TRUE:   return lookup(OP_FALSE);
+          case OP_NOT:    return nodes[a].a;
+          default:        break;
+        }
+        break;
+
+      case OP_AND:
+      case OP_OR:
+      case OP_XOR:
+        return rewriteBinary(opCode, a, b);
+
+      default:
+        break;
+    }
+    return lookup(opCode, a, b);
+  }
+
+  // Algebraic rules of binary operators
+  int FormulaDag::Private::rewriteBinary(EOpCode opCode, int a, int b) {
+    // Keep constant (if any) in b
+    if (isConst(a))
+      std::swap(a, b);
+    const bool bIsTrue = OP_TRUE==nodes[b].opCode;
+    if (isConst(b)) {
+      switch (opCode) {
+        case OP_AND:  return (bIsTrue) ? a : b;           // x&1, x&0
+        case OP_OR:   return (bIsTrue) ? b : a;           // x|1, x|0
+        case OP_XOR:  return (bIsTrue)                    // x^1, x^0
+                        ? create(OP_NOT, a)
+                        : a;
+        default:      break;
+      }
+    }
+
+    if (a == b) {
+      // x&x, x|x, x^x
+      return (OP_XOR==opCode) ? lookup(OP_FALSE) : a;
+    }
+
+    if (isComplement(a, b)) {
+      // x&~x, x|~x, x^~x
+      return (OP_AND==opCode) ? lookup(OP_FALSE) : lookup(OP_TRUE);
+    }
+
+    for(int i=0; i<2; i++) {
+      const int x = (i) ? b : a;
+      const int y = (i) ? a : b;
+      switch (opCode) {
+        case OP_AND:
+          if (hasOperand(y, OP_OR, x))                  // x&(x|y)
+            return x;
+          if (hasOperand(y, OP_AND, x))                 // x&(x&y)
+            return y;
+          break;
+
+        case OP_OR:
+          if (hasOperand(y, OP_AND, x))                 // x|(x&y)
+            return x;
+          if (hasOperand(y, OP_OR, x))                  // x|(x|y)
+            return y;
+          break;
+
+        case OP_XOR:
+          if (hasOperand(y, OP_XOR, x))                 // x^(x^y)
+            return (x==nodes[y].a) ? nodes[y].b : nodes[y].a;
+          break;
+
+        default:
+          break;
+      }
+    }
+    return lookup(opCode, a, b);
+  }
+
+  int FormulaDag::Private::countRoots(EOpCode opCode) const {
+    int count = 0;
+    for(unsigned i=0; i<roots.size(); i++)
+      if (opCode == nodes[roots[i]].opCode)
+        count++;
+    return count;
+  }
+
+  // Return node of given structure, create it if not exist yet
+  int FormulaDag::Private::lookup(EOpCode opCode, int a, int b) {
+    // Canonical order of commutative operands
+    if ((OP_AND==opCode || OP_OR==opCode || OP_XOR==opCode) && b < a)
+      std::swap(a, b);
+
+    Node node;
+    node.opCode = opCode;
+    node.a = a;
+    node.b = b;
+    TIndex::iterator iter = index.find(node);
+    if (iter != index.end())
+      return iter->second;
+
+    const int id = nodes.size();
+    nodes.push_back(node);
+    index[node] = id;
+    return id;
+  }
+
+  FormulaDag::FormulaDag():
+    d(new Private)
+  {
+  }
+  FormulaDag::~FormulaDag() {
+    delete d;
+  }
+  void FormulaDag::setSimplify(bool enabled) {
+    d->simplify = enabled;
+  }
+  void FormulaDag::addProgram(const FormulaCode &program) {
+    const Instruction *code = program.getData();
+    const int length = program.getLength();
+    std::vector<int> stack;
+    std::vector<int> temps(program.getTempsCount(), -1);
+    for(int i=0; i<length; i++) {
+      const Instruction &instr = code[i];
+      int a, b;
+      switch (instr.opCode) {
+        case OP_FALSE:
+        case OP_TRUE:
+          stack.push_back(d->lookup(instr.opCode));
+          break;
+
+        case OP_VAR:
+          stack.push_back(d->lookup(OP_VAR, instr.var));
+          break;
+
+        case OP_NOT:
+          a = stack.back();
+          stack.back() = d->create(OP_NOT, a);
+          break;
+
+        case OP_AND:
+        case OP_OR:
+        case OP_XOR:
+          b = stack.back();
+          stack.pop_back();
+          a = stack.back();
+          stack.back() = d->create(instr.opCode, a, b);
+          break;
+
+        case OP_COUNT:
+          d->roots.push_back(stack.back());
+          stack.pop_back();
+          break;
+
+        case OP_LOAD:
+          assert(0 <= temps[instr.var]);
+          stack.push_back(temps[instr.var]);
+          break;
+
+        case OP_STORE:
+          temps[instr.var] = stack.back();
+          break;
+      }
+    }
+    assert(stack.empty());
+  }
+  int FormulaDag::getNodesCount() const {
+    return d->nodes.size();
+  }
+  int FormulaDag::getRootsCount() const {
+    return d->roots.size();
+  }
+  int FormulaDag::getTautologiesCount() const {
+    return d->countRoots(OP_TRUE);
+  }
+  int FormulaDag::getContradictionsCount() const {
+    return d->countRoots(OP_FALSE);
+  }
+  void FormulaDag::writeProgram(FormulaCode &program, bool share) const {
+    const Private::TNodes &nodes = d->nodes;
+    const int nodesCount = nodes.size();
+
+    // Count references to each node reachable from (non-constant) roots,
+    // parents always follow their children
+    std::vector<int> refs(nodesCount, 0);
+    const int rootsCount = d->roots.size();
+    for(int i=0; i<rootsCount; i++)
+      if (!d->isConst(d->roots[i]))
+        refs[d->roots[i]]++;
+    for(int i=nodesCount-1; 0<=i; i--) {
+      const Private::Node &node = nodes[i];
+      if (!refs[i] || Private::isLeaf(node.opCode))
+        // Unreachable node (or leaf)
+        continue;
+      refs[node.a]++;
+      if (OP_NOT != node.opCode)
+        refs[node.b]++;
+    }
+
+    // Temporaries are assigned to shared inner nodes once evaluated
+    std::vector<int> temps(nodesCount, -1);
+    int tempsCount = 0;
+
+    // Post-order traversal (explicit stack, formulas can be very deep)
+    typedef std::pair<int, int> TItem;      // (node, count of visited operands)
+    std::vector<TItem> work;
+    for(int r=0; r<rootsCount; r++) {
+      if (d->isConst(d->roots[r]))
+        // Constant formula, nothing to evaluate
+        continue;
+      work.push_back(TItem(d->roots[r], 0));
+      while (!work.empty()) {
+        const int id = work.back().first;
+        const int visited = work.back().second;
+        const Private::Node &node = nodes[id];
+        if (0 == visited) {
+          if (0 <= temps[id]) {
+            // Already evaluated
+            program.append(OP_LOAD, temps[id]);
+            work.pop_back();
+            continue;
+          }
+          if (Private::isLeaf(node.opCode)) {
+            program.append(node.opCode, node.a);
+            work.pop_back();
+            continue;
+          }
+        }
+        const int arity = (OP_NOT==node.opCode) ? 1 : 2;
+        if (visited < arity) {
+          work.back().second++;
+          work.push_back(TItem((0==visited) ? node.a : node.b, 0));
+          continue;
+        }
+
+        // All operands are on stack now
+        program.append(node.opCode);
+        if (share && 1 < refs[id]) {
+          temps[id] = tempsCount++;
+          program.append(OP_STORE, temps[id]);
+        }
+        work.pop_back();
+      }
+      program.append(OP_COUNT);
+    }
+  }
+
+} // namespace FastSatSolver
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef FORMULADAG_H
+#define FORMULADAG_H
+
+/**
+ * @file FormulaDag.h
+ * @brief Structurally shared representation of all formulas
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-11
+ * @ingroup SatProblem
+ */
+
+#include "FormulaCode.h"
+
+namespace FastSatSolver {
+
+  /**
+   * Each distinct subexpression (of any formula) is represented by exactly
+   * one node. Operands of commutative operators (AND, OR, XOR) are ordered
+   * canonically, so @c a&b and @c b&a share the same node. Program written
+   * back by writeProgram() evaluates each shared node only once and keeps
+   * its value in temporary (OP_STORE, OP_LOAD).
+   *
+   * If simplification is enabled, nodes are rewritten while being created:
+   * constants are folded, chains of NOT are collapsed, idempotence
+   * (@c x&x, @c x|x), complement (@c x&~x, @c x|~x, @c x^~x), absorption
+   * (@c x&(x|y), @c x|(x&y)) and @c x^x rules are applied. Formulas which
+   * turn to constants are not written to program at all.
+   * @brief Hash-consed DAG of formulas.
+   * @ingroup SatProblem
+   */
+  class FormulaDag {
+    public:
+      FormulaDag();
+      ~FormulaDag();
+
+      /**
+       * @brief Enable/disable algebraic simplification of nodes being added.
+       * @param enabled True to enable simplification (disabled by default).
+       */
+      void setSimplify(bool enabled);
+
+      /**
+       * @brief Add formulas to DAG.
+       * @param program Bytecode of formulas, each of them terminated by
+       * OP_COUNT instruction.
+       */
+      void addProgram(const FormulaCode &program);
+
+      /**
+       * @brief @return Returns count of distinct nodes.
+       */
+      int getNodesCount() const;
+
+      /**
+       * @brief @return Returns count of formulas (roots of DAG).
+       */
+      int getRootsCount() const;
+
+      /**
+       * @brief @return Returns count of formulas equal to constant @c TRUE.
+       */
+      int getTautologiesCount() const;
+
+      /**
+       * @brief @return Returns count of formulas equal to constant @c FALSE.
+       */
+      int getContradictionsCount() const;
+
+      /**
+       * @brief Write program evaluating all formulas except constant ones.
+       * @param program Bytecode to append program to. Each formula is
+       * terminated by OP_COUNT instruction, formulas keep their order.
+       * @param share If true, shared nodes are evaluated only once (using
+       * temporaries). Otherwise they are written again for each use.
+       * @note Tautologies are not written, so count of satisfied formulas
+       * evaluated by program is less by getTautologiesCount().
+       */
+      void writeProgram(FormulaCode &program, bool share = true) const;
+
+    private:
+      FormulaDag(const FormulaDag &);
+      FormulaDag& operator= (const FormulaDag &);
+      struct Private;
+      Private *d;
+  };
+
+} // namespace FastSatSolver
+
+#endif // FORMULADAG_H
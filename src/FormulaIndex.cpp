@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <assert.h>
+#include <vector>
+#include "SatProblem.h"
+#include "FormulaCode.h"
+#include "FormulaDag.h"
+#include "FormulaIndex.h"
+
+namespace FastSatSolver {
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // FormulaIndex implementation
+  const char FormulaIndex::UNKNOWN;
+  struct FormulaIndex::Private {
+    int                       satsOffset;
+    int                       stackSize;
+
+    // Bytecode of each formula (without OP_COUNT)
+    std::vector<Instruction>  code;
+    std::vector<int>          codeBegin;    ///< indexed by formula, one more item
+
+    // Occurrences of variables in formulas
+    std::vector<int>          occBegin;     ///< indexed by formula, one more item
+    std::vector<int>          occVar;
+    std::vector<int>          occFormula;
+    std::vector<std::vector<int> > varOcc;
+  };
+  FormulaIndex::FormulaIndex(SatProblem *problem):
+    d(new Private)
+  {
+    // Write each formula as tree (no temporaries shared among formulas)
+    FormulaDag dag;
+    dag.addProgram(problem->getProgram());
+    FormulaCode program;
+    dag.writeProgram(program, false);
+    d->satsOffset = problem->getTautologiesCount() + dag.getTautologiesCount();
+    d->stackSize = program.getMaxDepth() + 1;
+
+    // Split program to formulas and collect occurrences of variables
+    const int varsCount = problem->getVarsCount();
+    d->varOcc.resize(varsCount);
+    std::vector<int> lastFormula(varsCount, -1);
+    const Instruction *data = program.getData();
+    const int length = program.getLength();
+    d->codeBegin.push_back(0);
+    d->occBegin.push_back(0);
+    for(int i=0; i<length; i++) {
+      const Instruction &insn = data[i];
+      if (OP_COUNT == insn.opCode) {
+        d->codeBegin.push_back(d->code.size());
+        d->occBegin.push_back(d->occVar.size());
+        continue;
+      }
+      d->code.push_back(insn);
+      if (OP_VAR != insn.opCode)
+        continue;
+      const int formula = d->codeBegin.size()-1;
+      if (lastFormula[insn.var] == formula)
+        // Variable already occurs in formula
+        continue;
+      lastFormula[insn.var] = formula;
+      d->varOcc[insn.var].push_back(d->occVar.size());
+      d->occVar.push_back(insn.var);
+      d->occFormula.push_back(formula);
+    }
+  }
+  FormulaIndex::~FormulaIndex() {
+    delete d;
+  }
+  int FormulaIndex::getFormulasCount() const {
+    return d->codeBegin.size()-1;
+  }
+  int FormulaIndex::getSatsOffset() const {
+    return d->satsOffset;
+  }
+  int FormulaIndex::getVarsCount() const {
+    return d->varOcc.size();
+  }
+  int FormulaIndex::getStackSize() const {
+    return d->stackSize;
+  }
+  int FormulaIndex::getOccurrencesCount() const {
+    return d->occVar.size();
+  }
+  int FormulaIndex::getOccBegin(int formula) const {
+    return d->occBegin[formula];
+  }
+  int FormulaIndex::getOccEnd(int formula) const {
+    return d->occBegin[formula+1];
+  }
+  int FormulaIndex::getOccVar(int occ) const {
+    return d->occVar[occ];
+  }
+  int FormulaIndex::getOccFormula(int occ) const {
+    return d->occFormula[occ];
+  }
+  const std::vector<int>& FormulaIndex::getVarOccurrences(int var) const {
+    return d->varOcc[var];
+  }
+  bool FormulaIndex::eval(int formula, const char *assigns, int flipVar, char *stack) const {
+    char *sp = stack;
+    const Instruction *insn = &d->code[0] + d->codeBegin[formula];
+    const Instruction *end = &d->code[0] + d->codeBegin[formula+1];
+    for(; insn != end; insn++) {
+      switch (insn->opCode) {
+        case OP_FALSE:  *++sp = 0;                                            break;
+        case OP_TRUE:   *++sp = 1;                                            break;
+        case OP_VAR:    *++sp = assigns[insn->var] ^ (insn->var == flipVar);  break;
+        case OP_NOT:    *sp = !*sp;                                           break;
+        case OP_AND:    sp--; sp[0] = sp[0] & sp[1];                          break;
+        case OP_OR:     sp--; sp[0] = sp[0] | sp[1];                          break;
+        case OP_XOR:    sp--; sp[0] = sp[0] ^ sp[1];                          break;
+        default:
+          assert(false);
+      }
+    }
+    return *sp;
+  }
+  char FormulaIndex::evalPartial(int formula, const char *assigns, char *stack) const {
+    char *sp = stack;
+    const Instruction *insn = &d->code[0] + d->codeBegin[formula];
+    const Instruction *end = &d->code[0] + d->codeBegin[formula+1];
+    for(; insn != end; insn++) {
+      switch (insn->opCode) {
+        case OP_FALSE:
+          *++sp = 0;
+          break;
+        case OP_TRUE:
+          *++sp = 1;
+          break;
+        case OP_VAR:
+          *++sp = assigns[insn->var];
+          break;
+        case OP_NOT:
+          if (UNKNOWN != *sp)
+            *sp = !*sp;
+          break;
+        case OP_AND:
+          sp--;
+          if (0 == sp[0] || 0 == sp[1])
+            sp[0] = 0;
+          else if (UNKNOWN == sp[1])
+            sp[0] = UNKNOWN;
+          break;
+        case OP_OR:
+          sp--;
+          if (1 == sp[0] || 1 == sp[1])
+            sp[0] = 1;
+          else if (UNKNOWN == sp[1])
+            sp[0] = UNKNOWN;
+          break;
+        case OP_XOR:
+          sp--;
+          if (UNKNOWN == sp[0] || UNKNOWN == sp[1])
+            sp[0] = UNKNOWN;
+          else
+            sp[0] = sp[0] ^ sp[1];
+          break;
+        default:
+          assert(false);
+      }
+    }
+    return *sp;
+  }
+  void FormulaIndex::writeCode(int formula, FormulaCode &code) const {
+    for(int i=d->codeBegin[formula]; i<d->codeBegin[formula+1]; i++)
+      code.append(d->code[i].opCode, d->code[i].var);
+    code.append(OP_COUNT);
+  }
+
+} // namespace FastSatSolver
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef FORMULAINDEX_H
+#define FORMULAINDEX_H
+
+/**
+ * @file FormulaIndex.h
+ * @brief Formulas evaluable one by one with index of variable occurrences
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-16
+ * @ingroup SatProblem
+ */
+
+#include <vector>
+
+namespace FastSatSolver {
+  class SatProblem;
+  class FormulaCode;
+
+  /**
+   * Each formula of SAT problem is written as tree (without temporaries
+   * shared among formulas), so it can be evaluated alone. Each variable
+   * occurring in formula has exactly one occurrence (regardless of count of
+   * its appearances in formula). Occurrences of each formula are numbered
+   * contiguously, so solvers can keep per-occurrence data in plain arrays.
+   *
+   * This is used by solvers changing assignment incrementally - only
+   * formulas containing changed variable need to be reevaluated.
+   * @brief Formulas evaluable one by one with index of variable occurrences.
+   * @ingroup SatProblem
+   */
+  class FormulaIndex {
+    public:
+      /**
+       * @param problem SAT problem to index. Its program (consider
+       * SatProblem::getProgram()) is used, so formulas removed by
+       * simplification are not indexed.
+       */
+      FormulaIndex(SatProblem *problem);
+      ~FormulaIndex();
+
+      /**
+       * @brief @return Returns count of indexed formulas.
+       */
+      int getFormulasCount() const;
+
+      /**
+       * @brief @return Returns count of formulas which are always satisfied
+       * and thus not indexed (tautologies).
+       * @note Solution has to satisfy getFormulasCount() + getSatsOffset()
+       * == SatProblem::getFormulasCount() (and all indexed formulas).
+       */
+      int getSatsOffset() const;
+
+      /**
+       * @brief @return Returns count of variables.
+       */
+      int getVarsCount() const;
+
+      /**
+       * @brief @return Returns size of stack needed by eval().
+       */
+      int getStackSize() const;
+
+      /**
+       * @brief @return Returns total count of occurrences.
+       */
+      int getOccurrencesCount() const;
+
+      /**
+       * @brief @return Returns first occurrence of desired formula.
+       * @param formula Index of formula.
+       */
+      int getOccBegin(int formula) const;
+
+      /**
+       * @brief @return Returns occurrence following the last occurrence of
+       * desired formula.
+       * @param formula Index of formula.
+       */
+      int getOccEnd(int formula) const;
+
+      /**
+       * @brief @return Returns variable of desired occurrence.
+       * @param occ Index of occurrence.
+       */
+      int getOccVar(int occ) const;
+
+      /**
+       * @brief @return Returns formula of desired occurrence.
+       * @param occ Index of occurrence.
+       */
+      int getOccFormula(int occ) const;
+
+      /**
+       * @brief @return Returns list of occurrences of desired variable.
+       * @param var Index of variable.
+       */
+      const std::vector<int>& getVarOccurrences(int var) const;
+
+      /**
+       * @brief Evaluate single formula.
+       * @param formula Index of formula.
+       * @param assigns Value (0 or 1) of each variable.
+       * @param flipVar Variable to evaluate negated, -1 for none. This is
+       * handy to evaluate formula as if the variable was flipped.
+       * @param stack Buffer of at least getStackSize() items.
+       * @return Returns value of formula.
+       * @note Method is reentrant as long as each thread uses its own stack.
+       */
+      bool eval(int formula, const char *assigns, int flipVar, char *stack) const;
+
+      /**
+       * @brief Value of variable not assigned yet (see evalPartial()).
+       */
+      static const char UNKNOWN = 2;
+
+      /**
+       * Formula is evaluated under Kleene's three-valued logic. Result is
+       * UNKNOWN only if it depends on values of unassigned variables.
+       * @brief Evaluate single formula under partial assignment.
+       * @param formula Index of formula.
+       * @param assigns Value (0, 1 or UNKNOWN) of each variable.
+       * @param stack Buffer of at least getStackSize() items.
+       * @return Returns value of formula (0, 1 or UNKNOWN).
+       * @note Method is reentrant as long as each thread uses its own stack.
+       */
+      char evalPartial(int formula, const char *assigns, char *stack) const;
+
+      /**
+       * Code does not use temporaries, so it can be run by
+       * ILaneKernel::runMasks().
+       * @brief Append bytecode of single formula (terminated by OP_COUNT).
+       * @param formula Index of formula.
+       * @param code Code to append formula to.
+       */
+      void writeCode(int formula, FormulaCode &code) const;
+
+    private:
+      FormulaIndex(const FormulaIndex &);
+      FormulaIndex& operator= (const FormulaIndex &);
+      struct Private;
+      Private *d;
+  };
+
+} // namespace FastSatSolver
+
+#endif // FORMULAINDEX_H
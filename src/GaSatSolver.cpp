@@ -17,12 +17,19 @@
  * along with fss.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <pthread.h>
+#include <unistd.h>
+#include <vector>
+#include <algorithm>
 #include <ga/GA1DBinStrGenome.h>
 #include <ga/GASimpleGA.h>
 #include <ga/GAStatistics.h>
 
 #include "fssIO.h"
 #include "SatProblem.h"
+#include "LaneKernel.h"
+#include "FormulaIndex.h"
+#include "Checkpoint.h"
 #include "GaSatSolver.h"
 
 //#include <ga/GASStateGA.h>
@@ -76,17 +83,264 @@ namespace FastSatSolver {
     return new SatItemGalibAdatper(bs_);
   }
 
+  namespace {
+    // GAlib keeps its random number generator in global variables, GAs of
+    // solvers running in parallel threads take turns in GAlib calls (except
+    // of population evaluator, which does not touch global state). Each
+    // solver reseeds the generator by its own seed whenever it takes turn
+    // and draws the next seed when it leaves, so that its run does not
+    // depend on scheduling of threads.
+    pthread_mutex_t galibMutex = PTHREAD_MUTEX_INITIALIZER;
+
+    // Count of genomes claimed at once by worker (if not evaluated in lanes)
+    const int EVAL_CHUNK = 8;
+
+    // GAlib copies defaults of BOOLEAN parameters as GABoolean
+    const GABoolean DEF_INCREMENTAL_EVAL = gaFalse;
+
+    // Memetic refinement of genomes
+    const float DEF_MEMETIC_RATE = 0.0;
+    const int DEF_MEMETIC_FLIPS = 100;
+    const float MEMETIC_NOISE = 0.2;        ///< probability of random walk
+
+    // Weights of formulas are smoothed once per this count of generations
+    const int WEIGHT_SMOOTH_PERIOD = 10;
+    const GABoolean DEF_FORMULA_WEIGHTING = gaFalse;
+
+    // Elite archive kept among runs
+    const int DEF_ELITE_ARCHIVE = 0;
+    const float DEF_ELITE_SEED_RATE = 0.1;
+
+    const char CHECKPOINT_KIND = 'G';
+
+    /**
+     * Values of formulas cached by genome for incremental evaluation. The
+     * assignment the values belong to is cached as well, so the cache stays
+     * valid even if genome is changed by GAlib behind our back (only more
+     * formulas are reevaluated then).
+     */
+    class FormulaValuesCache: public GAEvalData {
+      public:
+        std::vector<char> assigns;
+        std::vector<char> values;
+        int               satsCount;
+
+        FormulaValuesCache(int varsCount, int formulasCount):
+          assigns(varsCount), values(formulasCount), satsCount(0) { }
+        virtual GAEvalData* clone() const {
+          return new FormulaValuesCache(*this);
+        }
+        virtual void copy(const GAEvalData &src) {
+          const FormulaValuesCache &cache=
+            dynamic_cast<const FormulaValuesCache &>(src);
+          assigns = cache.assigns;
+          values = cache.values;
+          satsCount = cache.satsCount;
+        }
+    };
+
+    /**
+     * GAlib can not restore its statistics, so they are saved and restored
+     * through protected members. History of scores and the best individuals
+     * of all generations are not saved.
+     */
+    class CheckpointStatistics: public GAStatistics {
+      public:
+        CheckpointStatistics(const GAStatistics &stats): GAStatistics(stats) { }
+        void write(CheckpointWriter &writer) const {
+          const unsigned int counters[]= {
+            curgen, numsel, numcro, nummut, numrep, numeval, numpeval
+          };
+          const float scores[]= {
+            maxever, minever, on, offmax, offmin,
+            aveInit, maxInit, minInit, devInit, divInit,
+            aveCur, maxCur, minCur, devCur, divCur
+          };
+          for(unsigned i=0; i<sizeof(counters)/sizeof(*counters); i++)
+            writer.writeUnsigned(counters[i]);
+          for(unsigned i=0; i<sizeof(scores)/sizeof(*scores); i++)
+            writer.writeFloat(scores[i]);
+        }
+        void read(CheckpointReader &reader) {
+          unsigned int *counters[]= {
+            &curgen, &numsel, &numcro, &nummut, &numrep, &numeval, &numpeval
+          };
+          float *scores[]= {
+            &maxever, &minever, &on, &offmax, &offmin,
+            &aveInit, &maxInit, &minInit, &devInit, &divInit,
+            &aveCur, &maxCur, &minCur, &devCur, &divCur
+          };
+          for(unsigned i=0; i<sizeof(counters)/sizeof(*counters); i++)
+            *counters[i] = reader.readUnsigned();
+          for(unsigned i=0; i<sizeof(scores)/sizeof(*scores); i++)
+            *scores[i] = reader.readFloat();
+        }
+    };
+
+    /**
+     * Genetic algorithm whose statistics can be restored from checkpoint.
+     */
+    class ResumableGA: public TGeneticAlgorithm {
+      public:
+        ResumableGA(const GAPopulation &population):
+          TGeneticAlgorithm(population) { }
+        void restoreStatistics(const GAStatistics &statistics) {
+          stats = statistics;
+        }
+    };
+  }
+
   // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   // GaSatSolver implementation
   struct GaSatSolver::Private {
+    struct Worker;
+
     SatProblem                *problem;
     GaSatSolver               *solver;
     float                     maxFitness;
     GA1DBinaryStringGenome    *genome;
-    TGeneticAlgorithm         *ga;
+    ResumableGA               *ga;
     SatItemSet                *resultSet;
+    unsigned                  rngSeed;      ///< seed of GAlib's generator for next turn
+
+    // Incremental evaluation and memetic refinement (null if not used)
+    FormulaIndex              *index;
+    bool                      incremental;
+    GAGenome::SexualCrossover sexual;       ///< crossover wrapped by crossover()
+    float                     memeticRate;  ///< fraction of genomes refined
+    int                       memeticFlips; ///< max. flips per genome
+    unsigned long             memeticSeed;  ///< seed of current evaluation
+
+    // Dynamic weighting of formulas (of index)
+    bool                      weighting;
+    std::vector<long>         weights;      ///< weight of each formula
+    long                      totalWeight;  ///< weight of all formulas
+    int                       weightUpdates;///< updates since last smoothing
+
+    // Elite archive of the best genomes of previous runs
+    struct Elite {
+      int                     satsCount;
+      GaSatItem               *item;
+    };
+    std::vector<Elite>        archive;      ///< ordered by satsCount (descending)
+    int                       archiveSize;
+    float                     seedRate;     ///< fraction of population seeded
+    bool                      evolved;      ///< population was initialized
+
+    // Pool of workers evaluating population, the first worker is run by
+    // thread calling evaluator
+    std::vector<Worker *>     workers;
+    pthread_mutex_t           mutex;        ///< guards state of pool
+    pthread_cond_t            startCond;
+    pthread_cond_t            doneCond;
+    int                       generation;   ///< count of evaluations started
+    int                       active;       ///< workers not done yet
+    bool                      quit;
+    GAPopulation              *population;  ///< population being evaluated
+    int                       next;         ///< first genome not claimed yet
+    int                       chunk;        ///< genomes claimed at once
+    std::vector<int>          sats;         ///< satisfied formulas of genomes
+    std::vector<long>         weighted;     ///< weighted satisfied formulas
 
     static float fitness(GAGenome &);
+    static void evaluator(GAPopulation &);
+    void evaluatePopulation(GAPopulation &);
+    static int crossover(const GAGenome &, const GAGenome &, GAGenome *, GAGenome *);
+
+    void startThreads(int threadsCount);
+    void stopThreads();
+    static void* threadMain(void *);
+
+    // Take next chunk of population, return false if all genomes are taken
+    bool claim(int &first, int &last);
+
+    // Update solver's state by evaluated genome and return its fitness
+    float processGenome(const GABinaryString &, int satsCount);
+
+    // Fitness given by weighted count of satisfied formulas
+    float weightedFitness(long weightedSats) {
+      const int unweighted = problem->getFormulasCount() - index->getFormulasCount();
+      return static_cast<float>(weightedSats + index->getSatsOffset())
+        / (totalWeight + unweighted);
+    }
+    void initWeights();
+
+    // Increase weights of formulas unsatisfied by the best genome of
+    // population, decrease all weights periodically
+    void updateWeights(GAPopulation &);
+
+    // Called with galibMutex locked
+    void archivePopulation();
+    void seedPopulation();
+    void resumeRandom() {
+      GAResetRNG(rngSeed);
+    }
+    void suspendRandom() {
+      rngSeed = GARandomInt(1, 1<<30);
+    }
+    void replaceWorst(const SatItemVector &items);
+  };
+
+  /**
+   * Worker computes counts of satisfied formulas only. It does not touch
+   * solver's state, which is updated once all workers are done.
+   */
+  struct GaSatSolver::Private::Worker {
+    Private                   *d;
+    pthread_t                 thread;
+
+    // Bit-parallel evaluation
+    std::vector<TLaneMask>    vars;
+    std::vector<LaneCounter>  counters;
+
+    // Incremental evaluation
+    std::vector<char>         stack;
+    std::vector<char>         dirty;        ///< formula is to be reevaluated
+    std::vector<int>          dirtyList;
+
+    // Memetic refinement
+    std::vector<char>         assigns;
+    std::vector<char>         bestAssigns;
+    std::vector<char>         values;       ///< value of each formula
+    std::vector<int>          unsat;        ///< unsatisfied formulas
+    std::vector<int>          unsatPos;     ///< position in unsat, -1 if satisfied
+    unsigned long             rnd;
+
+    Worker(Private *d_);
+
+    // xorshift pseudo-random generator, seeded for each genome so that
+    // refinement does not depend on scheduling of workers
+    unsigned long random() {
+      rnd ^= rnd << 13;
+      rnd ^= rnd >> 7;
+      rnd ^= rnd << 17;
+      return rnd;
+    }
+
+    // Evaluate chunks of population until all of them are taken
+    void evaluate();
+
+    // Count satisfied formulas of one genome, store weighted count to
+    // weighted (if not null)
+    int evalGenome(GAGenome &, long *weighted);
+
+    // Evaluate block of genomes at once (one genome per lane)
+    void evalLanes(int first, int count);
+
+    // Reevaluate only formulas containing variables changed since last
+    // evaluation of genome, return count of satisfied formulas
+    int evalIncremental(GAGenome &);
+
+    // Refine desired fraction of genomes in range <first, last-1>
+    void refineChunk(int first, int last);
+
+    // WalkSAT from genome for at most memeticFlips flips, write the best
+    // assignment found back to genome and return its count of satisfied
+    // formulas
+    int refine(GAGenome &, int satsCount);
+    void setValue(int formula, char value);
+    void flip(int var);
+    int pickVar(int formula);
   };
   // protected
   GaSatSolver::GaSatSolver (SatProblem *problem, const GAParameterList &params):
@@ -97,17 +351,77 @@ namespace FastSatSolver {
     d->maxFitness = 0.0;
     const int varsCount = problem->getVarsCount();
     d->genome = new GA1DBinaryStringGenome(varsCount, Private::fitness, d);
-    d->ga = new TGeneticAlgorithm(*(d->genome));
+    GAPopulation population(*(d->genome));
+    population.evaluator(Private::evaluator);
+    d->ga = new ResumableGA(population);
     d->ga->parameters(params);
+    d->rngSeed = 1;
     bool termUponConvergence = false;
     params.get("term_upon_convergence", &termUponConvergence);
     if (termUponConvergence)
       d->ga->terminator(GAGeneticAlgorithm::TerminateUponConvergence);
       //d->ga->terminator(GAGeneticAlgorithm::TerminateUponPopConvergence);
+    d->index = 0;
+    d->sexual = 0;
+    GABoolean incrementalEval = DEF_INCREMENTAL_EVAL;
+    params.get("incremental_eval", &incrementalEval);
+    d->incremental = incrementalEval;
+    if (incrementalEval) {
+      // Children inherit cached values of their parents
+      d->sexual = d->genome->sexual();
+      d->ga->crossover(Private::crossover);
+    }
+    d->memeticRate = DEF_MEMETIC_RATE;
+    params.get("memetic_rate", &d->memeticRate);
+    if (d->memeticRate < 0.0 || 1.0 < d->memeticRate)
+      throw GenericException("memetic_rate out of range");
+    d->memeticFlips = DEF_MEMETIC_FLIPS;
+    params.get("memetic_flips", &d->memeticFlips);
+    if (d->memeticFlips < 0)
+      throw GenericException("memetic_flips out of range");
+    d->memeticSeed = 1;
+    GABoolean weighting = DEF_FORMULA_WEIGHTING;
+    params.get("formula_weighting", &weighting);
+    d->weighting = weighting;
+    if (incrementalEval || 0.0 < d->memeticRate || weighting)
+      d->index = new FormulaIndex(problem);
+    d->archiveSize = DEF_ELITE_ARCHIVE;
+    params.get("elite_archive", &d->archiveSize);
+    if (d->archiveSize < 0)
+      throw GenericException("elite_archive out of range");
+    d->seedRate = DEF_ELITE_SEED_RATE;
+    params.get("elite_seed_rate", &d->seedRate);
+    if (d->seedRate < 0.0 || 1.0 < d->seedRate)
+      throw GenericException("elite_seed_rate out of range");
+    d->evolved = false;
     d->resultSet = new SatItemSet;
+
+    int threads = 1;
+    params.get("threads", &threads);
+    if (0 == threads)
+      threads = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+    d->generation = 0;
+    d->active = 0;
+    d->quit = false;
+    d->population = 0;
+    d->next = 0;
+    d->chunk = EVAL_CHUNK;
+    pthread_mutex_init(&d->mutex, 0);
+    pthread_cond_init(&d->startCond, 0);
+    pthread_cond_init(&d->doneCond, 0);
+    d->startThreads(std::max(1, threads));
   }
   GaSatSolver::~GaSatSolver() {
+    d->stopThreads();
+    for(unsigned i=0; i<d->workers.size(); i++)
+      delete d->workers[i];
+    pthread_cond_destroy(&d->doneCond);
+    pthread_cond_destroy(&d->startCond);
+    pthread_mutex_destroy(&d->mutex);
+    for(unsigned i=0; i<d->archive.size(); i++)
+      delete d->archive[i].item;
     delete d->resultSet;
+    delete d->index;
     delete d->ga;
     delete d->genome;
     delete d;
@@ -121,6 +435,12 @@ namespace FastSatSolver {
     TGeneticAlgorithm::registerDefaultParameters(params);
     const bool FALSE = false;
     params.add("term_upon_convergence", "convterm", GAParameter::BOOLEAN, &FALSE);
+    params.add("incremental_eval", "inceval", GAParameter::BOOLEAN, &DEF_INCREMENTAL_EVAL);
+    params.add("memetic_rate", "memrate", GAParameter::FLOAT, &DEF_MEMETIC_RATE);
+    params.add("memetic_flips", "memflips", GAParameter::INT, &DEF_MEMETIC_FLIPS);
+    params.add("formula_weighting", "fweight", GAParameter::BOOLEAN, &DEF_FORMULA_WEIGHTING);
+    params.add("elite_archive", "archive", GAParameter::INT, &DEF_ELITE_ARCHIVE);
+    params.add("elite_seed_rate", "seedrate", GAParameter::FLOAT, &DEF_ELITE_SEED_RATE);
   }
   SatProblem* GaSatSolver::getProblem() {
     return d->problem;
@@ -128,6 +448,30 @@ namespace FastSatSolver {
   const GAStatistics& GaSatSolver::getStatistics() const {
     return d->ga->statistics();
   }
+  bool GaSatSolver::isDone() {
+    return d->ga->done();
+  }
+  int GaSatSolver::getThreadsCount() {
+    return d->workers.size();
+  }
+  SatItemVector* GaSatSolver::emigrate(int count) {
+    pthread_mutex_lock(&galibMutex);
+    const GAPopulation &population= d->ga->population();
+    count = std::min(count, population.size());
+    SatItemVector *vect = new SatItemVector;
+    for(int i=0; i<count; i++) {
+      const GABinaryString &bs=
+        dynamic_cast<GABinaryString &>(population.best(i));
+      vect->addItem(new GaSatItem(bs));
+    }
+    pthread_mutex_unlock(&galibMutex);
+    return vect;
+  }
+  void GaSatSolver::immigrate(const SatItemVector &items) {
+    pthread_mutex_lock(&galibMutex);
+    d->replaceWorst(items);
+    pthread_mutex_unlock(&galibMutex);
+  }
   int GaSatSolver::getSolutionsCount() {
     return d->resultSet->getLength();
   }
@@ -143,19 +487,142 @@ namespace FastSatSolver {
   float GaSatSolver::maxFitness() {
     return d->maxFitness;
   }
+  int GaSatSolver::getGenerationsCount() {
+    return d->ga->statistics().generation();
+  }
+  void GaSatSolver::saveCheckpoint(const std::string &fileName) {
+    CheckpointWriter writer(CHECKPOINT_KIND);
+    pthread_mutex_lock(&galibMutex);
+    writer.writeUnsigned(d->problem->getVarsCount());
+    CheckpointStatistics(d->ga->statistics()).write(writer);
+    writer.writeFloat(d->maxFitness);
+
+    // GAlib does not expose state of its generator, but it is reseeded by
+    // solver's own seed at the next step anyway
+    writer.writeUnsigned(d->rngSeed);
+    writer.writeUnsigned(d->memeticSeed);
+
+    writer.writeUnsigned(d->weights.size());
+    for(unsigned i=0; i<d->weights.size(); i++)
+      writer.writeUnsigned(d->weights[i]);
+    writer.writeUnsigned((d->weighting) ? d->weightUpdates : 0);
+
+    const GAPopulation &population= d->ga->population();
+    writer.writeUnsigned(population.size());
+    for(int i=0; i<population.size(); i++) {
+      GAGenome &genome= population.individual(i);
+      const GABinaryString &bs= dynamic_cast<GABinaryString &>(genome);
+      writer.writeItem(SatItemGalibAdatper(bs));
+      writer.writeFloat(genome.score());
+    }
+    pthread_mutex_unlock(&galibMutex);
+
+    SatItemVector *vect = d->resultSet->createVector();
+    writer.writeUnsigned(vect->getLength());
+    for(int i=0; i<vect->getLength(); i++)
+      writer.writeItem(*vect->getItem(i));
+    delete vect;
+    writer.commit(fileName);
+  }
+  void GaSatSolver::loadCheckpoint(const std::string &fileName) {
+    CheckpointReader reader(fileName, CHECKPOINT_KIND);
+    const int varsCount = d->problem->getVarsCount();
+    if (static_cast<unsigned long>(varsCount) != reader.readUnsigned())
+      throw GenericException("Checkpoint of another SAT problem: " + fileName);
+    CheckpointStatistics statistics(d->ga->statistics());
+    statistics.read(reader);
+    const float maxFitness = reader.readFloat();
+    const unsigned seed = reader.readUnsigned();
+    const unsigned long memeticSeed = reader.readUnsigned();
+    std::vector<long> weights(reader.readUnsigned());
+    if (weights.size() != d->weights.size())
+      throw GenericException("Checkpoint does not match formula_weighting: " + fileName);
+    long totalWeight = 0L;
+    for(unsigned i=0; i<weights.size(); i++)
+      totalWeight += (weights[i] = reader.readUnsigned());
+    const int weightUpdates = reader.readUnsigned();
+
+    std::vector<std::vector<char> > genomes(reader.readUnsigned());
+    std::vector<float> scores(genomes.size());
+    for(unsigned i=0; i<genomes.size(); i++) {
+      reader.readItem(genomes[i], varsCount);
+      scores[i] = reader.readFloat();
+    }
+    std::vector<std::vector<char> > solutions(reader.readUnsigned());
+    for(unsigned i=0; i<solutions.size(); i++)
+      reader.readItem(solutions[i], varsCount);
+
+    // Checkpoint is valid, restore the state
+    pthread_mutex_lock(&galibMutex);
+    GAPopulation population(d->ga->population());
+    const int count = std::min<int>(genomes.size(), population.size());
+    std::vector<GAGenome *> restored(count);
+    for(int i=0; i<count; i++) {
+      GA1DBinaryStringGenome &genome=
+        dynamic_cast<GA1DBinaryStringGenome &>(population.individual(i));
+      for(int v=0; v<varsCount; v++)
+        genome.gene(v, genomes[i][v]);
+      restored[i] = &genome;
+    }
+
+    // Population is evaluated to update solver's state, but not refined,
+    // and scores of genomes (given by weights at the time) are restored
+    const float memeticRate = d->memeticRate;
+    d->memeticRate = 0.0;
+    population.evaluate(gaTrue);
+    d->memeticRate = memeticRate;
+    for(int i=0; i<count; i++)
+      restored[i]->score(scores[i]);
+    d->ga->population(population);
+    d->ga->restoreStatistics(statistics);
+    d->rngSeed = seed;
+    pthread_mutex_unlock(&galibMutex);
+
+    // Evaluation of population touched state of solver as well
+    d->maxFitness = std::max(d->maxFitness, maxFitness);
+    d->memeticSeed = memeticSeed;
+    if (d->weighting) {
+      d->weights.swap(weights);
+      d->totalWeight = totalWeight;
+      d->weightUpdates = weightUpdates;
+    }
+    GABinaryString bs(varsCount);
+    for(unsigned i=0; i<solutions.size(); i++) {
+      for(int v=0; v<varsCount; v++)
+        bs.bit(v, solutions[i][v]);
+      d->resultSet->addItem(new GaSatItem(bs));
+    }
+  }
   // protected
   void GaSatSolver::initialize() {
+    pthread_mutex_lock(&galibMutex);
+    if (d->evolved)
+      // Keep the best genomes of previous run
+      d->archivePopulation();
     GARandomSeed();
+    d->rngSeed = GARandomInt(1, 1<<30);
+    d->resumeRandom();
+    d->memeticSeed = GARandomInt(1, 1<<30);
     d->maxFitness = 0.0;
+    d->initWeights();
     d->ga->initialize();
+    d->evolved = true;
+    d->seedPopulation();
+    d->suspendRandom();
+    pthread_mutex_unlock(&galibMutex);
     // Now using incremental strategy
     // d->resultSet->clear();
   }
   // protected
   void GaSatSolver::doStep() {
     GAGeneticAlgorithm &ga= *(d->ga);
+    pthread_mutex_lock(&galibMutex);
+    d->resumeRandom();
     ga.step();
-    if (ga.done()) {
+    const bool done = ga.done();
+    d->suspendRandom();
+    pthread_mutex_unlock(&galibMutex);
+    if (done) {
       this->stop();
 #if 0//ndef NDEBUG
       std::cerr << ">>> Stopped by GAlib terminator" << std::endl;
@@ -165,18 +632,501 @@ namespace FastSatSolver {
   float GaSatSolver::Private::fitness(GAGenome &genome) {
     // Static to non-static binding
     Private *d = reinterpret_cast<Private *>(genome.userData());
-    SatProblem *problem = dynamic_cast<SatProblem *>(d->problem);
-    GaSatSolver *solver = dynamic_cast<GaSatSolver *>(d->solver);
     const GABinaryString &bs= dynamic_cast<GABinaryString &>(genome);
-    SatItemSet *resultSet= dynamic_cast<SatItemSet *>(d->resultSet);
 
-    // Compute fitness
+    // Single genome is evaluated outside of population's evaluation, when
+    // the pool is idle
+    long weighted = 0;
+    const int satsCount = d->workers[0]->evalGenome(genome,
+        (d->weighting) ? &weighted : 0);
+    const float fitness = d->processGenome(bs, satsCount);
+    return (d->weighting)
+      ? d->weightedFitness(weighted)
+      : fitness;
+  }
+  void GaSatSolver::Private::evaluator(GAPopulation &population) {
+    const int popSize = population.size();
+    if (0 == popSize)
+      return;
+
+    // Static to non-static binding
+    Private *d = reinterpret_cast<Private *>(population.individual(0).userData());
+
+    // Called by GAlib with galibMutex locked, but evaluation touches only
+    // the population and solver's own state
+    d->suspendRandom();
+    pthread_mutex_unlock(&galibMutex);
+    d->evaluatePopulation(population);
+    pthread_mutex_lock(&galibMutex);
+    d->resumeRandom();
+  }
+  void GaSatSolver::Private::evaluatePopulation(GAPopulation &population) {
+    const int popSize = population.size();
+    sats.resize(popSize);
+    if (weighting)
+      weighted.resize(popSize);
+    this->population = &population;
+    next = 0;
+    memeticSeed += 0x9E3779B9UL;
+    if (problem->getEvaluator() || incremental || weighting) {
+      // Compiled evaluator or incremental evaluation is in use, evaluate
+      // genomes one by one
+      chunk = EVAL_CHUNK;
+    } else {
+      // Evaluate population block by block (one genome per lane), split
+      // evenly among workers by whole lanes, but at most one block at once
+      const int perWorker = (popSize + workers.size() - 1) / workers.size();
+      chunk = std::min(problem->getLaneKernel()->getWidth() * LANE_BITS,
+          (perWorker + LANE_BITS - 1) / LANE_BITS * LANE_BITS);
+    }
+
+    if (1 < workers.size()) {
+      // Wake up other workers
+      pthread_mutex_lock(&mutex);
+      active = workers.size() - 1;
+      generation++;
+      pthread_cond_broadcast(&startCond);
+      pthread_mutex_unlock(&mutex);
+    }
+
+    workers[0]->evaluate();
+
+    if (1 < workers.size()) {
+      // Wait for other workers
+      pthread_mutex_lock(&mutex);
+      while (active)
+        pthread_cond_wait(&doneCond, &mutex);
+      pthread_mutex_unlock(&mutex);
+    }
+    this->population = 0;
+
+    // Assign scores in population's order
+    for(int g=0; g<popSize; g++) {
+      GAGenome &genome= population.individual(g);
+      const GABinaryString &bs= dynamic_cast<GABinaryString &>(genome);
+      const float fitness = this->processGenome(bs, sats[g]);
+      genome.score((weighting)
+          ? this->weightedFitness(weighted[g])
+          : fitness);
+    }
+    if (weighting)
+      this->updateWeights(population);
+  }
+  void GaSatSolver::Private::initWeights() {
+    if (!weighting)
+      return;
+    weights.assign(index->getFormulasCount(), 1L);
+    totalWeight = weights.size();
+    weightUpdates = 0;
+  }
+  void GaSatSolver::Private::updateWeights(GAPopulation &population) {
+    int best = 0;
+    for(int g=1; g<population.size(); g++)
+      if (sats[g] > sats[best])
+        best = g;
+
+    // Formulas unsatisfied by the best genome gain weight
+    Worker *worker = workers[0];
+    const GABinaryString &bs=
+      dynamic_cast<GABinaryString &>(population.individual(best));
+    for(int i=0; i<index->getVarsCount(); i++)
+      worker->assigns[i] = bs.bit(i);
+    for(unsigned f=0; f<weights.size(); f++) {
+      if (!index->eval(f, &worker->assigns[0], -1, &worker->stack[0])) {
+        weights[f]++;
+        totalWeight++;
+      }
+    }
+
+    // Smoothing lets formulas satisfied for long forget their weight
+    if (++weightUpdates < WEIGHT_SMOOTH_PERIOD)
+      return;
+    weightUpdates = 0;
+    for(unsigned f=0; f<weights.size(); f++) {
+      if (1 < weights[f]) {
+        weights[f]--;
+        totalWeight--;
+      }
+    }
+  }
+  void GaSatSolver::Private::archivePopulation() {
+    const GAPopulation &population= ga->population();
+    const int formulasCount = problem->getFormulasCount();
+    const int count = std::min(archiveSize, population.size());
+    for(int i=0; i<count; i++) {
+      GAGenome &genome= population.best(i);
+      const GABinaryString &bs= dynamic_cast<GABinaryString &>(genome);
+      const int satsCount = workers[0]->evalGenome(genome, 0);
+      if (satsCount == formulasCount)
+        // Solutions are kept by resultSet
+        continue;
+
+      // Skip genomes already archived
+      bool known = false;
+      for(unsigned e=0; e<archive.size() && !known; e++) {
+        const GaSatItem *item = archive[e].item;
+        int v = 0;
+        while (v < item->getLength() && item->getBit(v) == bs.bit(v))
+          v++;
+        known = (v == item->getLength());
+      }
+      if (known)
+        continue;
+
+      // Insert behind elites of the same or higher count
+      unsigned pos = 0;
+      while (pos < archive.size() && archive[pos].satsCount >= satsCount)
+        pos++;
+      if (static_cast<int>(pos) >= archiveSize)
+        continue;
+      Elite elite;
+      elite.satsCount = satsCount;
+      elite.item = new GaSatItem(bs);
+      archive.insert(archive.begin() + pos, elite);
+      if (static_cast<int>(archive.size()) > archiveSize) {
+        delete archive.back().item;
+        archive.pop_back();
+      }
+    }
+  }
+  void GaSatSolver::Private::seedPopulation() {
+    const int count = std::min<int>(archive.size(),
+        static_cast<int>(seedRate * ga->population().size()));
+    if (count <= 0)
+      return;
+    SatItemVector items;
+    for(int i=0; i<count; i++)
+      items.addItem(archive[i].item->clone());
+    this->replaceWorst(items);
+  }
+  void GaSatSolver::Private::replaceWorst(const SatItemVector &items) {
+    GAPopulation population(ga->population());
+    const int count = std::min(items.getLength(), population.size());
+    for(int i=0; i<count; i++) {
+      ISatItem *item = items.getItem(i);
+      GA1DBinaryStringGenome *genome=
+        dynamic_cast<GA1DBinaryStringGenome *>(population.worst().clone());
+      for(int v=0; v<item->getLength(); v++)
+        genome->gene(v, item->getBit(v));
+      genome->evaluate(gaTrue);
+      delete population.replace(genome, GAPopulation::WORST);
+    }
+    ga->population(population);
+  }
+  int GaSatSolver::Private::crossover(const GAGenome &mom, const GAGenome &dad,
+                                      GAGenome *c1, GAGenome *c2)
+  {
+    // Static to non-static binding
+    Private *d = reinterpret_cast<Private *>(mom.userData());
+    if (c1 && mom.evalData())
+      c1->evalData(*mom.evalData());
+    if (c2 && dad.evalData())
+      c2->evalData(*dad.evalData());
+    return d->sexual(mom, dad, c1, c2);
+  }
+  void GaSatSolver::Private::startThreads(int threadsCount) {
+    for(int i=0; i<threadsCount; i++)
+      workers.push_back(new Worker(this));
+
+    // The first worker is run by thread calling evaluator
+    for(unsigned i=1; i<workers.size(); i++) {
+      if (0!= pthread_create(&workers[i]->thread, 0, threadMain, workers[i])) {
+        // Run with workers created so far
+        for(unsigned j=i; j<workers.size(); j++)
+          delete workers[j];
+        workers.resize(i);
+        break;
+      }
+    }
+  }
+  void GaSatSolver::Private::stopThreads() {
+    pthread_mutex_lock(&mutex);
+    quit = true;
+    pthread_cond_broadcast(&startCond);
+    pthread_mutex_unlock(&mutex);
+    for(unsigned i=1; i<workers.size(); i++)
+      pthread_join(workers[i]->thread, 0);
+  }
+  void* GaSatSolver::Private::threadMain(void *arg) {
+    Worker *worker = static_cast<Worker *>(arg);
+    Private *d = worker->d;
+    int generation = 0;
+    pthread_mutex_lock(&d->mutex);
+    for(;;) {
+      while (!d->quit && generation == d->generation)
+        pthread_cond_wait(&d->startCond, &d->mutex);
+      if (d->quit)
+        break;
+      generation = d->generation;
+      pthread_mutex_unlock(&d->mutex);
+
+      worker->evaluate();
+
+      pthread_mutex_lock(&d->mutex);
+      if (0 == --d->active)
+        pthread_cond_signal(&d->doneCond);
+    }
+    pthread_mutex_unlock(&d->mutex);
+    return 0;
+  }
+  bool GaSatSolver::Private::claim(int &first, int &last) {
+    pthread_mutex_lock(&mutex);
+    first = next;
+    next = std::min(next + chunk, population->size());
+    last = next;
+    pthread_mutex_unlock(&mutex);
+    return first < last;
+  }
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // GaSatSolver::Private::Worker implementation
+  GaSatSolver::Private::Worker::Worker(Private *d_):
+    d(d_)
+  {
+    const int width = d->problem->getLaneKernel()->getWidth();
+    vars.resize(d->problem->getVarsCount() * width);
+    counters.resize(width);
+    if (d->index) {
+      stack.resize(d->index->getStackSize());
+      dirty.resize(d->index->getFormulasCount(), 0);
+    }
+    if (0.0 < d->memeticRate || d->weighting) {
+      assigns.resize(d->index->getVarsCount());
+      values.resize(d->index->getFormulasCount());
+      unsatPos.resize(d->index->getFormulasCount());
+    }
+  }
+  void GaSatSolver::Private::Worker::evaluate() {
+    const bool lanes = !d->problem->getEvaluator() && !d->incremental && !d->weighting;
+    int first, last;
+    while (d->claim(first, last)) {
+      if (lanes)
+        this->evalLanes(first, last - first);
+      else
+        for(int g=first; g<last; g++)
+          d->sats[g] = this->evalGenome(d->population->individual(g),
+              (d->weighting) ? &d->weighted[g] : 0);
+      if (0.0 < d->memeticRate)
+        this->refineChunk(first, last);
+    }
+  }
+  int GaSatSolver::Private::Worker::evalGenome(GAGenome &genome, long *weighted) {
+    FormulaIndex *index = d->index;
+    const GABinaryString &bs= dynamic_cast<GABinaryString &>(genome);
+    if (d->incremental) {
+      const int satsCount = this->evalIncremental(genome);
+      if (weighted) {
+        // Weigh values cached by genome
+        const FormulaValuesCache *cache=
+          dynamic_cast<const FormulaValuesCache *>(genome.evalData());
+        *weighted = 0;
+        for(unsigned f=0; f<d->weights.size(); f++)
+          if (cache->values[f])
+            *weighted += d->weights[f];
+      }
+      return satsCount;
+    }
+    if (weighted) {
+      // Evaluate formulas one by one to weigh them
+      for(int i=0; i<index->getVarsCount(); i++)
+        assigns[i] = bs.bit(i);
+      int satsCount = index->getSatsOffset();
+      *weighted = 0;
+      for(unsigned f=0; f<d->weights.size(); f++) {
+        if (index->eval(f, &assigns[0], -1, &stack[0])) {
+          satsCount++;
+          *weighted += d->weights[f];
+        }
+      }
+      return satsCount;
+    }
+
     SatItemGalibAdatper data(bs);
+    return d->problem->getSatsCount(&data);
+  }
+  void GaSatSolver::Private::Worker::evalLanes(int first, int count) {
+    const int varsCount = d->problem->getVarsCount();
+    const int width = counters.size();
+
+    // Transpose genomes to lane masks
+    std::fill(vars.begin(), vars.end(), 0UL);
+    for(int g=0; g<count; g++) {
+      const GABinaryString &bs=
+        dynamic_cast<GABinaryString &>(d->population->individual(first+g));
+      const int w = g / LANE_BITS;
+      const TLaneMask bit = 1UL << (g % LANE_BITS);
+      for(int i=0; i<varsCount; i++)
+        if (bs.bit(i))
+          vars[i*width + w] |= bit;
+    }
+    d->problem->getSatsCountLanes(&vars[0], &counters[0]);
+    for(int g=0; g<count; g++)
+      d->sats[first+g] = counters[g / LANE_BITS].getCount(g % LANE_BITS);
+  }
+  int GaSatSolver::Private::Worker::evalIncremental(GAGenome &genome) {
+    FormulaIndex *index = d->index;
+    const GABinaryString &bs= dynamic_cast<GABinaryString &>(genome);
+    const int varsCount = index->getVarsCount();
+    const int formulasCount = index->getFormulasCount();
+    FormulaValuesCache *cache = dynamic_cast<FormulaValuesCache *>(genome.evalData());
+    if (!cache) {
+      // First evaluation of genome, evaluate all formulas
+      genome.evalData(FormulaValuesCache(varsCount, formulasCount));
+      cache = dynamic_cast<FormulaValuesCache *>(genome.evalData());
+      for(int i=0; i<varsCount; i++)
+        cache->assigns[i] = bs.bit(i);
+      cache->satsCount = 0;
+      for(int f=0; f<formulasCount; f++) {
+        cache->values[f] = index->eval(f, &cache->assigns[0], -1, &stack[0]);
+        cache->satsCount += cache->values[f];
+      }
+      return cache->satsCount + index->getSatsOffset();
+    }
+
+    // Collect formulas containing changed variables
+    for(int i=0; i<varsCount; i++) {
+      const char bit = bs.bit(i);
+      if (bit == cache->assigns[i])
+        continue;
+      cache->assigns[i] = bit;
+      const std::vector<int> &occs = index->getVarOccurrences(i);
+      for(unsigned o=0; o<occs.size(); o++) {
+        const int f = index->getOccFormula(occs[o]);
+        if (!dirty[f]) {
+          dirty[f] = 1;
+          dirtyList.push_back(f);
+        }
+      }
+    }
+
+    // Reevaluate them
+    for(unsigned i=0; i<dirtyList.size(); i++) {
+      const int f = dirtyList[i];
+      const char value = index->eval(f, &cache->assigns[0], -1, &stack[0]);
+      cache->satsCount += value - cache->values[f];
+      cache->values[f] = value;
+      dirty[f] = 0;
+    }
+    dirtyList.clear();
+    return cache->satsCount + index->getSatsOffset();
+  }
+  void GaSatSolver::Private::Worker::refineChunk(int first, int last) {
+    for(int g=first; g<last; g++) {
+      rnd = d->memeticSeed ^ ((g + 1UL) * 0x2545F491UL);
+      if (!rnd)
+        rnd = 1;
+      const double r = static_cast<double>(random() % 1000000) / 1000000.0;
+      if (r >= d->memeticRate)
+        continue;
+      GAGenome &genome= d->population->individual(g);
+      const int satsCount = this->refine(genome, d->sats[g]);
+      if (satsCount != d->sats[g] && d->weighting)
+        // Weigh improved genome
+        this->evalGenome(genome, &d->weighted[g]);
+      d->sats[g] = satsCount;
+    }
+  }
+  int GaSatSolver::Private::Worker::refine(GAGenome &genome, int satsCount) {
+    FormulaIndex *index = d->index;
+    GA1DBinaryStringGenome &bs= dynamic_cast<GA1DBinaryStringGenome &>(genome);
+    const int varsCount = index->getVarsCount();
+    const int formulasCount = index->getFormulasCount();
+    for(int i=0; i<varsCount; i++)
+      assigns[i] = bs.gene(i);
+    unsat.clear();
+    for(int f=0; f<formulasCount; f++) {
+      unsatPos[f] = -1;
+      values[f] = 1;
+      this->setValue(f, index->eval(f, &assigns[0], -1, &stack[0]));
+    }
+
+    // Climb while keeping the best assignment found
+    int best = formulasCount - unsat.size();
+    bestAssigns = assigns;
+    for(int i=0; i<d->memeticFlips && !unsat.empty(); i++) {
+      const int formula = unsat[random() % unsat.size()];
+      if (index->getOccBegin(formula) == index->getOccEnd(formula))
+        // Contradiction, no flip can satisfy it
+        continue;
+      this->flip(this->pickVar(formula));
+      const int sats = formulasCount - unsat.size();
+      if (sats > best) {
+        best = sats;
+        bestAssigns = assigns;
+      }
+    }
+    best += index->getSatsOffset();
+    if (best <= satsCount)
+      // Keep genome as it was
+      return satsCount;
+
+    // Write improved genome back to population
+    for(int i=0; i<varsCount; i++)
+      if (bestAssigns[i] != bs.gene(i))
+        bs.gene(i, bestAssigns[i]);
+    return best;
+  }
+  void GaSatSolver::Private::Worker::setValue(int formula, char value) {
+    values[formula] = value;
+    const int pos = unsatPos[formula];
+    if (value && 0 <= pos) {
+      // Remove from list of unsatisfied formulas
+      const int last = unsat.back();
+      unsat[pos] = last;
+      unsatPos[last] = pos;
+      unsat.pop_back();
+      unsatPos[formula] = -1;
+    } else if (!value && pos < 0) {
+      unsatPos[formula] = unsat.size();
+      unsat.push_back(formula);
+    }
+  }
+  void GaSatSolver::Private::Worker::flip(int var) {
+    FormulaIndex *index = d->index;
+    assigns[var] ^= 1;
+    const std::vector<int> &occs = index->getVarOccurrences(var);
+    for(unsigned o=0; o<occs.size(); o++) {
+      const int f = index->getOccFormula(occs[o]);
+      this->setValue(f, index->eval(f, &assigns[0], -1, &stack[0]));
+    }
+  }
+  int GaSatSolver::Private::Worker::pickVar(int formula) {
+    FormulaIndex *index = d->index;
+    const int begin = index->getOccBegin(formula);
+    const int end = index->getOccEnd(formula);
+
+    // Random walk
+    const double r = static_cast<double>(random() % 1000000) / 1000000.0;
+    if (r < MEMETIC_NOISE)
+      return index->getOccVar(begin + random() % (end - begin));
+
+    // Select variable breaking the least satisfied formulas
+    int best = -1;
+    int bestBreaks = 0;
+    for(int o=begin; o<end; o++) {
+      const int var = index->getOccVar(o);
+      int breaks = 0;
+      const std::vector<int> &occs = index->getVarOccurrences(var);
+      for(unsigned i=0; i<occs.size(); i++) {
+        const int f = index->getOccFormula(occs[i]);
+        if (values[f] && !index->eval(f, &assigns[0], var, &stack[0]))
+          breaks++;
+      }
+      if (best < 0 || breaks < bestBreaks) {
+        best = var;
+        bestBreaks = breaks;
+      }
+      if (0 == breaks)
+        // Free move
+        break;
+    }
+    return best;
+  }
+  float GaSatSolver::Private::processGenome(const GABinaryString &bs, int satsCount) {
     const int formulasCount = problem->getFormulasCount();
-    const int satsCount = problem->getSatsCount(&data);
     float fitness = static_cast<float>(satsCount)/formulasCount;
-    if (fitness > d->maxFitness) {
-      d->maxFitness = fitness;
+    if (fitness > maxFitness) {
+      maxFitness = fitness;
       solver->notify();
     }
 
@@ -29,6 +29,7 @@
  */
 
 #include "SatSolver.h"
+#include "Checkpoint.h"
 
 class GAGenome;
 class GABinaryString;
@@ -79,11 +80,38 @@ namespace FastSatSolver {
   };
 
   /**
+   * If GA parameter incremental_eval is set, each genome caches values of
+   * formulas and only formulas containing variables changed since the
+   * genome's last evaluation (or since its parent) are reevaluated.
+   * If GA parameter memetic_rate is set, the given fraction of genomes
+   * is refined by WalkSAT (at most memetic_flips flips per genome) before
+   * its fitness is recorded. The best assignment found replaces genome in
+   * population.
+   * If GA parameter formula_weighting is set, genomes are scored by weighted
+   * count of satisfied formulas. Each generation increases weights of
+   * formulas unsatisfied by its best genome, and all weights decrease once
+   * per 10 generations. Solutions and maxFitness() still count formulas
+   * unweighted, while minFitness() and avgFitness() reflect the scores.
+   * If GA parameter elite_archive is set, the best genomes (other than
+   * solutions) of each run are kept in archive of the given size when
+   * solver is reset. Fraction elite_seed_rate of the new population is then
+   * seeded from the archive instead of starting from scratch.
+   * Population is evaluated by pool of threads given by parameter threads.
+   * Results of threads are then processed in population's order by thread
+   * stepping GA, so that solutions and notifications do not depend on
+   * scheduling of threads.
+   * @note GAlib is not reentrant, solvers running in parallel threads
+   * (consider PortfolioSatSolver and IslandSatSolver) take turns in stepping
+   * their GAs. Only evaluation of populations runs in parallel.
+   * @attention Evaluator of SatProblem has to be reentrant if more threads
+   * are used, which is not true for ShortCircuitEvaluator.
    * @brief Solver using GAlib library to solve SAT problem.
    * @ingroup SatSolver
    * @note Design pattern @b simple @b factory
    */
-  class GaSatSolver: public AbstractSatSolver
+  class GaSatSolver:
+    public AbstractSatSolver,
+    public ICheckpointable
   {
     public:
       virtual ~GaSatSolver();
@@ -92,6 +120,8 @@ namespace FastSatSolver {
        * @brief Simple factory method.
        * @param problem SatProblem instance containing SAT problem to solve.
        * @param params GAParameterList containing GA-specific parameters.
+       * Parameter threads (if registered) is count of threads evaluating
+       * population, 0 means count of CPUs.
        * @return Returns initialized object of GaSatSolver.
        */
       static GaSatSolver* create(
@@ -108,6 +138,53 @@ namespace FastSatSolver {
        * @brief Returns useful statistic data managed by GAStatistics class.
        */
       const GAStatistics& getStatistics() const;
+
+      /**
+       * @brief @return Returns true if GA has met its termination criterion.
+       */
+      bool isDone();
+
+      /**
+       * @brief @return Returns count of threads evaluating population.
+       */
+      int getThreadsCount();
+
+      /**
+       * @brief Copy the best individuals of population.
+       * @param count Desired count of individuals.
+       * @return Returns new SatItemVector allocated on the heap.
+       */
+      SatItemVector* emigrate(int count);
+
+      /**
+       * @brief Replace the worst individuals of population by immigrants.
+       * @param items Assignments to evaluate and insert into population.
+       */
+      void immigrate(const SatItemVector &items);
+
+      /**
+       * @brief @return Returns count of generations of current run
+       * (including generations run before resume from checkpoint).
+       */
+      int getGenerationsCount();
+
+      /**
+       * Checkpoint holds population (including scores), statistics of
+       * GAlib, weights of formulas and solutions found. GAlib does not
+       * expose state of its random number generator, but solver reseeds it
+       * by its own seed at each step, so the seed is stored instead and
+       * saving of checkpoint does not change the run.
+       */
+      virtual void saveCheckpoint(const std::string &fileName);
+
+      /**
+       * Population is reevaluated (without memetic refinement) and
+       * statistics of GAlib are restored, so the run continues as if it
+       * was not interrupted.
+       * @attention Checkpoint has to be saved by solver of the same problem
+       * and the same formula_weighting.
+       */
+      virtual void loadCheckpoint(const std::string &fileName);
       virtual SatProblem* getProblem();
       virtual int getSolutionsCount();
       virtual SatItemVector* getSolutionVector();
@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+#include <ga/GAParameter.h>
+
+#include "fssIO.h"
+#include "GaSatSolver.h"
+#include "IslandSatSolver.h"
+
+namespace FastSatSolver {
+
+  namespace {
+    const int DEF_POPULATIONS = 1;
+    const int DEF_MIGRATION_NUMBER = 5;
+    const int DEF_MIGRATION_INTERVAL = 10;
+    const char DEF_MIGRATION_TOPOLOGY[] = "ring";
+  }
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // IslandSatSolver::Private declaration
+  struct IslandSatSolver::Private {
+    enum Topology {
+      TOPOLOGY_RING,
+      TOPOLOGY_COMPLETE
+    };
+    struct Island;
+
+    SatProblem                *problem;
+    std::vector<Island *>     islands;
+    SatItemSet                resultSet;    ///< solutions of all islands
+    int                       migrationNumber;
+    int                       migrationInterval;
+    Topology                  topology;
+
+    Private(): problem(0) { }
+    ~Private();
+    static void* threadMain(void *);
+
+    // Exchange the best individuals among islands
+    void migrate();
+  };
+
+  /**
+   * Island stops its GaSatSolver (by observing it) after migrationInterval
+   * generations, so that one start() of solver runs one epoch.
+   */
+  struct IslandSatSolver::Private::Island: public IObserver {
+    GaSatSolver               *solver;
+    int                       interval;
+    int                       epochBegin;   ///< steps count at epoch start
+    bool                      done;         ///< GA terminated
+    int                       merged;       ///< count of solutions merged
+    pthread_t                 thread;
+    bool                      threaded;     ///< epoch run by own thread
+
+    Island(GaSatSolver *solver_, int interval_):
+      solver(solver_),
+      interval(interval_),
+      epochBegin(0),
+      done(false),
+      merged(0),
+      threaded(false)
+    {
+      solver->addObserver(this);
+    }
+    ~Island() {
+      delete solver;
+    }
+    void runEpoch() {
+      epochBegin = solver->getStepsCount();
+      solver->start();
+      done = solver->isDone();
+    }
+    virtual void notify() {
+      // Notifications come in the middle of generation as well, which is
+      // then completed anyway
+      if (solver->getStepsCount() - epochBegin + 1 >= interval)
+        solver->stop();
+    }
+  };
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // IslandSatSolver::Private implementation
+  IslandSatSolver::Private::~Private() {
+    for(unsigned i=0; i<islands.size(); i++)
+      delete islands[i];
+  }
+  void* IslandSatSolver::Private::threadMain(void *arg) {
+    Island *island = static_cast<Island *>(arg);
+    island->runEpoch();
+    return 0;
+  }
+  void IslandSatSolver::Private::migrate() {
+    const int count = islands.size();
+    if (count < 2 || migrationNumber <= 0)
+      return;
+
+    // Emigrants of all islands are taken before any immigration
+    std::vector<SatItemVector *> emigrants(count);
+    for(int i=0; i<count; i++)
+      emigrants[i] = islands[i]->solver->emigrate(migrationNumber);
+    for(int i=0; i<count; i++) {
+      GaSatSolver *solver = islands[i]->solver;
+      if (TOPOLOGY_RING == topology) {
+        solver->immigrate(*emigrants[(i + count - 1) % count]);
+        continue;
+      }
+      for(int j=0; j<count; j++)
+        if (j != i)
+          solver->immigrate(*emigrants[j]);
+    }
+    for(int i=0; i<count; i++)
+      delete emigrants[i];
+  }
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // IslandSatSolver implementation
+  // protected
+  IslandSatSolver::IslandSatSolver(SatProblem *problem, const GAParameterList &params):
+    d(new Private)
+  {
+    d->problem = problem;
+
+    int populations = DEF_POPULATIONS;
+    params.get("number_of_populations", &populations);
+    if (populations < 0)
+      throw GenericException("number_of_populations out of range");
+    if (0 == populations)
+      populations = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+
+    d->migrationNumber = DEF_MIGRATION_NUMBER;
+    params.get("migration_number", &d->migrationNumber);
+    if (d->migrationNumber < 0)
+      throw GenericException("migration_number out of range");
+
+    d->migrationInterval = DEF_MIGRATION_INTERVAL;
+    params.get("migration_interval", &d->migrationInterval);
+    if (d->migrationInterval <= 0)
+      throw GenericException("migration_interval out of range");
+
+    // GAParameterList has no const lookup of parameter
+    GAParameter *topology =
+      const_cast<GAParameterList &>(params)("migration_topology");
+    const char *szTopology = (topology)
+      ? static_cast<const char *>(topology->value())
+      : 0;
+    if (0 == szTopology)
+      szTopology = DEF_MIGRATION_TOPOLOGY;
+    if (0 == strcmp(szTopology, "ring"))
+      d->topology = Private::TOPOLOGY_RING;
+    else if (0 == strcmp(szTopology, "complete"))
+      d->topology = Private::TOPOLOGY_COMPLETE;
+    else
+      throw GenericException("Unknown migration_topology (use ring or complete)");
+
+    for(int i=0; i<populations; i++) {
+      GaSatSolver *solver = GaSatSolver::create(problem, params);
+      d->islands.push_back(new Private::Island(solver, d->migrationInterval));
+    }
+  }
+  IslandSatSolver::~IslandSatSolver() {
+    delete d;
+  }
+  IslandSatSolver* IslandSatSolver::create (SatProblem *problem, const GAParameterList &params) {
+    IslandSatSolver *obj = new IslandSatSolver(problem, params);
+    obj->initialize();
+    return obj;
+  }
+  void IslandSatSolver::registerDefaultParameters(GAParameterList &params) {
+    params.add("number_of_populations", "npop", GAParameter::INT, &DEF_POPULATIONS);
+    params.add("migration_number", "nmig", GAParameter::INT, &DEF_MIGRATION_NUMBER);
+    params.add("migration_interval", "migint", GAParameter::INT, &DEF_MIGRATION_INTERVAL);
+    params.add("migration_topology", "migtopo", GAParameter::STRING, &DEF_MIGRATION_TOPOLOGY);
+  }
+  int IslandSatSolver::getIslandsCount() {
+    return d->islands.size();
+  }
+  GaSatSolver* IslandSatSolver::getIsland(int index) {
+    return d->islands[index]->solver;
+  }
+  SatProblem* IslandSatSolver::getProblem() {
+    return d->problem;
+  }
+  int IslandSatSolver::getSolutionsCount() {
+    return d->resultSet.getLength();
+  }
+  SatItemVector* IslandSatSolver::getSolutionVector() {
+    return d->resultSet.createVector();
+  }
+  float IslandSatSolver::minFitness() {
+    float fitness = d->islands[0]->solver->minFitness();
+    for(unsigned i=1; i<d->islands.size(); i++)
+      fitness = std::min(fitness, d->islands[i]->solver->minFitness());
+    return fitness;
+  }
+  float IslandSatSolver::avgFitness() {
+    float sum = 0.0;
+    for(unsigned i=0; i<d->islands.size(); i++)
+      sum += d->islands[i]->solver->avgFitness();
+    return sum / d->islands.size();
+  }
+  float IslandSatSolver::maxFitness() {
+    float fitness = 0.0;
+    for(unsigned i=0; i<d->islands.size(); i++)
+      fitness = std::max(fitness, d->islands[i]->solver->maxFitness());
+    return fitness;
+  }
+  // protected
+  void IslandSatSolver::initialize() {
+    for(unsigned i=0; i<d->islands.size(); i++) {
+      Private::Island *island = d->islands[i];
+      island->solver->reset();
+      island->done = false;
+    }
+    // Now using incremental strategy (as GaSatSolver does)
+  }
+  // protected
+  void IslandSatSolver::doStep() {
+    // Run one epoch on all islands, the first one by this thread
+    const int count = d->islands.size();
+    for(int i=1; i<count; i++) {
+      Private::Island *island = d->islands[i];
+      island->threaded = !island->done
+        && 0== pthread_create(&island->thread, 0, Private::threadMain, island);
+    }
+    if (!d->islands[0]->done)
+      d->islands[0]->runEpoch();
+    for(int i=1; i<count; i++) {
+      Private::Island *island = d->islands[i];
+      if (island->threaded)
+        pthread_join(island->thread, 0);
+      else if (!island->done)
+        // Thread could not be created
+        island->runEpoch();
+    }
+
+    // Merge solutions found by islands
+    bool done = true;
+    for(int i=0; i<count; i++) {
+      Private::Island *island = d->islands[i];
+      done = done && island->done;
+      if (island->solver->getSolutionsCount() == island->merged)
+        continue;
+      SatItemVector *vect = island->solver->getSolutionVector();
+      island->merged = vect->getLength();
+      for(int j=0; j<island->merged; j++)
+        d->resultSet.addItem(vect->getItem(j)->clone());
+      delete vect;
+    }
+
+    if (done)
+      this->stop();
+    else
+      d->migrate();
+  }
+
+} // namespace FastSatSolver
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef ISLANDSATSOLVER_H
+#define ISLANDSATSOLVER_H
+
+/**
+ * @file IslandSatSolver.h
+ * @brief IslandSatSolver class running island model of GA in parallel.
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-20
+ * @ingroup SatSolver
+ */
+
+#include "SatSolver.h"
+
+class GAParameterList;
+
+namespace FastSatSolver {
+  class GaSatSolver;
+
+  /**
+   * Each island is GaSatSolver with its own population, stepped by its own
+   * thread. One step of IslandSatSolver runs migration_interval generations
+   * on all islands in parallel. Then migration_number best individuals of
+   * each island replace the worst ones of its neighbours. Neighbours are
+   * given by migration_topology - @b ring (island i sends to island i+1)
+   * or @b complete (each island sends to all others).
+   * @note GAlib keeps one random number generator in global variables and
+   * its operators call it directly, so islands can not have generators of
+   * their own. Islands therefore take turns in GAlib calls (selection,
+   * crossover, mutation, replacement), only their populations are evaluated
+   * in parallel. Each island reseeds the shared generator by its own seed
+   * when it takes turn, so its run does not depend on scheduling of threads.
+   * The turns take about 75% of generation time with default bit-parallel
+   * evaluation (about 50% with incremental_eval, 10% with memetic_rate 0.2),
+   * which limits the speedup accordingly.
+   * @brief Island model of GA using all CPUs on one SAT problem.
+   * @ingroup SatSolver
+   * @note Design pattern @b simple @b factory
+   */
+  class IslandSatSolver: public AbstractSatSolver
+  {
+    public:
+      virtual ~IslandSatSolver();
+
+      /**
+       * @brief Simple factory method.
+       * @param problem SatProblem instance containing SAT problem to solve.
+       * @param params GAParameterList containing GA-specific parameters
+       * (shared by all islands) and parameters of island model.
+       * Parameter number_of_populations equal to 0 means count of CPUs.
+       * @return Returns initialized object of IslandSatSolver.
+       */
+      static IslandSatSolver* create(
+                                     SatProblem             *problem,
+                                     const GAParameterList  &params);
+
+      /**
+       * @brief Extends GAParameterList with parameters of island model.
+       * @param params Reference to GAParameterList object managed by caller.
+       */
+      static void registerDefaultParameters(GAParameterList &params);
+
+      /**
+       * @brief @return Returns count of islands.
+       */
+      int getIslandsCount();
+
+      /**
+       * @brief @return Returns GA solver of desired island.
+       * @param index Index value has to be in range <0, getIslandsCount()-1>.
+       */
+      GaSatSolver* getIsland(int index);
+
+      virtual SatProblem* getProblem();
+      virtual int getSolutionsCount();
+      virtual SatItemVector* getSolutionVector();
+      virtual float minFitness();
+      virtual float avgFitness();
+      virtual float maxFitness();
+
+    protected:
+      /**
+       * @brief Non-public constructor. Use static method create() instead.
+       * @param problem SatProblem instance containing SAT problem to solve.
+       * @param params GAParameterList containing GA-specific parameters.
+       * @note Design pattern @b Simple @b factory
+       */
+      IslandSatSolver(SatProblem *problem, const GAParameterList &params);
+
+      virtual void initialize();
+      virtual void doStep();
+
+    private:
+      struct Private;
+      Private *d;
+  };
+
+} // namespace FastSatSolver
+
+#endif // ISLANDSATSOLVER_H
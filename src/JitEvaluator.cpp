@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <assert.h>
+#include <string.h>
+#include <vector>
+#include "fssIO.h"
+#include "FormulaCode.h"
+#include "JitEvaluator.h"
+
+#if defined(__x86_64__) && defined(__LP64__) && defined(__unix__)
+# define FSS_HAVE_JIT
+# include <sys/mman.h>
+# ifndef MAP_ANONYMOUS
+#   define MAP_ANONYMOUS MAP_ANON
+# endif
+#endif
+
+namespace FastSatSolver {
+
+  namespace {
+    typedef std::vector<unsigned char> TCodeBuffer;
+
+    /*
+     * Register usage (System V AMD64 ABI):
+     *   rdi ... pointer to packed assignment (1st argument)
+     *   rsi ... pointer to array of temporaries (2nd argument)
+     *   rax ... top of runtime stack (0 or 1)
+     *   rcx ... second operand
+     *   rdx ... count of satisfied formulas
+     * The rest of runtime stack is kept on machine stack (push/pop).
+     */
+    class CodeGenerator {
+      public:
+        CodeGenerator(TCodeBuffer &buffer):
+          buffer_(buffer),
+          tosValid_(false)
+        {
+        }
+        void compile(const Instruction *program, int length);
+
+      private:
+        TCodeBuffer   &buffer_;
+        bool          tosValid_;
+
+        void byte(unsigned char b) {
+          buffer_.push_back(b);
+        }
+        void dword(unsigned value) {
+          for(int i=0; i<4; i++)
+            byte(static_cast<unsigned char>(value >> (8*i)));
+        }
+        void pushTos();
+        void loadVar(int var, bool toRcx);
+        void loadTemp(int temp, bool toRcx);
+        void binaryOp(EOpCode opCode);
+    };
+
+    // Spill top of stack (if any) to machine stack
+    void CodeGenerator::pushTos() {
+      if (tosValid_)
+        byte(0x50);                                 // push rax
+      tosValid_ = true;
+    }
+
+    // Load value of variable to eax (or ecx)
+    void CodeGenerator::loadVar(int var, bool toRcx) {
+      const unsigned disp = (var/LANE_BITS)*sizeof(TLaneMask);
+      const int shift = var%LANE_BITS;
+      byte(0x48); byte(0x8B);                       // mov rax/rcx, [rdi+disp32]
+      byte(toRcx ? 0x8F : 0x87);
+      dword(disp);
+      if (shift) {
+        byte(0x48); byte(0xC1);                     // shr rax/rcx, imm8
+        byte(toRcx ? 0xE9 : 0xE8);
+        byte(static_cast<unsigned char>(shift));
+      }
+      byte(0x83); byte(toRcx ? 0xE1 : 0xE0);        // and eax/ecx, 1
+      byte(0x01);
+    }
+
+    // Load value of temporary to rax (or rcx)
+    void CodeGenerator::loadTemp(int temp, bool toRcx) {
+      byte(0x48); byte(0x8B);                       // mov rax/rcx, [rsi+disp32]
+      byte(toRcx ? 0x8E : 0x86);
+      dword(temp*sizeof(TLaneMask));
+    }
+
+    // eax = eax OP ecx
+    void CodeGenerator::binaryOp(EOpCode opCode) {
+      switch (opCode) {
+        case OP_AND:  byte(0x21); break;            // and eax, ecx
+        case OP_OR:   byte(0x09); break;            // or  eax, ecx
+        case OP_XOR:  byte(0x31); break;            // xor eax, ecx
+        default:      assert(false);
+      }
+      byte(0xC8);
+    }
+
+    inline bool isBinaryOp(EOpCode opCode) {
+      return opCode==OP_AND || opCode==OP_OR || opCode==OP_XOR;
+    }
+
+    void CodeGenerator::compile(const Instruction *program, int length) {
+      byte(0x31); byte(0xD2);                       // xor edx, edx
+      for(int i=0; i<length; i++) {
+        const Instruction &instr = program[i];
+        switch (instr.opCode) {
+          case OP_FALSE:
+            pushTos();
+            byte(0x31); byte(0xC0);                 // xor eax, eax
+            break;
+
+          case OP_TRUE:
+            pushTos();
+            byte(0xB8); dword(1);                   // mov eax, 1
+            break;
+
+          case OP_VAR:
+            // Operand of binary operation does not need to go through stack
+            if (tosValid_ && i+1<length && isBinaryOp(program[i+1].opCode)) {
+              loadVar(instr.var, true);
+              binaryOp(program[++i].opCode);
+              break;
+            }
+            if (tosValid_ && i+2<length && program[i+1].opCode==OP_NOT
+                && isBinaryOp(program[i+2].opCode))
+            {
+              loadVar(instr.var, true);
+              byte(0x83); byte(0xF1); byte(0x01);   // xor ecx, 1
+              binaryOp(program[i+2].opCode);
+              i += 2;
+              break;
+            }
+            pushTos();
+            loadVar(instr.var, false);
+            break;
+
+          case OP_LOAD:
+            if (tosValid_ && i+1<length && isBinaryOp(program[i+1].opCode)) {
+              loadTemp(instr.var, true);
+              binaryOp(program[++i].opCode);
+              break;
+            }
+            pushTos();
+            loadTemp(instr.var, false);
+            break;
+
+          case OP_STORE:
+            assert(tosValid_);
+            byte(0x48); byte(0x89); byte(0x86);     // mov [rsi+disp32], rax
+            dword(instr.var*sizeof(TLaneMask));
+            break;
+
+          case OP_NOT:
+            assert(tosValid_);
+            byte(0x83); byte(0xF0); byte(0x01);     // xor eax, 1
+            break;
+
+          case OP_AND:
+          case OP_OR:
+          case OP_XOR:
+            assert(tosValid_);
+            byte(0x59);                             // pop rcx
+            binaryOp(instr.opCode);
+            break;
+
+          case OP_COUNT:
+            assert(tosValid_);
+            byte(0x01); byte(0xC2);                 // add edx, eax
+            tosValid_ = false;
+            break;
+        }
+      }
+      assert(!tosValid_);
+      byte(0x89); byte(0xD0);                       // mov eax, edx
+      byte(0xC3);                                   // ret
+    }
+  } // namespace
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // JitEvaluator implementation
+  struct JitEvaluator::Private {
+    typedef int (*TFunction)(const TLaneMask *, TLaneMask *);
+    void          *code;
+    size_t        size;
+    TFunction     fnc;
+    int           tempsCount;
+
+    static const int LOCAL_TEMPS_SIZE = 256;
+  };
+  JitEvaluator::JitEvaluator(const FormulaCode &program):
+    d(new Private)
+  {
+    d->code = 0;
+    d->size = 0;
+    d->fnc = 0;
+    d->tempsCount = program.getTempsCount();
+#ifdef FSS_HAVE_JIT
+    TCodeBuffer buffer;
+    CodeGenerator generator(buffer);
+    generator.compile(program.getData(), program.getLength());
+    d->size = buffer.size();
+
+    // Map writable memory first, then turn it to executable (W^X)
+    void *code = mmap(0, d->size, PROT_READ|PROT_WRITE,
+        MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == code) {
+      delete d;
+      throw GenericException("JitEvaluator: mmap() failed");
+    }
+    memcpy(code, &buffer[0], d->size);
+    if (0!= mprotect(code, d->size, PROT_READ|PROT_EXEC)) {
+      munmap(code, d->size);
+      delete d;
+      throw GenericException("JitEvaluator: mprotect() failed");
+    }
+    d->code = code;
+
+    // ISO C++ does not allow direct cast from object pointer to function
+    memcpy(&d->fnc, &code, sizeof(d->fnc));
+#else
+    (void) program;
+    delete d;
+    throw GenericException("JitEvaluator: not supported on this platform");
+#endif
+  }
+  JitEvaluator::~JitEvaluator() {
+#ifdef FSS_HAVE_JIT
+    munmap(d->code, d->size);
+#endif
+    delete d;
+  }
+  bool JitEvaluator::isSupported() {
+#ifdef FSS_HAVE_JIT
+    return true;
+#else
+    return false;
+#endif
+  }
+  int JitEvaluator::getCodeSize() {
+    return static_cast<int>(d->size);
+  }
+  int JitEvaluator::evalPacked (const TLaneMask *packed) {
+    if (d->tempsCount <= Private::LOCAL_TEMPS_SIZE) {
+      TLaneMask temps[Private::LOCAL_TEMPS_SIZE];
+      return d->fnc(packed, temps);
+    }
+    std::vector<TLaneMask> temps(d->tempsCount);
+    return d->fnc(packed, &temps[0]);
+  }
+
+} // namespace FastSatSolver
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef JITEVALUATOR_H
+#define JITEVALUATOR_H
+
+/**
+ * @file JitEvaluator.h
+ * @brief Compilation of formulas to native x86-64 code at runtime
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-09
+ * @ingroup SatProblem
+ */
+
+#include "SatProblem.h"
+
+namespace FastSatSolver {
+  class FormulaCode;
+
+  /**
+   * Program (bytecode of all formulas) is translated to one native function
+   * placed in executable memory. The function takes packed assignment and
+   * returns count of satisfied formulas, so there is no per-instruction
+   * dispatch at runtime.
+   * @brief Container evaluator using just-in-time compiled native code.
+   * @note Available on x86-64 only. Constructor throws GenericException
+   * on other platforms.
+   * @ingroup SatProblem
+   */
+  class JitEvaluator: public IContainerEvaluator {
+    public:
+      /**
+       * @param program Bytecode of all formulas, each of them terminated by
+       * OP_COUNT instruction. Consider FormulaContainer::getProgram().
+       */
+      JitEvaluator(const FormulaCode &program);
+      virtual ~JitEvaluator();
+
+      /**
+       * @brief @return Returns true if JIT compilation is supported.
+       */
+      static bool isSupported();
+
+      /**
+       * @brief @return Returns size of generated code in bytes.
+       */
+      int getCodeSize();
+
+      virtual int evalPacked (const TLaneMask *packed);
+
+    private:
+      struct Private;
+      Private *d;
+  };
+
+} // namespace FastSatSolver
+
+#endif // JITEVALUATOR_H
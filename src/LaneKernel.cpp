@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <sstream>
+#include "fssIO.h"
+#include "LaneKernelImpl.h"
+#include "LaneKernel.h"
+
+namespace FastSatSolver {
+
+  namespace {
+    // Portable vector operations (one machine word)
+    struct WordOps {
+      typedef TLaneMask TVector;
+      static TVector zero() {
+        return 0UL;
+      }
+      static TVector ones() {
+        return ~0UL;
+      }
+      static TVector load(const TLaneMask *ptr) {
+        return *ptr;
+      }
+      static void store(TLaneMask *ptr, TVector v) {
+        *ptr = v;
+      }
+      static TVector bitAnd(TVector a, TVector b) {
+        return a & b;
+      }
+      static TVector bitOr(TVector a, TVector b) {
+        return a | b;
+      }
+      static TVector bitXor(TVector a, TVector b) {
+        return a ^ b;
+      }
+      static bool isZero(TVector v) {
+        return !v;
+      }
+    };
+
+    // Instruction set extensions detected at runtime
+    enum EIsa {
+      ISA_SSE2,
+      ISA_AVX2,
+      ISA_AVX512
+    };
+
+    bool cpuSupports(EIsa isa) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+      __builtin_cpu_init();
+      switch (isa) {
+        case ISA_SSE2:    return __builtin_cpu_supports("sse2");
+        case ISA_AVX2:    return __builtin_cpu_supports("avx2");
+        case ISA_AVX512:  return __builtin_cpu_supports("avx512f");
+      }
+#endif
+      (void) isa;
+      return false;
+    }
+  } // namespace
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // LaneKernelFactory implementation
+  ILaneKernel* LaneKernelFactory::create(int bits) {
+    if (0 == bits)
+      bits = getMaxBits();
+
+    if (LANE_BITS == bits)
+      return new LaneKernelImpl<WordOps>("generic");
+#ifdef HAVE_SSE2
+    if (128 == bits && cpuSupports(ISA_SSE2))
+      return createLaneKernelSse2();
+#endif
+#ifdef HAVE_AVX2
+    if (256 == bits && cpuSupports(ISA_AVX2))
+      return createLaneKernelAvx2();
+#endif
+#ifdef HAVE_AVX512
+    if (512 == bits && cpuSupports(ISA_AVX512))
+      return createLaneKernelAvx512();
+#endif
+
+    std::ostringstream stream;
+    stream << "Lane width not supported on this machine: " << bits;
+    throw GenericException(stream.str());
+  }
+  int LaneKernelFactory::getMaxBits() {
+#ifdef HAVE_AVX512
+    if (cpuSupports(ISA_AVX512))
+      return 512;
+#endif
+#ifdef HAVE_AVX2
+    if (cpuSupports(ISA_AVX2))
+      return 256;
+#endif
+#ifdef HAVE_SSE2
+    if (cpuSupports(ISA_SSE2) && 128 > LANE_BITS)
+      return 128;
+#endif
+    return LANE_BITS;
+  }
+
+} // namespace FastSatSolver
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LANEKERNEL_H
+#define LANEKERNEL_H
+
+/**
+ * @file LaneKernel.h
+ * @brief Kernels of bit-parallel formula evaluation for various vector widths
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-05
+ * @ingroup SatProblem
+ */
+
+#include "SatProblem.h"
+
+namespace FastSatSolver {
+  struct Instruction;
+
+  /**
+   * Kernel evaluates program (bytecode of all formulas) for block of
+   * getBits() assignments at once. Block consists of getWidth() machine
+   * words (TLaneMask) per each variable.
+   * @brief Bit-parallel evaluation kernel's interface.
+   * @interface ILaneKernel
+   * @ingroup SatProblem
+   */
+  class ILaneKernel {
+    public:
+      virtual ~ILaneKernel() { }
+
+      /**
+       * @brief @return Returns human readable name of kernel.
+       */
+      virtual const char* getName() = 0;
+
+      /**
+       * @brief @return Returns count of assignments evaluated at once.
+       */
+      virtual int getBits() = 0;
+
+      /**
+       * @brief @return Returns count of TLaneMask words per variable.
+       */
+      virtual int getWidth() = 0;
+
+      /**
+       * @brief Run program for one block of assignments.
+       * @param program Bytecode of all formulas, each of them terminated by
+       * OP_COUNT instruction.
+       * @param length Count of instructions in program.
+       * @param maxDepth Maximal depth of runtime stack used by program.
+       * @param tempsCount Count of temporaries used by program.
+       * @param vars Array of getWidth() words for each variable. Word @c w
+       * of variable @c i is stored at index @c i*getWidth()+w.
+       * @param counters Array of getWidth() counters to store results to.
+       * @return Returns false if there is not enough memory to run program.
+       */
+      virtual bool run(
+                       const Instruction    *program,
+                       int                  length,
+                       int                  maxDepth,
+                       int                  tempsCount,
+                       const TLaneMask      *vars,
+                       LaneCounter          *counters) = 0;
+
+      /**
+       * Used to reevaluate only some formulas of block (see Gray code
+       * mode of BlindSatSolver).
+       * @brief Run program for one block of assignments and store value of
+       * each formula instead of counting them.
+       * @param program Bytecode of formulas, each of them terminated by
+       * OP_COUNT instruction. It can not use temporaries.
+       * @param length Count of instructions in program.
+       * @param maxDepth Maximal depth of runtime stack used by program.
+       * @param vars Array of getWidth() words for each variable (the same
+       * layout as run() uses).
+       * @param formulas Index of slot for each formula of program.
+       * @param masks Array of getWidth() words for each slot. Value of @c
+       * k-th formula is stored to words starting at index @c
+       * formulas[k]*getWidth().
+       * @return Returns false if there is not enough memory to run program.
+       */
+      virtual bool runMasks(
+                       const Instruction    *program,
+                       int                  length,
+                       int                  maxDepth,
+                       const TLaneMask      *vars,
+                       const int            *formulas,
+                       TLaneMask            *masks) = 0;
+  };
+
+  /**
+   * @brief Factory selecting kernel supported by running CPU.
+   * @ingroup SatProblem
+   * @note Design pattern @b simple @b factory
+   */
+  class LaneKernelFactory {
+    public:
+      /**
+       * @brief Create kernel of desired width.
+       * @param bits Count of assignments evaluated at once (64, 128, 256 or
+       * 512). Zero means the widest kernel supported by running CPU.
+       * @return Returns on heap allocated kernel.
+       * @note GenericException is thrown if desired width is not supported
+       * by build or by running CPU.
+       */
+      static ILaneKernel* create(int bits = 0);
+
+      /**
+       * @brief @return Returns the widest count of bits supported by both
+       * build and running CPU.
+       */
+      static int getMaxBits();
+  };
+
+} // namespace FastSatSolver
+
+#endif // LANEKERNEL_H
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef HAVE_AVX2
+
+#include <immintrin.h>
+#include "LaneKernelImpl.h"
+
+namespace FastSatSolver {
+
+  namespace {
+    // 256-bit vector operations (AVX2)
+    struct Avx2Ops {
+      typedef __m256i TVector;
+      static TVector zero() {
+        return _mm256_setzero_si256();
+      }
+      static TVector ones() {
+        return _mm256_set1_epi32(-1);
+      }
+      static TVector load(const TLaneMask *ptr) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+      }
+      static void store(TLaneMask *ptr, TVector v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(ptr), v);
+      }
+      static TVector bitAnd(TVector a, TVector b) {
+        return _mm256_and_si256(a, b);
+      }
+      static TVector bitOr(TVector a, TVector b) {
+        return _mm256_or_si256(a, b);
+      }
+      static TVector bitXor(TVector a, TVector b) {
+        return _mm256_xor_si256(a, b);
+      }
+      static bool isZero(TVector v) {
+        return _mm256_testz_si256(v, v);
+      }
+    };
+  } // namespace
+
+  ILaneKernel* createLaneKernelAvx2() {
+    return new LaneKernelImpl<Avx2Ops>("avx2");
+  }
+
+} // namespace FastSatSolver
+
+#endif // HAVE_AVX2
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef HAVE_AVX512
+
+#include <immintrin.h>
+#include "LaneKernelImpl.h"
+
+namespace FastSatSolver {
+
+  namespace {
+    // 512-bit vector operations (AVX-512 Foundation)
+    struct Avx512Ops {
+      typedef __m512i TVector;
+      static TVector zero() {
+        return _mm512_setzero_si512();
+      }
+      static TVector ones() {
+        return _mm512_set1_epi32(-1);
+      }
+      static TVector load(const TLaneMask *ptr) {
+        return _mm512_loadu_si512(ptr);
+      }
+      static void store(TLaneMask *ptr, TVector v) {
+        _mm512_storeu_si512(ptr, v);
+      }
+      static TVector bitAnd(TVector a, TVector b) {
+        return _mm512_and_si512(a, b);
+      }
+      static TVector bitOr(TVector a, TVector b) {
+        return _mm512_or_si512(a, b);
+      }
+      static TVector bitXor(TVector a, TVector b) {
+        return _mm512_xor_si512(a, b);
+      }
+      static bool isZero(TVector v) {
+        return 0 == _mm512_test_epi64_mask(v, v);
+      }
+    };
+  } // namespace
+
+  ILaneKernel* createLaneKernelAvx512() {
+    return new LaneKernelImpl<Avx512Ops>("avx512");
+  }
+
+} // namespace FastSatSolver
+
+#endif // HAVE_AVX512
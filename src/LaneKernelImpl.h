@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LANEKERNELIMPL_H
+#define LANEKERNELIMPL_H
+
+/**
+ * @file LaneKernelImpl.h
+ * @brief Template of bit-parallel evaluation kernel shared by all widths
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-05
+ * @ingroup SatProblem
+ * @attention This file is included by translation units built with
+ * instruction set specific compiler flags. Do not use any inline function
+ * or template defined outside of this file there, linker could pick its
+ * (incompatible) copy for the rest of program. That is why errors are
+ * returned, not thrown.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include "FormulaCode.h"
+#include "LaneKernel.h"
+
+namespace FastSatSolver {
+
+  /**
+   * Parameter TOps is a set of static vector operations: TVector type,
+   * zero(), ones(), load(), store(), bitAnd(), bitOr(), bitXor() and
+   * isZero(). It should be defined in anonymous namespace of each
+   * instruction set specific translation unit.
+   * @brief Bit-parallel evaluation kernel template.
+   * @ingroup SatProblem
+   */
+  template <class TOps>
+  class LaneKernelImpl: public ILaneKernel {
+    public:
+      typedef typename TOps::TVector TVector;
+
+      LaneKernelImpl(const char *name): name_(name) { }
+
+      virtual const char* getName() {
+        return name_;
+      }
+
+      virtual int getBits() {
+        return WIDTH * LANE_BITS;
+      }
+
+      virtual int getWidth() {
+        return WIDTH;
+      }
+
+      virtual bool run(
+                       const Instruction    *program,
+                       int                  length,
+                       int                  maxDepth,
+                       int                  tempsCount,
+                       const TLaneMask      *vars,
+                       LaneCounter          *counters)
+      {
+        return this->execute(program, length, maxDepth, tempsCount, vars,
+            counters, 0, 0);
+      }
+
+      virtual bool runMasks(
+                       const Instruction    *program,
+                       int                  length,
+                       int                  maxDepth,
+                       const TLaneMask      *vars,
+                       const int            *formulas,
+                       TLaneMask            *masks)
+      {
+        return this->execute(program, length, maxDepth, 0, vars,
+            0, formulas, masks);
+      }
+
+    private:
+      // Formulas are counted to counters, or stored to masks if they
+      // are given
+      bool execute(
+                       const Instruction    *program,
+                       int                  length,
+                       int                  maxDepth,
+                       int                  tempsCount,
+                       const TLaneMask      *vars,
+                       LaneCounter          *counters,
+                       const int            *formulas,
+                       TLaneMask            *masks)
+      {
+        // Use heap only for unusually deep formulas (or many temporaries)
+        TVector local[LOCAL_STACK_SIZE];
+        TVector *stack = local;
+        void *heap = 0;
+        const int size = maxDepth + tempsCount;
+        if (size > LOCAL_STACK_SIZE) {
+          if (0!= posix_memalign(&heap, sizeof(TVector), size*sizeof(TVector)))
+            return false;
+          stack = static_cast<TVector *>(heap);
+        }
+        TVector *temps = stack + maxDepth;
+
+        // Bit-sliced counters of satisfied formulas
+        TVector plane[PLANES];
+        int used = 0;
+        int stored = 0;
+
+        const TVector ones = TOps::ones();
+        int sp = 0;
+        for(int i=0; i<length; i++) {
+          const Instruction &instr = program[i];
+          switch (instr.opCode) {
+            case OP_FALSE:
+              stack[sp++] = TOps::zero();
+              break;
+
+            case OP_TRUE:
+              stack[sp++] = ones;
+              break;
+
+            case OP_VAR:
+              stack[sp++] = TOps::load(vars + instr.var*WIDTH);
+              break;
+
+            case OP_LOAD:
+              stack[sp++] = temps[instr.var];
+              break;
+
+            case OP_STORE:
+              temps[instr.var] = stack[sp-1];
+              break;
+
+            case OP_NOT:
+              stack[sp-1] = TOps::bitXor(stack[sp-1], ones);
+              break;
+
+            case OP_AND:
+              sp--;
+              stack[sp-1] = TOps::bitAnd(stack[sp-1], stack[sp]);
+              break;
+
+            case OP_OR:
+              sp--;
+              stack[sp-1] = TOps::bitOr(stack[sp-1], stack[sp]);
+              break;
+
+            case OP_XOR:
+              sp--;
+              stack[sp-1] = TOps::bitXor(stack[sp-1], stack[sp]);
+              break;
+
+            case OP_COUNT:
+              if (masks) {
+                // Store value of formula
+                TOps::store(masks + formulas[stored++]*WIDTH, stack[--sp]);
+                break;
+              }
+              {
+                // Ripple-carry addition of one bit to each lane
+                TVector carry = stack[--sp];
+                for(int k=0; !TOps::isZero(carry); k++) {
+                  assert(k < PLANES);
+                  if (k == used)
+                    plane[used++] = TOps::zero();
+                  const TVector next = TOps::bitAnd(plane[k], carry);
+                  plane[k] = TOps::bitXor(plane[k], carry);
+                  carry = next;
+                }
+              }
+              break;
+          }
+        }
+        assert(0 == sp);
+        free(heap);
+        if (masks)
+          return true;
+
+        // Spread planes to counters (one counter per word)
+        TLaneMask buffer[PLANES * WIDTH];
+        for(int k=0; k<used; k++)
+          TOps::store(buffer + k*WIDTH, plane[k]);
+        for(int w=0; w<WIDTH; w++)
+          counters[w].load(buffer + w, used, WIDTH);
+        return true;
+      }
+
+      static const int WIDTH = sizeof(TVector)/sizeof(TLaneMask);
+      static const int PLANES = sizeof(int) * CHAR_BIT;
+      static const int LOCAL_STACK_SIZE = 64;
+      const char *name_;
+  };
+
+#ifdef HAVE_SSE2
+  /**
+   * @brief @return Returns on heap allocated 128-bit kernel using SSE2.
+   * @ingroup SatProblem
+   */
+  ILaneKernel* createLaneKernelSse2();
+#endif
+
+#ifdef HAVE_AVX2
+  /**
+   * @brief @return Returns on heap allocated 256-bit kernel using AVX2.
+   * @ingroup SatProblem
+   */
+  ILaneKernel* createLaneKernelAvx2();
+#endif
+
+#ifdef HAVE_AVX512
+  /**
+   * @brief @return Returns on heap allocated 512-bit kernel using AVX-512.
+   * @ingroup SatProblem
+   */
+  ILaneKernel* createLaneKernelAvx512();
+#endif
+
+} // namespace FastSatSolver
+
+#endif // LANEKERNELIMPL_H
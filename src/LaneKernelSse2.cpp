@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifdef HAVE_SSE2
+
+#include <emmintrin.h>
+#include "LaneKernelImpl.h"
+
+namespace FastSatSolver {
+
+  namespace {
+    // 128-bit vector operations (SSE2)
+    struct Sse2Ops {
+      typedef __m128i TVector;
+      static TVector zero() {
+        return _mm_setzero_si128();
+      }
+      static TVector ones() {
+        return _mm_set1_epi32(-1);
+      }
+      static TVector load(const TLaneMask *ptr) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+      }
+      static void store(TLaneMask *ptr, TVector v) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(ptr), v);
+      }
+      static TVector bitAnd(TVector a, TVector b) {
+        return _mm_and_si128(a, b);
+      }
+      static TVector bitOr(TVector a, TVector b) {
+        return _mm_or_si128(a, b);
+      }
+      static TVector bitXor(TVector a, TVector b) {
+        return _mm_xor_si128(a, b);
+      }
+      static bool isZero(TVector v) {
+        const TVector eq = _mm_cmpeq_epi8(v, _mm_setzero_si128());
+        return 0xFFFF == _mm_movemask_epi8(eq);
+      }
+    };
+  } // namespace
+
+  ILaneKernel* createLaneKernelSse2() {
+    return new LaneKernelImpl<Sse2Ops>("sse2");
+  }
+
+} // namespace FastSatSolver
+
+#endif // HAVE_SSE2
@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <assert.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+#include "fssIO.h"
+#include "SatProblem.h"
+#include "FormulaIndex.h"
+#include "LocalSearchSatSolver.h"
+
+namespace FastSatSolver {
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // LocalSearchSatSolver implementation
+  struct LocalSearchSatSolver::Private {
+    static const int STEP_FLIPS = 1<<12;    ///< flips between notifications
+    static const int TABU_TENURE = 10;      ///< maximal count of flips a variable is tabu
+
+    SatProblem                *problem;
+    long                      maxFlips;
+    float                     noise;
+    SatItemSet                resultSet;
+    FormulaIndex              index;
+    int                       satsOffset;   ///< count of tautologies
+    int                       formulasCount;
+    std::vector<char>         stack;
+    std::vector<char>         occFlip;      ///< value of formula if variable is flipped
+
+    // Current state
+    std::vector<char>         assigns;
+    std::vector<char>         value;        ///< value of each formula
+    std::vector<int>          makeCount;
+    std::vector<int>          breakCount;
+    std::vector<int>          unsat;        ///< unsatisfied formulas
+    std::vector<int>          unsatPos;     ///< position in unsat, -1 if satisfied
+    std::vector<int>          candidates;   ///< occurrences in chosen formula
+    std::vector<long>         lastFlip;     ///< flip number of last flip of variable
+    long                      tabuTenure;
+    unsigned long             rnd;
+
+    // Statistics
+    long                      flips;
+    float                     minFitness;
+    float                     maxFitness;
+    double                    sumFitness;
+    long                      samples;
+
+    Private(SatProblem *problem_, long maxFlips_, float noise_);
+
+    // xorshift pseudo-random generator, independent of other solvers
+    unsigned long random() {
+      rnd ^= rnd << 13;
+      rnd ^= rnd >> 7;
+      rnd ^= rnd << 17;
+      return rnd;
+    }
+    bool eval(int formula, int flipVar) {
+      return index.eval(formula, &assigns[0], flipVar, &stack[0]);
+    }
+    void contribute(int occ, int delta) {
+      const int f = index.getOccFormula(occ);
+      if (value[f] && !occFlip[occ])
+        breakCount[index.getOccVar(occ)] += delta;
+      else if (!value[f] && occFlip[occ])
+        makeCount[index.getOccVar(occ)] += delta;
+    }
+    void setValue(int formula, bool val);
+    void update(int formula);
+    void flip(int var);
+    int bestVar(bool satisfying) const;
+    int pickVar(int formula);
+    float currentFitness() const {
+      const int sats = static_cast<int>(value.size() - unsat.size()) + satsOffset;
+      return static_cast<float>(sats)/formulasCount;
+    }
+    bool isSolution() const {
+      return unsat.empty() &&
+        static_cast<int>(value.size()) + satsOffset == formulasCount;
+    }
+    void init();
+  };
+  LocalSearchSatSolver::Private::Private(SatProblem *problem_, long maxFlips_, float noise_):
+    problem(problem_),
+    maxFlips(maxFlips_),
+    noise(noise_),
+    index(problem_),
+    rnd(0)
+  {
+    formulasCount = problem->getFormulasCount();
+    satsOffset = index.getSatsOffset();
+    stack.resize(index.getStackSize());
+    const int varsCount = index.getVarsCount();
+    occFlip.resize(index.getOccurrencesCount());
+    const int count = index.getFormulasCount();
+    value.resize(count);
+    unsatPos.resize(count);
+    assigns.resize(varsCount);
+    lastFlip.resize(varsCount);
+    tabuTenure = std::min(static_cast<int>(TABU_TENURE), varsCount/10);
+    makeCount.resize(varsCount);
+    breakCount.resize(varsCount);
+  }
+  void LocalSearchSatSolver::Private::setValue(int formula, bool val) {
+    value[formula] = val;
+    const int pos = unsatPos[formula];
+    if (val && 0 <= pos) {
+      // Remove from list of unsatisfied formulas
+      const int last = unsat.back();
+      unsat[pos] = last;
+      unsatPos[last] = pos;
+      unsat.pop_back();
+      unsatPos[formula] = -1;
+    } else if (!val && pos < 0) {
+      unsatPos[formula] = unsat.size();
+      unsat.push_back(formula);
+    }
+  }
+  void LocalSearchSatSolver::Private::update(int formula) {
+    const int begin = index.getOccBegin(formula);
+    const int end = index.getOccEnd(formula);
+    for(int o=begin; o<end; o++)
+      contribute(o, -1);
+    setValue(formula, eval(formula, -1));
+    for(int o=begin; o<end; o++) {
+      occFlip[o] = eval(formula, index.getOccVar(o));
+      contribute(o, +1);
+    }
+  }
+  void LocalSearchSatSolver::Private::flip(int var) {
+    assigns[var] ^= 1;
+    lastFlip[var] = flips;
+    const std::vector<int> &occs = index.getVarOccurrences(var);
+    for(unsigned i=0; i<occs.size(); i++)
+      update(index.getOccFormula(occs[i]));
+    flips++;
+  }
+  int LocalSearchSatSolver::Private::bestVar(bool satisfying) const {
+    // Select variable with least break (and most make) score, variables
+    // flipped recently are tabu (unless the move is free)
+    int best = -1;
+    for(unsigned i=0; i<candidates.size(); i++) {
+      const int occ = candidates[i];
+      const int var = index.getOccVar(occ);
+      if (satisfying && !occFlip[occ])
+        continue;
+      if (flips - lastFlip[var] <= tabuTenure && 0 < breakCount[var])
+        continue;
+      if (best < 0 || breakCount[var] < breakCount[best] ||
+          (breakCount[var] == breakCount[best] && makeCount[var] > makeCount[best]))
+        best = var;
+    }
+    return best;
+  }
+  int LocalSearchSatSolver::Private::pickVar(int formula) {
+    candidates.clear();
+    for(int o=index.getOccBegin(formula); o<index.getOccEnd(formula); o++)
+      candidates.push_back(o);
+
+    // Prefer variables whose flip satisfies the formula
+    const int best = bestVar(true);
+    if (0 <= best && 0 == breakCount[best])
+      // Free move
+      return best;
+
+    // Random walk
+    const double r = static_cast<double>(random() % 1000000) / 1000000.0;
+    if (r < noise)
+      return index.getOccVar(candidates[random() % candidates.size()]);
+    if (0 <= best)
+      return best;
+
+    // Formula needs more flips to be satisfied (or all candidates are tabu)
+    const int any = bestVar(false);
+    if (0 <= any)
+      return any;
+    int oldest = index.getOccVar(candidates[0]);
+    for(unsigned i=1; i<candidates.size(); i++)
+      if (lastFlip[index.getOccVar(candidates[i])] < lastFlip[oldest])
+        oldest = index.getOccVar(candidates[i]);
+    return oldest;
+  }
+  void LocalSearchSatSolver::Private::init() {
+    // Solutions are kept among runs (incremental strategy)
+    flips = 0;
+    minFitness = INFINITY;
+    maxFitness = 0.0;
+    sumFitness = 0.0;
+    samples = 0;
+
+    // Seed generator (differently for each instance and run)
+    static unsigned long counter = 0;
+    rnd = static_cast<unsigned long>(time(0)) ^ (static_cast<unsigned long>(clock()) << 16)
+      ^ (++counter * 0x9E3779B9UL);
+    if (!rnd)
+      rnd = 1;
+
+    // Random initial assignment
+    for(unsigned i=0; i<assigns.size(); i++) {
+      assigns[i] = random() & 1;
+      lastFlip[i] = -tabuTenure-1;
+    }
+
+    // Evaluate all formulas and compute scores from scratch
+    std::fill(makeCount.begin(), makeCount.end(), 0);
+    std::fill(breakCount.begin(), breakCount.end(), 0);
+    unsat.clear();
+    for(unsigned f=0; f<value.size(); f++) {
+      unsatPos[f] = -1;
+      value[f] = 1;
+      setValue(f, eval(f, -1));
+      for(int o=index.getOccBegin(f); o<index.getOccEnd(f); o++) {
+        occFlip[o] = eval(f, index.getOccVar(o));
+        contribute(o, +1);
+      }
+    }
+  }
+
+  LocalSearchSatSolver::LocalSearchSatSolver(SatProblem *problem, long maxFlips, float noise):
+    d(new Private(problem, maxFlips, noise))
+  {
+    d->init();
+  }
+  LocalSearchSatSolver::~LocalSearchSatSolver() {
+    delete d;
+  }
+  SatProblem* LocalSearchSatSolver::getProblem() {
+    return d->problem;
+  }
+  int LocalSearchSatSolver::getSolutionsCount() {
+    return d->resultSet.getLength();
+  }
+  SatItemVector* LocalSearchSatSolver::getSolutionVector() {
+    return d->resultSet.createVector();
+  }
+  float LocalSearchSatSolver::minFitness() {
+    return d->minFitness;
+  }
+  float LocalSearchSatSolver::avgFitness() {
+    return (d->samples)
+      ? d->sumFitness / d->samples
+      : 0.0;
+  }
+  float LocalSearchSatSolver::maxFitness() {
+    return d->maxFitness;
+  }
+  long LocalSearchSatSolver::getFlipsCount() {
+    return d->flips;
+  }
+  // protected
+  void LocalSearchSatSolver::initialize() {
+    d->init();
+  }
+  // protected
+  void LocalSearchSatSolver::doStep() {
+    bool found = false;
+    if (0 == d->flips)
+      // Initial assignment can be solution as well
+      found = this->checkSolution();
+
+    // Return after each new solution, so that solver can be stopped
+    for(int i=0; !found && i<Private::STEP_FLIPS && d->flips < d->maxFlips; i++) {
+      if (d->unsat.empty()) {
+        if (!d->isSolution() || d->assigns.empty())
+          // Contradiction was removed from program, no solution exists
+          break;
+
+        // Walk away from solution already found
+        d->flip(d->random() % d->assigns.size());
+      } else {
+        const int formula = d->unsat[d->random() % d->unsat.size()];
+        d->flip(d->pickVar(formula));
+      }
+      found = this->checkSolution();
+    }
+
+    // Sample fitness of current assignment
+    const float fitness = d->currentFitness();
+    if (fitness < d->minFitness)
+      d->minFitness = fitness;
+    d->sumFitness += fitness;
+    d->samples++;
+
+    if (d->flips >= d->maxFlips || (d->unsat.empty() && !d->isSolution()))
+      this->stop();
+  }
+  // private
+  bool LocalSearchSatSolver::checkSolution() {
+    const float fitness = d->currentFitness();
+    if (fitness > d->maxFitness) {
+      d->maxFitness = fitness;
+      this->notify();
+    }
+    if (!d->isSolution())
+      return false;
+    const int count = d->resultSet.getLength();
+    std::vector<bool> data(d->assigns.begin(), d->assigns.end());
+    d->resultSet.addItem(new VectorSatItem(data));
+    if (count == d->resultSet.getLength())
+      // Solution already known
+      return false;
+    this->notify();
+    return true;
+  }
+
+} // namespace FastSatSolver
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LOCALSEARCHSATSOLVER_H
+#define LOCALSEARCHSATSOLVER_H
+
+/**
+ * @file LocalSearchSatSolver.h
+ * @brief LocalSearchSatSolver class using stochastic local search to solve
+ * SAT problem.
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-15
+ * @ingroup SatSolver
+ */
+
+#include "SatSolver.h"
+
+namespace FastSatSolver {
+  class SatProblem;
+
+  /**
+   * Solver keeps one assignment of variables and repeatedly flips a variable
+   * of randomly chosen unsatisfied formula (WalkSAT strategy generalized to
+   * non-clausal formulas). Variables whose flip satisfies the chosen formula
+   * are preferred. Among them a variable breaking no satisfied formula is
+   * flipped if there is any, otherwise random one (with probability noise)
+   * or the one breaking fewest formulas.
+   *
+   * Each variable has its make (count of unsatisfied formulas satisfied by
+   * its flip) and break (count of satisfied formulas unsatisfied by its
+   * flip) score. Scores are updated incrementally by reevaluating only
+   * formulas containing flipped variable.
+   * @brief Incomplete solver using stochastic local search.
+   * @ingroup SatSolver
+   */
+  class LocalSearchSatSolver: public AbstractSatSolver
+  {
+    public:
+      /**
+       * @param problem SatProblem instance containing SAT problem to solve.
+       * @param maxFlips Maximal count of flips in one run (restart is done
+       * by reset()).
+       * @param noise Probability of random walk, in range <0, 1>.
+       */
+      LocalSearchSatSolver(SatProblem *problem, long maxFlips, float noise);
+      virtual ~LocalSearchSatSolver();
+      virtual SatProblem* getProblem();
+      virtual int getSolutionsCount();
+      virtual SatItemVector* getSolutionVector();
+
+      /**
+       * @brief Fitness is computed for current assignment at the end of each
+       * step, maximum is tracked after each flip.
+       */
+      virtual float minFitness();
+      virtual float avgFitness();
+      virtual float maxFitness();
+
+      /**
+       * @brief @return Returns count of flips since initialization.
+       */
+      long getFlipsCount();
+
+    protected:
+      virtual void initialize();
+      virtual void doStep();
+
+    private:
+      // Update maximal fitness and store current assignment if it is solution,
+      // return true if the solution was not found yet
+      bool checkSolution();
+
+      struct Private;
+      Private *d;
+  };
+
+} // namespace FastSatSolver
+
+#endif // LOCALSEARCHSATSOLVER_H
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <string.h>
+#include <dlfcn.h>
+#include "fssIO.h"
+#include "FormulaCode.h"
+#include "NativeModule.h"
+
+namespace FastSatSolver {
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // NativeModule implementation
+  const char NativeModule::EVAL_SYMBOL[]        = "fss_eval";
+  const char NativeModule::FINGERPRINT_SYMBOL[] = "fss_fingerprint";
+
+  unsigned NativeModule::fingerprint(const FormulaCode &program) {
+    // FNV-1a hash of instructions
+    unsigned hash = 2166136261U;
+    const Instruction *data = program.getData();
+    const int length = program.getLength();
+    for(int i=0; i<length; i++) {
+      const unsigned word[2] = {
+        static_cast<unsigned>(data[i].opCode),
+        static_cast<unsigned>(data[i].var)
+      };
+      for(int j=0; j<2; j++)
+        for(int k=0; k<4; k++) {
+          hash ^= (word[j] >> (8*k)) & 0xFFU;
+          hash *= 16777619U;
+        }
+    }
+    return hash & 0xFFFFFFFFU;
+  }
+
+  void NativeModule::writeSource(SatProblem *problem, std::ostream &out) {
+    const FormulaCode &program = problem->getProgram();
+    const Instruction *data = program.getData();
+    const int length = program.getLength();
+    const int maxDepth = program.getMaxDepth();
+    const int tempsCount = program.getTempsCount();
+
+    // Header
+    out << "// Generated by fss-compile, do not edit." << std::endl
+      << "// " << problem->getVarsCount() << " variables, "
+      << problem->getFormulasCount() << " formulas" << std::endl
+      << "#include <limits.h>" << std::endl
+      << std::endl
+      << "// Module expects the same word size as its generator" << std::endl
+      << "typedef char fss_word_check[(sizeof(unsigned long)*CHAR_BIT == "
+      << LANE_BITS << ") ? 1 : -1];" << std::endl
+      << std::endl
+      << "extern \"C\" unsigned " << FINGERPRINT_SYMBOL << "() {" << std::endl
+      << "  return 0x" << std::hex << fingerprint(program) << std::dec << "U;" << std::endl
+      << "}" << std::endl
+      << std::endl
+      << "extern \"C\" int " << EVAL_SYMBOL << "(const unsigned long *v) {" << std::endl;
+
+    // Runtime stack is mapped to local variables
+    if (maxDepth) {
+      out << "  unsigned long";
+      for(int i=0; i<maxDepth; i++)
+        out << ((i) ? ", s" : " s") << i;
+      out << ";" << std::endl;
+    }
+    if (tempsCount) {
+      out << "  unsigned long";
+      for(int i=0; i<tempsCount; i++)
+        out << ((i) ? ", t" : " t") << i;
+      out << ";" << std::endl;
+    }
+    out << "  int n = 0;" << std::endl;
+
+    // Straight-line code
+    int depth = 0;
+    int formula = 0;
+    for(int i=0; i<length; i++) {
+      const Instruction &instr = data[i];
+      if (0==depth)
+        out << std::endl << "  // formula " << ++formula << std::endl;
+      switch (instr.opCode) {
+        case OP_FALSE:
+          out << "  s" << depth++ << " = 0UL;" << std::endl;
+          break;
+        case OP_TRUE:
+          out << "  s" << depth++ << " = 1UL;" << std::endl;
+          break;
+        case OP_VAR:
+          out << "  s" << depth++ << " = (v[" << instr.var/LANE_BITS
+            << "] >> " << instr.var%LANE_BITS << ") & 1UL;"
+            << " // " << problem->getVarName(instr.var) << std::endl;
+          break;
+        case OP_LOAD:
+          out << "  s" << depth++ << " = t" << instr.var << ";" << std::endl;
+          break;
+        case OP_STORE:
+          out << "  t" << instr.var << " = s" << depth-1 << ";" << std::endl;
+          break;
+        case OP_NOT:
+          out << "  s" << depth-1 << " ^= 1UL;" << std::endl;
+          break;
+        case OP_AND:
+        case OP_OR:
+        case OP_XOR:
+          depth--;
+          out << "  s" << depth-1 << " "
+            << ((OP_AND==instr.opCode) ? '&' : (OP_OR==instr.opCode) ? '|' : '^')
+            << "= s" << depth << ";" << std::endl;
+          break;
+        case OP_COUNT:
+          out << "  n += static_cast<int>(s" << --depth << ");" << std::endl;
+          break;
+      }
+    }
+    out << std::endl
+      << "  return n;" << std::endl
+      << "}" << std::endl;
+  }
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // NativeModuleEvaluator implementation
+  struct NativeModuleEvaluator::Private {
+    typedef int (*TEvalFnc)(const TLaneMask *);
+    typedef unsigned (*TFingerprintFnc)();
+    void          *handle;
+    TEvalFnc      evalFnc;
+
+    // Look up function of given name
+    template <typename TFnc>
+      void resolve(const char *name, TFnc &fnc);
+  };
+  template <typename TFnc>
+    void NativeModuleEvaluator::Private::resolve(const char *name, TFnc &fnc)
+  {
+    void *sym = dlsym(this->handle, name);
+    if (!sym) {
+      std::string text("NativeModuleEvaluator: ");
+      text += dlerror();
+      throw GenericException(text);
+    }
+    // ISO C++ does not allow direct cast from object pointer to function
+    memcpy(&fnc, &sym, sizeof(fnc));
+  }
+  NativeModuleEvaluator::NativeModuleEvaluator(const std::string &fileName, SatProblem *problem):
+    d(new Private)
+  {
+    d->handle = dlopen(fileName.c_str(), RTLD_NOW|RTLD_LOCAL);
+    if (!d->handle) {
+      std::string text("NativeModuleEvaluator: ");
+      text += dlerror();
+      delete d;
+      throw GenericException(text);
+    }
+    try {
+      Private::TFingerprintFnc fingerprintFnc;
+      d->resolve(NativeModule::FINGERPRINT_SYMBOL, fingerprintFnc);
+      d->resolve(NativeModule::EVAL_SYMBOL, d->evalFnc);
+      if (fingerprintFnc() != NativeModule::fingerprint(problem->getProgram()))
+        throw GenericException(
+            "NativeModuleEvaluator: module '" + fileName +
+            "' was generated for another problem");
+    }
+    catch (GenericException &) {
+      dlclose(d->handle);
+      delete d;
+      throw;
+    }
+  }
+  NativeModuleEvaluator::~NativeModuleEvaluator() {
+    dlclose(d->handle);
+    delete d;
+  }
+  int NativeModuleEvaluator::evalPacked (const TLaneMask *packed) {
+    return d->evalFnc(packed);
+  }
+
+} // namespace FastSatSolver
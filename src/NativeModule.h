@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef NATIVEMODULE_H
+#define NATIVEMODULE_H
+
+/**
+ * @file NativeModule.h
+ * @brief Ahead-of-time compilation of formulas to shared object
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-10
+ * @ingroup SatProblem
+ */
+
+#include <iostream>
+#include <string>
+#include "SatProblem.h"
+
+namespace FastSatSolver {
+  class FormulaCode;
+
+  /**
+   * Module is C++ source with straight-line evaluation code of all formulas.
+   * Once built to shared object by system compiler (consider fss-compile
+   * tool), it can be loaded by NativeModuleEvaluator.
+   * @brief Generator of native module's source code.
+   * @ingroup SatProblem
+   */
+  class NativeModule {
+    public:
+      /**
+       * @brief Write C++ source of module evaluating given problem.
+       * @param problem SAT problem to generate module for.
+       * @param streamTo Output stream to write source to.
+       */
+      static void writeSource(SatProblem *problem, std::ostream &streamTo);
+
+      /**
+       * @brief @return Returns fingerprint of program used to check that
+       * loaded module matches given problem.
+       * @param program Bytecode of all formulas.
+       */
+      static unsigned fingerprint(const FormulaCode &program);
+
+      static const char EVAL_SYMBOL[];          ///< evaluation function
+      static const char FINGERPRINT_SYMBOL[];   ///< fingerprint function
+  };
+
+  /**
+   * @brief Container evaluator using native module loaded by dlopen().
+   * @ingroup SatProblem
+   */
+  class NativeModuleEvaluator: public IContainerEvaluator {
+    public:
+      /**
+       * @param fileName Shared object built from NativeModule's source.
+       * @param problem SAT problem the module was generated for.
+       * @throw GenericException Module can't be loaded or it was generated
+       * for another problem.
+       */
+      NativeModuleEvaluator(const std::string &fileName, SatProblem *problem);
+      virtual ~NativeModuleEvaluator();
+
+      virtual int evalPacked (const TLaneMask *packed);
+
+    private:
+      struct Private;
+      Private *d;
+  };
+
+} // namespace FastSatSolver
+
+#endif // NATIVEMODULE_H
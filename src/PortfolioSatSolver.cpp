@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <pthread.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <vector>
+#include "SatProblem.h"
+#include "PortfolioSatSolver.h"
+
+namespace FastSatSolver {
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // PortfolioSatSolver::Private declaration
+  struct PortfolioSatSolver::Private {
+    static const int WAIT_MS = 100;   ///< max. period of notifications
+    struct Member;
+
+    SatProblem                *problem;
+    int                       maxSolutions;
+    std::vector<Member *>     members;
+    SatItemSet                resultSet;    ///< merged solutions
+    float                     maxFitness;
+    bool                      exhausted;
+
+    // Threads of solvers
+    pthread_mutex_t           mutex;        ///< guards all of the state
+    pthread_cond_t            changeCond;
+    bool                      started;
+    bool                      cancelled;
+    bool                      changed;      ///< not seen by doStep() yet
+    int                       running;      ///< count of solvers not finished
+
+    Private(SatProblem *problem_, int maxSolutions_);
+    ~Private();
+    void startThreads();
+    void stopThreads();
+    static void* threadMain(void *);
+
+    // Called from solver's thread with mutex locked
+    void update(Member *, bool force);
+    void merge(Member *);
+  };
+
+  /**
+   * Member observes its solver, so that its notifications are handled
+   * in solver's own thread. Solutions are copied from solver only when
+   * its count of solutions doubles, or when merged solutions could reach
+   * maxSolutions, which keeps the cost of merging linear.
+   */
+  struct PortfolioSatSolver::Private::Member: public IObserver {
+    Private                   *d;
+    AbstractSatSolver         *solver;
+    bool                      complete;
+    pthread_t                 thread;
+    bool                      joinable;
+    bool                      finished;
+    bool                      cancelled;    ///< stopped by portfolio
+    int                       merged;       ///< count of solutions merged
+    float                     minFitness;
+    float                     avgFitness;
+
+    Member(Private *d_, AbstractSatSolver *solver_, bool complete_):
+      d(d_),
+      solver(solver_),
+      complete(complete_),
+      joinable(false),
+      finished(false),
+      cancelled(false)
+    {
+      this->init();
+    }
+    void init() {
+      merged = 0;
+      minFitness = 0.0;
+      avgFitness = 0.0;
+    }
+    virtual void notify() {
+      pthread_mutex_lock(&d->mutex);
+      d->update(this, false);
+      pthread_mutex_unlock(&d->mutex);
+    }
+  };
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // PortfolioSatSolver::Private implementation
+  PortfolioSatSolver::Private::Private(SatProblem *problem_, int maxSolutions_):
+    problem(problem_),
+    maxSolutions(maxSolutions_),
+    maxFitness(0.0),
+    exhausted(false),
+    started(false),
+    cancelled(false),
+    changed(false),
+    running(0)
+  {
+    pthread_mutex_init(&mutex, 0);
+    pthread_cond_init(&changeCond, 0);
+  }
+  PortfolioSatSolver::Private::~Private() {
+    this->stopThreads();
+    for(unsigned i=0; i<members.size(); i++) {
+      delete members[i]->solver;
+      delete members[i];
+    }
+    pthread_cond_destroy(&changeCond);
+    pthread_mutex_destroy(&mutex);
+  }
+  void PortfolioSatSolver::Private::startThreads() {
+    started = true;
+    cancelled = false;
+    running = members.size();
+    for(unsigned i=0; i<members.size(); i++) {
+      Member *member = members[i];
+      member->finished = false;
+      member->cancelled = false;
+    }
+    for(unsigned i=0; i<members.size(); i++) {
+      Member *member = members[i];
+      member->joinable = (0== pthread_create(&member->thread, 0, threadMain, member));
+      if (!member->joinable) {
+        // Race without this solver
+        pthread_mutex_lock(&mutex);
+        member->finished = true;
+        running--;
+        pthread_mutex_unlock(&mutex);
+      }
+    }
+  }
+  void PortfolioSatSolver::Private::stopThreads() {
+    if (!started)
+      return;
+    pthread_mutex_lock(&mutex);
+    cancelled = true;
+    pthread_mutex_unlock(&mutex);
+    for(unsigned i=0; i<members.size(); i++) {
+      Member *member = members[i];
+      if (member->joinable)
+        pthread_join(member->thread, 0);
+      member->joinable = false;
+    }
+    started = false;
+  }
+  void* PortfolioSatSolver::Private::threadMain(void *arg) {
+    Member *member = static_cast<Member *>(arg);
+    Private *d = member->d;
+    member->solver->start();
+
+    pthread_mutex_lock(&d->mutex);
+    member->finished = true;
+    d->update(member, true);
+    if (member->complete && !member->cancelled
+        && member->merged == member->solver->getSolutionsCount()) {
+      // All solutions are known now
+      d->exhausted = true;
+      d->cancelled = true;
+    }
+    d->running--;
+    d->changed = true;
+    pthread_cond_signal(&d->changeCond);
+    pthread_mutex_unlock(&d->mutex);
+    return 0;
+  }
+  void PortfolioSatSolver::Private::update(Member *member, bool force) {
+    AbstractSatSolver *solver = member->solver;
+    const int count = solver->getSolutionsCount();
+    if (member->merged < count && (force
+          || count >= 2*member->merged
+          || resultSet.getLength() + count - member->merged >= maxSolutions))
+      this->merge(member);
+
+    const float fitness = solver->maxFitness();
+    if (fitness > maxFitness) {
+      maxFitness = fitness;
+      changed = true;
+    }
+    member->minFitness = solver->minFitness();
+    member->avgFitness = solver->avgFitness();
+
+    if (resultSet.getLength() >= maxSolutions)
+      cancelled = true;
+    if (cancelled && !member->cancelled && !member->finished) {
+      member->cancelled = true;
+      solver->stop();
+    }
+    if (changed)
+      pthread_cond_signal(&changeCond);
+  }
+  void PortfolioSatSolver::Private::merge(Member *member) {
+    const int before = resultSet.getLength();
+    if (before >= maxSolutions)
+      // Quota of portfolio reached, members may not stop at once
+      return;
+    SatItemVector *vect = member->solver->getSolutionVector();
+    const int length = vect->getLength();
+    int i;
+    for(i=0; i<length && resultSet.getLength() < maxSolutions; i++)
+      resultSet.addItem(vect->getItem(i)->clone());
+    delete vect;
+    member->merged = i;
+    if (resultSet.getLength() != before)
+      changed = true;
+  }
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // PortfolioSatSolver implementation
+  PortfolioSatSolver::PortfolioSatSolver(SatProblem *problem, int maxSolutions):
+    d(new Private(problem, maxSolutions))
+  {
+  }
+  PortfolioSatSolver::~PortfolioSatSolver() {
+    delete d;
+  }
+  void PortfolioSatSolver::addSolver(AbstractSatSolver *solver, bool complete) {
+    Private::Member *member = new Private::Member(d, solver, complete);
+    solver->addObserver(member);
+    d->members.push_back(member);
+  }
+  int PortfolioSatSolver::getSolversCount() {
+    return d->members.size();
+  }
+  AbstractSatSolver* PortfolioSatSolver::getSolver(int index) {
+    return d->members[index]->solver;
+  }
+  SatProblem* PortfolioSatSolver::getProblem() {
+    return d->problem;
+  }
+  int PortfolioSatSolver::getSolutionsCount() {
+    pthread_mutex_lock(&d->mutex);
+    const int count = d->resultSet.getLength();
+    pthread_mutex_unlock(&d->mutex);
+    return count;
+  }
+  SatItemVector* PortfolioSatSolver::getSolutionVector() {
+    pthread_mutex_lock(&d->mutex);
+    SatItemVector *vect = d->resultSet.createVector();
+    pthread_mutex_unlock(&d->mutex);
+    return vect;
+  }
+  float PortfolioSatSolver::minFitness() {
+    pthread_mutex_lock(&d->mutex);
+    float fitness = d->maxFitness;
+    for(unsigned i=0; i<d->members.size(); i++)
+      fitness = std::min(fitness, d->members[i]->minFitness);
+    pthread_mutex_unlock(&d->mutex);
+    return fitness;
+  }
+  float PortfolioSatSolver::avgFitness() {
+    pthread_mutex_lock(&d->mutex);
+    float sum = 0.0;
+    const int count = d->members.size();
+    for(int i=0; i<count; i++)
+      sum += d->members[i]->avgFitness;
+    pthread_mutex_unlock(&d->mutex);
+    return (count)
+      ? sum / count
+      : 0.0;
+  }
+  float PortfolioSatSolver::maxFitness() {
+    pthread_mutex_lock(&d->mutex);
+    const float fitness = d->maxFitness;
+    pthread_mutex_unlock(&d->mutex);
+    return fitness;
+  }
+  void PortfolioSatSolver::stop() {
+    d->stopThreads();
+    // Delegate to base
+    AbstractSatSolver::stop();
+  }
+  bool PortfolioSatSolver::isExhausted() {
+    pthread_mutex_lock(&d->mutex);
+    const bool exhausted = d->exhausted;
+    pthread_mutex_unlock(&d->mutex);
+    return exhausted;
+  }
+  // protected
+  void PortfolioSatSolver::initialize() {
+    d->stopThreads();
+    for(unsigned i=0; i<d->members.size(); i++) {
+      d->members[i]->init();
+      d->members[i]->solver->reset();
+    }
+    // Now using incremental strategy (as GaSatSolver does)
+    d->maxFitness = 0.0;
+    d->exhausted = false;
+    d->cancelled = false;
+    d->changed = false;
+  }
+  // protected
+  void PortfolioSatSolver::doStep() {
+    if (!d->started)
+      d->startThreads();
+
+    // Wait for change, but notify observers at least once per WAIT_MS
+    struct timeval now;
+    gettimeofday(&now, 0);
+    long usec = now.tv_usec + Private::WAIT_MS * 1000L;
+    struct timespec timeout;
+    timeout.tv_sec = now.tv_sec + usec / 1000000L;
+    timeout.tv_nsec = (usec % 1000000L) * 1000L;
+
+    pthread_mutex_lock(&d->mutex);
+    if (!d->changed && d->running)
+      pthread_cond_timedwait(&d->changeCond, &d->mutex, &timeout);
+    d->changed = false;
+    const bool done = !d->running;
+    pthread_mutex_unlock(&d->mutex);
+
+    if (done)
+      this->stop();
+  }
+
+} // namespace FastSatSolver
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PORTFOLIOSATSOLVER_H
+#define PORTFOLIOSATSOLVER_H
+
+/**
+ * @file PortfolioSatSolver.h
+ * @brief PortfolioSatSolver class racing several solvers in parallel.
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-19
+ * @ingroup SatSolver
+ */
+
+#include "SatSolver.h"
+
+namespace FastSatSolver {
+  class SatProblem;
+
+  /**
+   * Each solver added to portfolio runs in its own thread against the same
+   * SatProblem instance. Solutions found by solvers are merged to one set.
+   * Once the merged set reaches desired count of solutions, or a complete
+   * solver finishes, the rest of solvers is cancelled. Solvers are always
+   * stopped in their own threads (in the middle of their notifications).
+   * Portfolio itself notifies its observers from thread calling start(),
+   * whenever anything changes, but at least once per 100 ms.
+   * @attention Evaluator of shared SatProblem has to be reentrant, which is
+   * not true for ShortCircuitEvaluator.
+   * @brief Solver racing several solvers in parallel threads.
+   * @ingroup SatSolver
+   */
+  class PortfolioSatSolver: public AbstractSatSolver
+  {
+    public:
+      /**
+       * @param problem SatProblem instance shared by all solvers.
+       * @param maxSolutions Count of merged solutions, which cancels the
+       * rest of solvers.
+       */
+      PortfolioSatSolver(SatProblem *problem, int maxSolutions);
+      virtual ~PortfolioSatSolver();
+
+      /**
+       * @brief Add solver to portfolio.
+       * @param solver Solver working on the same SatProblem instance.
+       * @param complete True if solver stops only once it has found all
+       * solutions. Its finish cancels the rest of solvers then.
+       * @attention On heap allocated object is expected. It will be deleted
+       * by portfolio's destructor.
+       */
+      void addSolver(AbstractSatSolver *solver, bool complete);
+
+      /**
+       * @brief @return Returns count of solvers in portfolio.
+       */
+      int getSolversCount();
+
+      /**
+       * @brief @return Returns solver added to portfolio.
+       * @param index Index value has to be in range <0, getSolversCount()-1>.
+       */
+      AbstractSatSolver* getSolver(int index);
+
+      virtual SatProblem* getProblem();
+      virtual int getSolutionsCount();
+      virtual SatItemVector* getSolutionVector();
+      virtual float minFitness();
+      virtual float avgFitness();
+      virtual float maxFitness();
+
+      /**
+       * @brief Cancel all solvers and wait for their threads.
+       */
+      virtual void stop();
+
+      /**
+       * @brief @return Returns true if a complete solver has finished, so
+       * that no more solutions exist.
+       */
+      bool isExhausted();
+
+    protected:
+      virtual void initialize();
+      virtual void doStep();
+
+    private:
+      struct Private;
+      Private *d;
+  };
+
+} // namespace FastSatSolver
+
+#endif // PORTFOLIOSATSOLVER_H
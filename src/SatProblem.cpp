@@ -28,12 +28,105 @@
 #include "SatSolver.h"
 #include "Scanner.h"
 #include "Formula.h"
+#include "FormulaCode.h"
+#include "FormulaDag.h"
+#include "LaneKernel.h"
 #include "SatProblem.h"
 
 using std::string;
 
 namespace FastSatSolver {
 
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // LaneCounter implementation
+  inline int popCount(TLaneMask mask) {
+#ifdef __GNUC__
+    return __builtin_popcountl(mask);
+#else
+    int count = 0;
+    for(; mask; mask &= mask-1)
+      count++;
+    return count;
+#endif
+  }
+  LaneCounter::LaneCounter() {
+    this->clear();
+  }
+  void LaneCounter::clear() {
+    for(int k=0; k<PLANES; k++)
+      plane_[k] = 0UL;
+    used_ = 0;
+  }
+  void LaneCounter::add(TLaneMask lanes) {
+    // Ripple-carry addition of one bit to each lane
+    TLaneMask carry = lanes;
+    for(int k=0; carry; k++) {
+      assert(k < PLANES);
+      const TLaneMask next = plane_[k] & carry;
+      plane_[k] ^= carry;
+      carry = next;
+      if (k >= used_)
+        used_ = k+1;
+    }
+  }
+  void LaneCounter::load(const TLaneMask *planes, int count, int stride) {
+    assert(count <= PLANES);
+    for(int k=0; k<PLANES; k++)
+      plane_[k] = (k < count) ? planes[k*stride] : 0UL;
+    used_ = count;
+  }
+  int LaneCounter::getCount(int lane) const {
+    assert(lane < LANE_BITS);
+    int result = 0;
+    for(int k=0; k<used_; k++)
+      result |= static_cast<int>((plane_[k] >> lane) & 1UL) << k;
+    return result;
+  }
+  TLaneMask LaneCounter::equalTo(int value) const {
+    if (used_ < PLANES && (value >> used_))
+      // Value is out of range of all counters
+      return 0UL;
+
+    TLaneMask mask = ~0UL;
+    for(int k=0; k<used_; k++) {
+      if ((value >> k) & 1)
+        mask &= plane_[k];
+      else
+        mask &= ~plane_[k];
+    }
+    return mask;
+  }
+  int LaneCounter::min(TLaneMask lanes) const {
+    assert(lanes);
+    int result = 0;
+    for(int k=used_-1; k>=0; k--) {
+      const TLaneMask zeros = lanes & ~plane_[k];
+      if (zeros)
+        lanes = zeros;
+      else
+        result |= 1<<k;
+    }
+    return result;
+  }
+  int LaneCounter::max(TLaneMask lanes) const {
+    assert(lanes);
+    int result = 0;
+    for(int k=used_-1; k>=0; k--) {
+      const TLaneMask ones = lanes & plane_[k];
+      if (ones) {
+        lanes = ones;
+        result |= 1<<k;
+      }
+    }
+    return result;
+  }
+  long LaneCounter::sum(TLaneMask lanes) const {
+    long result = 0L;
+    for(int k=0; k<used_; k++)
+      result += static_cast<long>(popCount(plane_[k] & lanes)) << k;
+    return result;
+  }
+
   // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   // SatProblem implementation
   struct SatProblem::Private {
@@ -41,6 +134,7 @@ namespace FastSatSolver {
     VariableContainer   vc;
     FormulaContainer    fc;
     std::string         fileName;
+    ILaneKernel         *kernel;
 
     void parseFile(FILE *);
     void parserLoop(IScanner *);
@@ -50,8 +144,10 @@ namespace FastSatSolver {
     d(new Private)
   {
     d->hasError = false;
+    d->kernel = LaneKernelFactory::create();
   }
   SatProblem::~SatProblem() {
+    delete d->kernel;
     delete d;
   }
   void SatProblem::loadFromFile (std::string fileName ) {
@@ -193,6 +289,87 @@ namespace FastSatSolver {
   }
 
 
+  /**
+   * @param  vars
+   * @param  counter
+   */
+  void SatProblem::getSatsCountLanes (const TLaneMask *vars, LaneCounter *counters) {
+    d->fc.evalAllLanes(d->kernel, vars, counters);
+  }
+
+
+  /**
+   * @param  bits
+   */
+  void SatProblem::setLaneBits (int bits) {
+    ILaneKernel *kernel = LaneKernelFactory::create(bits);
+    delete d->kernel;
+    d->kernel = kernel;
+  }
+
+
+  /**
+   * @return ILaneKernel
+   */
+  ILaneKernel* SatProblem::getLaneKernel ( ) {
+    return d->kernel;
+  }
+
+
+  /**
+   * @return FormulaCode
+   */
+  const FormulaCode& SatProblem::getProgram ( ) {
+    return d->fc.getProgram();
+  }
+
+
+  /**
+   */
+  void SatProblem::shareSubexpressions ( ) {
+    d->fc.shareSubexpressions();
+  }
+
+
+  /**
+   */
+  void SatProblem::simplify ( ) {
+    d->fc.simplify();
+  }
+
+
+  /**
+   * @return int
+   */
+  int SatProblem::getTautologiesCount ( ) {
+    return d->fc.getTautologiesCount();
+  }
+
+
+  /**
+   * @return int
+   */
+  int SatProblem::getContradictionsCount ( ) {
+    return d->fc.getContradictionsCount();
+  }
+
+
+  /**
+   * @param  evaluator
+   */
+  void SatProblem::setEvaluator (IContainerEvaluator *evaluator ) {
+    d->fc.setEvaluator(evaluator);
+  }
+
+
+  /**
+   * @return IContainerEvaluator
+   */
+  IContainerEvaluator* SatProblem::getEvaluator ( ) {
+    return d->fc.getEvaluator();
+  }
+
+
   /**
    * @return bool
    */
@@ -241,15 +418,28 @@ namespace FastSatSolver {
   struct FormulaContainer::Private {
       typedef std::list<IFormulaEvaluator *> TContainer;
       TContainer container;
+      FormulaCode program;
+      IContainerEvaluator *evaluator;
+      int satsOffset;                 ///< count of removed tautologies
+      int contradictions;             ///< count of removed contradictions
+
+      // Rebuild program through DAG
+      void rebuild(bool simplify, bool share);
+
+      static const int LOCAL_PACKED_SIZE = 16;
   };
   FormulaContainer::FormulaContainer():
     d(new Private)
   {
+    d->evaluator = 0;
+    d->satsOffset = 0;
+    d->contradictions = 0;
   }
   FormulaContainer::~FormulaContainer() {
     Private::TContainer::iterator iter;
     for(iter=d->container.begin(); iter!=d->container.end(); iter++)
       delete *iter;
+    delete d->evaluator;
     delete d;
   }
 
@@ -267,15 +457,50 @@ namespace FastSatSolver {
    * @param  data
    */
   int FormulaContainer::evalAll (ISatItem *data ) {
-    int counter = 0;
-
-    Private::TContainer::iterator iter;
-    for(iter=d->container.begin(); iter!=d->container.end(); iter++) {
-      IFormulaEvaluator *fe = *iter;
-      counter += fe->eval(data);
+    if (!d->evaluator)
+      // Run bytecode of all formulas at once
+      return d->satsOffset + d->program.evalCount(data);
+
+    // Pack assignment to machine words (on heap only for huge problems)
+    const int nVars = data->getLength();
+    const int nWords = (nVars + LANE_BITS - 1) / LANE_BITS;
+    TLaneMask local[Private::LOCAL_PACKED_SIZE];
+    std::vector<TLaneMask> heap;
+    TLaneMask *packed = local;
+    if (nWords > Private::LOCAL_PACKED_SIZE) {
+      heap.resize(nWords);
+      packed = &heap[0];
     }
+    for(int w=0; w<nWords; w++)
+      packed[w] = 0UL;
+    for(int i=0; i<nVars; i++)
+      if (data->getBit(i))
+        packed[i/LANE_BITS] |= 1UL << (i%LANE_BITS);
 
-    return counter;
+    return d->satsOffset + d->evaluator->evalPacked(packed);
+  }
+
+  /**
+   * @param  kernel
+   * @param  vars
+   * @param  counters
+   */
+  void FormulaContainer::evalAllLanes (ILaneKernel *kernel, const TLaneMask *vars, LaneCounter *counters ) {
+    const FormulaCode &program = d->program;
+    const bool ok = kernel->run(
+        program.getData(),
+        program.getLength(),
+        program.getMaxDepth(),
+        program.getTempsCount(),
+        vars,
+        counters);
+    if (!ok)
+      throw GenericException("FormulaContainer::evalAllLanes(): out of memory");
+
+    // Tautologies are satisfied by each assignment
+    for(int w=0; w<kernel->getWidth(); w++)
+      for(int i=0; i<d->satsOffset; i++)
+        counters[w].add(~0UL);
   }
 
   /**
@@ -283,6 +508,68 @@ namespace FastSatSolver {
    */
   void FormulaContainer::addFormula (IFormulaEvaluator *formula ) {
     d->container.push_back(formula);
+
+    // Extend program evaluating all formulas
+    d->program.append(formula->getCode());
+    d->program.append(OP_COUNT);
+  }
+
+  /**
+   * @return FormulaCode
+   */
+  const FormulaCode& FormulaContainer::getProgram ( ) {
+    return d->program;
+  }
+
+  /**
+   */
+  void FormulaContainer::shareSubexpressions ( ) {
+    d->rebuild(false, true);
+  }
+
+  /**
+   */
+  void FormulaContainer::simplify ( ) {
+    d->rebuild(true, false);
+  }
+
+  /**
+   * @return int
+   */
+  int FormulaContainer::getTautologiesCount ( ) {
+    return d->satsOffset;
+  }
+
+  /**
+   * @return int
+   */
+  int FormulaContainer::getContradictionsCount ( ) {
+    return d->contradictions;
+  }
+
+  void FormulaContainer::Private::rebuild(bool simplify, bool share) {
+    FormulaDag dag;
+    dag.setSimplify(simplify);
+    dag.addProgram(program);
+    program.clear();
+    dag.writeProgram(program, share);
+    satsOffset += dag.getTautologiesCount();
+    contradictions += dag.getContradictionsCount();
+  }
+
+  /**
+   * @param  evaluator
+   */
+  void FormulaContainer::setEvaluator (IContainerEvaluator *evaluator ) {
+    delete d->evaluator;
+    d->evaluator = evaluator;
+  }
+
+  /**
+   * @return IContainerEvaluator
+   */
+  IContainerEvaluator* FormulaContainer::getEvaluator ( ) {
+    return d->evaluator;
   }
 
 } // namespace FastSatSolver
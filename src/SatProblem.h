@@ -28,12 +28,95 @@
  * @ingroup SatProblem
  */
 
+#include <limits.h>
 #include <string>
 #include "Scanner.h"
 
 namespace FastSatSolver {
   class ISatItem;
   class IFormulaEvaluator;
+  class ILaneKernel;
+  class FormulaCode;
+
+  /**
+   * Bit @c j of lane mask holds value (of variable or formula) for @c j-th
+   * assignment of a block evaluated at once.
+   * @brief Machine word used for bit-parallel (bitsliced) evaluation.
+   * @ingroup SatProblem
+   */
+  typedef unsigned long TLaneMask;
+
+  /**
+   * @brief Count of assignments evaluated at once using TLaneMask.
+   * @ingroup SatProblem
+   */
+  static const int LANE_BITS = sizeof(TLaneMask) * CHAR_BIT;
+
+  /**
+   * Counts are stored bit-sliced (as vertical binary counter), so one
+   * formula's result is added to all lanes by a few word operations.
+   * @brief Counter of satisfied formulas for each of LANE_BITS assignments.
+   * @ingroup SatProblem
+   */
+  class LaneCounter
+  {
+    public:
+      LaneCounter();
+
+      /**
+       * @brief Reset all counters to zero.
+       */
+      void clear();
+
+      /**
+       * @brief Increment counters of lanes selected by mask.
+       * @param lanes Lane mask, typically result of formula evaluation.
+       */
+      void add(TLaneMask lanes);
+
+      /**
+       * @brief Replace all counters by bit-sliced values.
+       * @param planes Array of bit planes, the least significant first.
+       * @param count Count of planes to read.
+       * @param stride Distance (in words) between two consecutive planes.
+       */
+      void load(const TLaneMask *planes, int count, int stride);
+
+      /**
+       * @brief @return Returns counter of desired lane.
+       * @param lane Index of lane should be in range <0, LANE_BITS-1>.
+       */
+      int getCount(int lane) const;
+
+      /**
+       * @brief @return Returns mask of lanes with counter equal to value.
+       * @param value Value to compare counters with.
+       */
+      TLaneMask equalTo(int value) const;
+
+      /**
+       * @brief @return Returns the least counter of selected lanes.
+       * @param lanes Non-empty lane mask selecting counters to look at.
+       */
+      int min(TLaneMask lanes) const;
+
+      /**
+       * @brief @return Returns the greatest counter of selected lanes.
+       * @param lanes Non-empty lane mask selecting counters to look at.
+       */
+      int max(TLaneMask lanes) const;
+
+      /**
+       * @brief @return Returns sum of counters of selected lanes.
+       * @param lanes Lane mask selecting counters to sum.
+       */
+      long sum(TLaneMask lanes) const;
+
+    private:
+      static const int PLANES = sizeof(int) * CHAR_BIT;
+      TLaneMask   plane_[PLANES];
+      int         used_;
+  };
 
   /**
    * It can transform variable name to its integral index and vice versa.
@@ -69,6 +152,27 @@ namespace FastSatSolver {
       Private *d;
   };
 
+  /**
+   * It replaces interpretation of bytecode in FormulaContainer::evalAll(),
+   * typically by native code compiled from the bytecode.
+   * @brief Evaluator of all formulas in FormulaContainer at once.
+   * @interface IContainerEvaluator
+   * @ingroup SatProblem
+   */
+  class IContainerEvaluator
+  {
+    public:
+      virtual ~IContainerEvaluator() { }
+
+      /**
+       * @brief Evaluate all formulas using given assignment.
+       * @param packed Packed assignment. Value of variable @c i is bit
+       * @c i%LANE_BITS of word @c i/LANE_BITS.
+       * @return Returns count of satisfied formulas.
+       */
+      virtual int evalPacked (const TLaneMask *packed) = 0;
+  };
+
   /**
    * @note The only one known implementation is now InterpretedFormula, but
    * there is no restriction to this class. It can be any class implementing
@@ -96,12 +200,79 @@ namespace FastSatSolver {
        */
       int evalAll (ISatItem *data);
 
+      /**
+       * @brief Evaluate all formulas in container for block of assignments
+       * at once.
+       * @param kernel Kernel to use for evaluation. Consider
+       * FastSatSolver::ILaneKernel interface for detail.
+       * @param vars Array of kernel->getWidth() lane masks for each variable.
+       * Bit @c j of word @c w of variable @c i (stored at index
+       * @c i*kernel->getWidth()+w) is value of the variable in
+       * @c (w*LANE_BITS+j)-th assignment of block.
+       * @param counters Array of kernel->getWidth() counters to store
+       * counts of satisfied formulas to.
+       */
+      void evalAllLanes (
+                         ILaneKernel        *kernel,
+                         const TLaneMask    *vars,
+                         LaneCounter        *counters);
+
       /**
        * @brief Add formula to container.
        * @param formula Formula object to add.
        */
       void addFormula (IFormulaEvaluator *formula );
 
+      /**
+       * @brief @return Returns bytecode of all formulas, each of them
+       * terminated by OP_COUNT instruction.
+       */
+      const FormulaCode& getProgram ( );
+
+      /**
+       * @brief Rebuild program so that subexpressions common to more
+       * formulas (or repeated in one formula) are evaluated only once.
+       * Consider FastSatSolver::FormulaDag class.
+       * @note Evaluator set by setEvaluator() should be created after this.
+       */
+      void shareSubexpressions ( );
+
+      /**
+       * @brief Rewrite program using algebraic simplification rules.
+       * Formulas simplified to constants are removed from program, count
+       * of tautologies is still included in result of evalAll() and
+       * evalAllLanes(). Consider FastSatSolver::FormulaDag::setSimplify().
+       * @note It should be called before shareSubexpressions().
+       */
+      void simplify ( );
+
+      /**
+       * @brief @return Returns count of formulas found to be tautologies
+       * by simplify().
+       */
+      int getTautologiesCount ( );
+
+      /**
+       * @brief @return Returns count of formulas found to be contradictions
+       * by simplify(). Problem has no solution if it is nonzero.
+       */
+      int getContradictionsCount ( );
+
+      /**
+       * @brief Replace interpretation of bytecode by another evaluator.
+       * @param evaluator Evaluator to use by evalAll(). Zero means bytecode
+       * interpreter (default).
+       * @attention On heap allocated object is expected. It will be deleted
+       * by container's destructor.
+       */
+      void setEvaluator (IContainerEvaluator *evaluator );
+
+      /**
+       * @brief @return Returns evaluator used by evalAll(), zero if bytecode
+       * is interpreted.
+       */
+      IContainerEvaluator* getEvaluator ( );
+
     private:
       struct Private;
       Private *d;
@@ -150,6 +321,60 @@ namespace FastSatSolver {
        */
       int getSatsCount (ISatItem *data);
 
+      /**
+       * @brief Evaluate all formulas for block of assignments at once using
+       * kernel returned by getLaneKernel().
+       * @copydetails FastSatSolver::FormulaContainer::evalAllLanes(ILaneKernel*, const TLaneMask*, LaneCounter*)
+       */
+      void getSatsCountLanes (const TLaneMask *vars, LaneCounter *counters);
+
+      /**
+       * @brief Select kernel used by getSatsCountLanes().
+       * @param bits Count of assignments evaluated at once. Zero means the
+       * widest kernel supported by running CPU (default).
+       */
+      void setLaneBits (int bits);
+
+      /**
+       * @brief @return Returns kernel used by getSatsCountLanes().
+       */
+      ILaneKernel* getLaneKernel ( );
+
+      /**
+       * @brief @copydoc FastSatSolver::FormulaContainer::getProgram()
+       */
+      const FormulaCode& getProgram ( );
+
+      /**
+       * @brief @copydoc FastSatSolver::FormulaContainer::shareSubexpressions()
+       */
+      void shareSubexpressions ( );
+
+      /**
+       * @brief @copydoc FastSatSolver::FormulaContainer::simplify()
+       */
+      void simplify ( );
+
+      /**
+       * @brief @copydoc FastSatSolver::FormulaContainer::getTautologiesCount()
+       */
+      int getTautologiesCount ( );
+
+      /**
+       * @brief @copydoc FastSatSolver::FormulaContainer::getContradictionsCount()
+       */
+      int getContradictionsCount ( );
+
+      /**
+       * @brief @copydoc FastSatSolver::FormulaContainer::setEvaluator(IContainerEvaluator*)
+       */
+      void setEvaluator (IContainerEvaluator *evaluator );
+
+      /**
+       * @brief @copydoc FastSatSolver::FormulaContainer::getEvaluator()
+       */
+      IContainerEvaluator* getEvaluator ( );
+
       /**
        * @brief @return Returns true if SAT Problem is @b not valid.
        */
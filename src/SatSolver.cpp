@@ -58,12 +58,14 @@ namespace FastSatSolver {
   // AbstractProcess implementation
   struct AbstractProcess::Private {
     bool running;
+    bool betweenSteps;
     int steps;
   };
   AbstractProcess::AbstractProcess():
     d(new Private)
   {
     d->running = false;
+    d->betweenSteps = false;
     d->steps = 0;
   }
   AbstractProcess::~AbstractProcess() {
@@ -72,7 +74,9 @@ namespace FastSatSolver {
   void AbstractProcess::start() {
     for(d->running=true; d->running; d->steps++) {
       this->doStep();
+      d->betweenSteps = true;
       this->notify();
+      d->betweenSteps = false;
     }
   }
   void AbstractProcess::stop() {
@@ -86,6 +90,9 @@ namespace FastSatSolver {
   int AbstractProcess::getStepsCount() {
     return d->steps;
   }
+  bool AbstractProcess::isBetweenSteps() {
+    return d->betweenSteps;
+  }
 
   // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   // AbstractProcessWatched implementation
@@ -147,6 +154,25 @@ namespace FastSatSolver {
   AbstractSatSolver::~AbstractSatSolver() { }
 
 
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // VectorSatItem implementation
+  VectorSatItem::VectorSatItem(const std::vector<bool> &data):
+    data_(data)
+  {
+  }
+  VectorSatItem::~VectorSatItem() {
+  }
+  int VectorSatItem::getLength() const {
+    return data_.size();
+  }
+  bool VectorSatItem::getBit(int index) const {
+    return data_[index];
+  }
+  VectorSatItem* VectorSatItem::clone() const {
+    return new VectorSatItem(data_);
+  }
+
+
   // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   // SatItemVector implementation
   struct SatItemVector::Private {
@@ -280,5 +306,21 @@ namespace FastSatSolver {
     d->set.clear();
   }
 
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // luby() implementation
+  long luby(int index) {
+    int size = 1, seq = 0;
+    while (size < index+1) {
+      seq++;
+      size = 2*size+1;
+    }
+    while (size-1 != index) {
+      size = (size-1)>>1;
+      seq--;
+      index = index % size;
+    }
+    return 1L<<seq;
+  }
+
 } // namespace FastSatSolver
 
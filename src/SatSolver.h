@@ -29,6 +29,7 @@
  */
 
 #include <iostream>
+#include <vector>
 
 namespace FastSatSolver {
   class SatProblem;
@@ -63,6 +64,25 @@ namespace FastSatSolver {
       virtual bool getBit (int index ) const = 0;
   };
 
+  /**
+   * @brief ISatItem implementation storing one bool per variable, usable
+   * for problems of any size.
+   * @ingroup SatSolver
+   */
+  class VectorSatItem: public ISatItem {
+    public:
+      /**
+       * @param data Value of each variable (indexed by variable's index).
+       */
+      VectorSatItem(const std::vector<bool> &data);
+      virtual ~VectorSatItem();
+      virtual int getLength() const;
+      virtual bool getBit(int index) const;
+      virtual VectorSatItem* clone() const;
+    private:
+      std::vector<bool> data_;
+  };
+
   /**
    * @interface IObserver
    * @brief Simple observer's base class.
@@ -154,6 +174,21 @@ namespace FastSatSolver {
       virtual void reset() = 0;
   };
 
+  /**
+   * @interface IProgressIndicator
+   * @brief Process which knows how much of its work is done.
+   * @ingroup SatSolver
+   */
+  class IProgressIndicator {
+    public:
+      virtual ~IProgressIndicator() { }
+
+      /**
+       * @brief @return Returns done part of work (from 0.0 to 1.0).
+       */
+      virtual double getProgress() = 0;
+  };
+
   /**
    * @brief Base class of simple multi-step process.
    * @ingroup SatSolver
@@ -174,6 +209,12 @@ namespace FastSatSolver {
        * @return Returns current step number.
        */
       virtual int getStepsCount();
+
+      /**
+       * @brief @return Returns true while observers are notified of step
+       * done, false while they are notified from the middle of step.
+       */
+      bool isBetweenSteps();
     protected:
       AbstractProcess();
       
@@ -320,8 +361,10 @@ namespace FastSatSolver {
   };
 
   /**
-   * It defines common interface (and partially behavior) for both solver
-   * implementations - BlindSolver and GaSolver.
+   * It defines common interface (and partially behavior) for all solver
+   * implementations - BlindSatSolver, CdclSatSolver, CountingSatSolver,
+   * DistributedSatSolver, DistributedWorker, GaSatSolver, IslandSatSolver,
+   * LocalSearchSatSolver and PortfolioSatSolver.
    * @brief SAT Solver base class.
    * @ingroup SatSolver
    */
@@ -373,6 +416,14 @@ namespace FastSatSolver {
       Private *d;
   };
 
+  /**
+   * Used as schedule of restarts (1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ...).
+   * @brief Element of Luby sequence.
+   * @param index Index of element, counted from 0.
+   * @ingroup SatSolver
+   */
+  long luby(int index);
+
 } // namespace FastSatSolver
 
 #endif // SATSOLVER_H
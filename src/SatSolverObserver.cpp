@@ -17,12 +17,15 @@
  * along with fss.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <sys/time.h>
 #include <iostream>
 #include <iomanip>
 #include <ga/GAStatistics.h>
 #include "fssIO.h"
 #include "SatSolver.h"
+#include "Checkpoint.h"
 #include "GaSatSolver.h"
+#include "IslandSatSolver.h"
 #include "SatSolverObserver.h"
 
 namespace FastSatSolver {
@@ -69,6 +72,48 @@ namespace FastSatSolver {
     if (elapsed > d->msec)
       d->process->stop();
   }
+  void TimedStop::setTimeout(long msec) {
+    d->msec = msec;
+  }
+
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // CheckpointWatch implementation
+  struct CheckpointWatch::Private {
+    AbstractProcess   *process;
+    ICheckpointable   *target;
+    std::string       fileName;
+    long              msec;
+    long              last;         ///< time of last checkpoint
+
+    static long now() {
+      struct timeval tv;
+      gettimeofday(&tv, 0);
+      return tv.tv_sec * 1000L + tv.tv_usec / 1000L;
+    }
+  };
+  CheckpointWatch::CheckpointWatch(AbstractProcess *process, ICheckpointable *target, const std::string &fileName, long msec):
+    d(new Private)
+  {
+    d->process = process;
+    d->target = target;
+    d->fileName = fileName;
+    d->msec = msec;
+    d->last = Private::now();
+  }
+  CheckpointWatch::~CheckpointWatch() {
+    delete d;
+  }
+  void CheckpointWatch::notify() {
+    if (!d->process->isBetweenSteps())
+      return;
+    if (Private::now() - d->last >= d->msec)
+      this->save();
+  }
+  void CheckpointWatch::save() {
+    d->target->saveCheckpoint(d->fileName);
+    d->last = Private::now();
+  }
 
 
   // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -98,6 +143,10 @@ namespace FastSatSolver {
 
     int generation = 0;
     GaSatSolver *gaSolver= dynamic_cast<GaSatSolver *>(solver);
+    IslandSatSolver *islandSolver= dynamic_cast<IslandSatSolver *>(solver);
+    if (islandSolver)
+      // Islands evolve in lock-step
+      gaSolver = islandSolver->getIsland(0);
     if (gaSolver) {
       GAStatistics stats= gaSolver->getStatistics();
       generation = stats.generation();
@@ -160,10 +209,11 @@ namespace FastSatSolver {
   }
 
   struct ProgressWatch::Private {
-    AbstractProcess *process;
-    int             stepsTotal;
-    int             last;
-    std::ostream    &stream;
+    AbstractProcess     *process;
+    IProgressIndicator  *indicator;
+    int                 stepsTotal;
+    int                 last;
+    std::ostream        &stream;
 
     Private(std::ostream &streamTo): stream(streamTo) { }
   };
@@ -171,9 +221,18 @@ namespace FastSatSolver {
     d(new Private(streamTo))
   {
     d->process = process;
+    d->indicator = 0;
     d->stepsTotal = stepsTotal;
     d->last = 0;
   }
+  ProgressWatch::ProgressWatch(IProgressIndicator *indicator, std::ostream &streamTo):
+    d(new Private(streamTo))
+  {
+    d->process = 0;
+    d->indicator = indicator;
+    d->stepsTotal = 0;
+    d->last = 0;
+  }
   ProgressWatch::~ProgressWatch() {
     delete d;
   }
@@ -181,10 +240,9 @@ namespace FastSatSolver {
     using namespace StreamDecorator;
 
     // Check percentage value
-    const int currentStep= d->process->getStepsCount();
-    const int percents=
-      currentStep*100 /
-      d->stepsTotal;
+    const int percents= (d->indicator)
+      ? static_cast<int>(d->indicator->getProgress()*100)
+      : d->process->getStepsCount()*100 / d->stepsTotal;
     if (percents == d->last)
       return;
     d->last = percents;
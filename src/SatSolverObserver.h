@@ -30,9 +30,11 @@
  */
 
 #include <iostream>
+#include <string>
 #include "SatSolver.h"
 
 namespace FastSatSolver {
+  class ICheckpointable;
 
   /**
    * @brief Observer which stops process after specified time.
@@ -47,6 +49,44 @@ namespace FastSatSolver {
       TimedStop(AbstractProcessWatched *process, long msec);
       virtual ~TimedStop();
       virtual void notify();
+
+      /**
+       * @brief Change time to stop process after.
+       * @param msec Time in milliseconds.
+       */
+      void setTimeout(long msec);
+    private:
+      struct Private;
+      Private *d;
+  };
+
+  /**
+   * Checkpoint is saved only between steps of process, never from the
+   * middle of step.
+   * @brief Observer which saves checkpoint of process periodically.
+   * @ingroup SatSolver
+   */
+  class CheckpointWatch: public IObserver {
+    public:
+      /**
+       * @param process Observed process.
+       * @param target Process (the same one) to save checkpoint of.
+       * @param fileName Name of checkpoint file.
+       * @param msec Period of checkpoints in milliseconds (of real time).
+       */
+      CheckpointWatch(
+                      AbstractProcess     *process,
+                      ICheckpointable     *target,
+                      const std::string   &fileName,
+                      long                msec);
+      virtual ~CheckpointWatch();
+      virtual void notify();
+
+      /**
+       * @brief Save checkpoint now.
+       * @note Process should not be running.
+       */
+      void save();
     private:
       struct Private;
       Private *d;
@@ -67,6 +107,14 @@ namespace FastSatSolver {
                     AbstractProcess   *process,
                     int               stepsTotal,
                     std::ostream      &streamTo);
+
+      /**
+       * @param indicator Observed process able to tell its progress.
+       * @param streamTo Standard output stream to write to.
+       */
+      ProgressWatch(
+                    IProgressIndicator  *indicator,
+                    std::ostream        &streamTo);
       
       virtual ~ProgressWatch();
       virtual void notify();
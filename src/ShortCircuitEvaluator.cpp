@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <assert.h>
+#include <algorithm>
+#include <vector>
+#include "FormulaCode.h"
+#include "ShortCircuitEvaluator.h"
+
+namespace FastSatSolver {
+
+  namespace {
+    // Node of formula tree (builder), negation is folded to node
+    struct TreeNode {
+      EOpCode             opCode;     ///< OP_FALSE, OP_TRUE, OP_VAR, OP_AND, OP_OR or OP_XOR
+      bool                neg;
+      int                 var;
+      std::vector<int>    children;
+      int                 size;       ///< count of nodes of subtree
+      unsigned long       evals;      ///< sampled evaluations
+      unsigned long       decides;    ///< sampled values deciding parent's result
+    };
+    typedef std::vector<TreeNode> TTree;
+
+    // Node of flattened tree (prefix order), operands follow their operator
+    struct FlatNode {
+      EOpCode             opCode;
+      bool                neg;
+      int                 arg;        ///< index of variable or count of operands
+      int                 size;       ///< count of nodes of subtree
+      int                 node;       ///< index of TreeNode
+    };
+
+    inline bool readVar(const TLaneMask *packed, int var) {
+      return (packed[var/LANE_BITS] >> (var%LANE_BITS)) & 1UL;
+    }
+
+    bool evalShort(const FlatNode *n, const TLaneMask *packed) {
+      bool value = false;
+      const FlatNode *c = n + 1;
+      switch (n->opCode) {
+        case OP_FALSE:  value = false;                          break;
+        case OP_TRUE:   value = true;                           break;
+        case OP_VAR:    value = readVar(packed, n->arg);        break;
+        case OP_AND:
+          value = true;
+          for(int i=0; i<n->arg; i++, c+=c->size)
+            if (!evalShort(c, packed)) {
+              value = false;
+              break;
+            }
+          break;
+        case OP_OR:
+          for(int i=0; i<n->arg; i++, c+=c->size)
+            if (evalShort(c, packed)) {
+              value = true;
+              break;
+            }
+          break;
+        case OP_XOR:
+          for(int i=0; i<n->arg; i++, c+=c->size)
+            value ^= evalShort(c, packed);
+          break;
+        default:
+          assert(false);
+      }
+      return value != n->neg;
+    }
+
+    // Evaluate all operands and count which of them decided the result
+    bool evalSample(const FlatNode *n, const TLaneMask *packed, TTree &tree) {
+      bool value = false;
+      const FlatNode *c = n + 1;
+      switch (n->opCode) {
+        case OP_FALSE:  value = false;                          break;
+        case OP_TRUE:   value = true;                           break;
+        case OP_VAR:    value = readVar(packed, n->arg);        break;
+        case OP_AND:
+        case OP_OR:
+          // Operand decides AND if false, OR if true
+          value = (OP_AND == n->opCode);
+          for(int i=0; i<n->arg; i++, c+=c->size) {
+            const bool operand = evalSample(c, packed, tree);
+            TreeNode &stat = tree[c->node];
+            stat.evals++;
+            if (operand != (OP_AND == n->opCode)) {
+              stat.decides++;
+              value = operand;
+            }
+          }
+          break;
+        case OP_XOR:
+          for(int i=0; i<n->arg; i++, c+=c->size)
+            value ^= evalSample(c, packed, tree);
+          break;
+        default:
+          assert(false);
+      }
+      return value != n->neg;
+    }
+
+    // Cheap operands likely to decide go first
+    class CostOrder {
+      public:
+        CostOrder(const TTree &tree): tree_(tree) { }
+        bool operator() (int a, int b) const {
+          return key(a) < key(b);
+        }
+      private:
+        const TTree &tree_;
+        double key(int id) const {
+          const TreeNode &node = tree_[id];
+          const double p = (node.decides + 1.0) / (node.evals + 2.0);
+          return node.size / p;
+        }
+    };
+  } // namespace
+
+  // ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // ShortCircuitEvaluator implementation
+  struct ShortCircuitEvaluator::Private {
+    TTree                   tree;
+    std::vector<int>        roots;
+    std::vector<FlatNode>   flat;
+    std::vector<int>        flatRoots;
+    unsigned long           evalCounter;
+
+    static const int SAMPLE_SIZE = 256;           ///< sampled evaluations per period
+    static const int SAMPLE_PERIOD = 1<<16;       ///< evaluations per period
+
+    int createLeaf(EOpCode opCode, int var);
+    int createBinary(EOpCode opCode, int a, int b);
+    int clone(int id);
+    int computeSize(int id);
+    void sortOperands(int id);
+    void emit(int id);
+  };
+  int ShortCircuitEvaluator::Private::createLeaf(EOpCode opCode, int var) {
+    TreeNode node;
+    node.opCode = opCode;
+    node.neg = false;
+    node.var = var;
+    node.size = 1;
+    node.evals = 0;
+    node.decides = 0;
+    tree.push_back(node);
+    return tree.size() - 1;
+  }
+  int ShortCircuitEvaluator::Private::createBinary(EOpCode opCode, int a, int b) {
+    const int id = createLeaf(opCode, 0);
+    if (OP_XOR == opCode) {
+      // x^~y = ~(x^y)
+      tree[id].neg = tree[a].neg != tree[b].neg;
+      tree[a].neg = false;
+      tree[b].neg = false;
+    }
+
+    // Flatten chains of the same operator
+    const int operands[2] = { a, b };
+    for(int i=0; i<2; i++) {
+      const TreeNode &operand = tree[operands[i]];
+      if (opCode == operand.opCode && !operand.neg) {
+        const std::vector<int> children(operand.children);
+        tree[id].children.insert(tree[id].children.end(), children.begin(), children.end());
+      } else {
+        tree[id].children.push_back(operands[i]);
+      }
+    }
+    return id;
+  }
+  int ShortCircuitEvaluator::Private::clone(int id) {
+    const int copy = createLeaf(tree[id].opCode, tree[id].var);
+    tree[copy].neg = tree[id].neg;
+    const std::vector<int> children(tree[id].children);
+    for(unsigned i=0; i<children.size(); i++) {
+      const int child = clone(children[i]);
+      tree[copy].children.push_back(child);
+    }
+    return copy;
+  }
+  int ShortCircuitEvaluator::Private::computeSize(int id) {
+    int size = 1;
+    const std::vector<int> children(tree[id].children);
+    for(unsigned i=0; i<children.size(); i++)
+      size += computeSize(children[i]);
+    tree[id].size = size;
+    return size;
+  }
+  void ShortCircuitEvaluator::Private::sortOperands(int id) {
+    std::vector<int> &children = tree[id].children;
+    for(unsigned i=0; i<children.size(); i++)
+      sortOperands(children[i]);
+    if (OP_AND == tree[id].opCode || OP_OR == tree[id].opCode)
+      std::stable_sort(children.begin(), children.end(), CostOrder(tree));
+  }
+  void ShortCircuitEvaluator::Private::emit(int id) {
+    const TreeNode &node = tree[id];
+    const int pos = flat.size();
+    FlatNode fn;
+    fn.opCode = node.opCode;
+    fn.neg = node.neg;
+    fn.arg = (OP_VAR == node.opCode) ? node.var : node.children.size();
+    fn.size = 1;
+    fn.node = id;
+    flat.push_back(fn);
+    for(unsigned i=0; i<node.children.size(); i++)
+      emit(node.children[i]);
+    flat[pos].size = flat.size() - pos;
+  }
+
+  ShortCircuitEvaluator::ShortCircuitEvaluator(const FormulaCode &program):
+    d(new Private)
+  {
+    d->evalCounter = 0;
+
+    // Build trees from postfix code
+    const Instruction *code = program.getData();
+    const int length = program.getLength();
+    std::vector<int> stack;
+    std::vector<int> temps(program.getTempsCount(), -1);
+    for(int i=0; i<length; i++) {
+      const Instruction &instr = code[i];
+      int a, b;
+      switch (instr.opCode) {
+        case OP_FALSE:
+        case OP_TRUE:
+        case OP_VAR:
+          stack.push_back(d->createLeaf(instr.opCode, instr.var));
+          break;
+
+        case OP_NOT:
+          d->tree[stack.back()].neg = !d->tree[stack.back()].neg;
+          break;
+
+        case OP_AND:
+        case OP_OR:
+        case OP_XOR:
+          b = stack.back();
+          stack.pop_back();
+          a = stack.back();
+          stack.back() = d->createBinary(instr.opCode, a, b);
+          break;
+
+        case OP_COUNT:
+          d->roots.push_back(stack.back());
+          stack.pop_back();
+          break;
+
+        case OP_LOAD:
+          // Shared subexpression becomes a tree again
+          stack.push_back(d->clone(temps[instr.var]));
+          break;
+
+        case OP_STORE:
+          temps[instr.var] = d->clone(stack.back());
+          break;
+      }
+    }
+    assert(stack.empty());
+    for(unsigned i=0; i<d->roots.size(); i++)
+      d->computeSize(d->roots[i]);
+    this->reorder();
+  }
+  ShortCircuitEvaluator::~ShortCircuitEvaluator() {
+    delete d;
+  }
+  int ShortCircuitEvaluator::sample(const TLaneMask *packed) {
+    int count = 0;
+    for(unsigned i=0; i<d->flatRoots.size(); i++)
+      count += evalSample(&d->flat[d->flatRoots[i]], packed, d->tree);
+    return count;
+  }
+  void ShortCircuitEvaluator::reorder() {
+    d->flat.clear();
+    d->flatRoots.clear();
+    for(unsigned i=0; i<d->roots.size(); i++) {
+      const int root = d->roots[i];
+      d->sortOperands(root);
+      d->flatRoots.push_back(d->flat.size());
+      d->emit(root);
+    }
+
+    // Age statistics, so that recent samples prevail
+    TTree::iterator iter;
+    for(iter=d->tree.begin(); iter!=d->tree.end(); iter++) {
+      iter->evals >>= 1;
+      iter->decides >>= 1;
+    }
+  }
+  int ShortCircuitEvaluator::getNodesCount() {
+    return d->flat.size();
+  }
+  int ShortCircuitEvaluator::evalPacked (const TLaneMask *packed) {
+    const unsigned long phase = d->evalCounter++ % Private::SAMPLE_PERIOD;
+    if (phase < static_cast<unsigned long>(Private::SAMPLE_SIZE)) {
+      // Sampling phase of period
+      const int count = this->sample(packed);
+      if (phase == Private::SAMPLE_SIZE - 1)
+        this->reorder();
+      return count;
+    }
+
+    int count = 0;
+    const FlatNode *flat = d->flat.empty() ? 0 : &d->flat[0];
+    for(unsigned i=0; i<d->flatRoots.size(); i++)
+      count += evalShort(flat + d->flatRoots[i], packed);
+    return count;
+  }
+
+} // namespace FastSatSolver
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef SHORTCIRCUITEVALUATOR_H
+#define SHORTCIRCUITEVALUATOR_H
+
+/**
+ * @file ShortCircuitEvaluator.h
+ * @brief Tree evaluation of formulas with short-circuit AND/OR
+ * @author Kamil Dudka <xdudka00@gmail.com>
+ * @date 2008-11-12
+ * @ingroup SatProblem
+ */
+
+#include "SatProblem.h"
+
+namespace FastSatSolver {
+  class FormulaCode;
+
+  /**
+   * Program is turned back to trees. Negations are folded to nodes, chains
+   * of the same operator are flattened to n-ary nodes. AND stops on first
+   * false operand, OR on first true one. Operands are ordered by ratio of
+   * their cost (size of subtree) and probability they decide the result.
+   * The probability is sampled periodically from evaluated assignments, so
+   * the order follows actual (e.g. converging GA) population.
+   * @brief Container evaluator using short-circuit evaluation of trees.
+   * @attention Sampling changes evaluator's state, so one object must not
+   * be used by more threads at once.
+   * @ingroup SatProblem
+   */
+  class ShortCircuitEvaluator: public IContainerEvaluator {
+    public:
+      /**
+       * @param program Bytecode of all formulas, each of them terminated by
+       * OP_COUNT instruction. Consider FormulaContainer::getProgram().
+       */
+      ShortCircuitEvaluator(const FormulaCode &program);
+      virtual ~ShortCircuitEvaluator();
+
+      /**
+       * @brief Sample given assignment (evaluates all operands).
+       * @param packed Packed assignment, consider evalPacked().
+       * @return Returns count of satisfied formulas.
+       */
+      int sample(const TLaneMask *packed);
+
+      /**
+       * @brief Reorder operands using sampled statistics (if any) and
+       * static cost.
+       */
+      void reorder();
+
+      /**
+       * @brief @return Returns count of nodes of all trees.
+       */
+      int getNodesCount();
+
+      virtual int evalPacked (const TLaneMask *packed);
+
+    private:
+      ShortCircuitEvaluator(const ShortCircuitEvaluator &);
+      ShortCircuitEvaluator& operator= (const ShortCircuitEvaluator &);
+      struct Private;
+      Private *d;
+  };
+
+} // namespace FastSatSolver
+
+#endif // SHORTCIRCUITEVALUATOR_H
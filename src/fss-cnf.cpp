@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <string.h>
+#include <iostream>
+#include <string>
+#include "fssIO.h"
+#include "FormulaCode.h"
+#include "SatProblem.h"
+#include "CnfFormula.h"
+
+using namespace FastSatSolver;
+
+/**
+ * USAGE:
+ * ./fss-cnf [-t] INPUT
+ *
+ * Reads SAT problem from file INPUT ('-' means standard input) and writes
+ * its equisatisfiable CNF in DIMACS format to standard output. Option -t
+ * turns off polarity optimization (full Tseitin encoding preserving count
+ * of models).
+ */
+int main(int argc, char *argv[]) {
+  bool polarity = true;
+  int argi = 1;
+  if (argi < argc && 0==strcmp(argv[argi], "-t")) {
+    polarity = false;
+    argi++;
+  }
+  if (argi+1 != argc) {
+    std::cerr << "Usage: fss-cnf [-t] INPUT" << std::endl;
+    return 1;
+  }
+  const std::string inputFile(argv[argi]);
+  int exitCode = 0;
+  SatProblem *satProblem = 0;
+  CnfFormula *cnf = 0;
+  try {
+    // Read input data
+    satProblem = new SatProblem;
+    static const char INPUT_STDIN[] = "-";
+    if (inputFile == INPUT_STDIN)
+      satProblem->loadFromInput();
+    else
+      satProblem->loadFromFile(inputFile);
+    if (satProblem->hasError())
+      throw GenericException("Invalid input data");
+
+    // Smaller formulas give smaller CNF
+    satProblem->simplify();
+    satProblem->shareSubexpressions();
+
+    cnf = new CnfFormula(satProblem, polarity);
+    cnf->writeDimacs(std::cout);
+    std::cerr << "--- " << satProblem->getFormulasCount() << " formulas ("
+      << satProblem->getProgram().getNodesCount() << " nodes) over "
+      << satProblem->getVarsCount() << " variables -> "
+      << cnf->getClausesCount() << " clauses over "
+      << cnf->getVarsCount() << " variables" << std::endl;
+  }
+  catch (GenericException e) {
+    printError(e.getText());
+    exitCode = 1;
+  }
+  delete cnf;
+  delete satProblem;
+  return exitCode;
+}
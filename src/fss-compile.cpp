@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2008 Kamil Dudka <xdudka00@stud.fit.vutbr.cz>
+ *
+ * This file is part of fss (Fast SAT Solver).
+ *
+ * fss is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * fss is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with fss.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "fssIO.h"
+#include "SatProblem.h"
+#include "NativeModule.h"
+
+using namespace FastSatSolver;
+
+namespace {
+  // Append words of text (separated by white spaces) to args
+  void splitWords(const char *text, std::vector<std::string> &args) {
+    std::istringstream stream(text);
+    std::string word;
+    while (stream >> word)
+      args.push_back(word);
+  }
+
+  // Run program given by args[0] without shell, return true on success
+  bool runProgram(const std::vector<std::string> &args) {
+    std::vector<char *> argv;
+    for(unsigned i=0; i<args.size(); i++)
+      argv.push_back(const_cast<char *>(args[i].c_str()));
+    argv.push_back(0);
+
+    const pid_t pid = fork();
+    if (pid < 0)
+      return false;
+    if (0 == pid) {
+      execvp(argv[0], &argv[0]);
+      _exit(127);
+    }
+    int status;
+    if (pid != waitpid(pid, &status, 0))
+      return false;
+    return WIFEXITED(status) && 0 == WEXITSTATUS(status);
+  }
+}
+
+/**
+ * USAGE:
+ * ./fss-compile INPUT MODULE
+ *
+ * Reads SAT problem from file INPUT ('-' means standard input), writes its
+ * evaluation code to MODULE.cpp and builds shared object MODULE by compiler
+ * given by CXX environment variable (c++ by default) using CXXFLAGS
+ * (-O2 by default). Module can be then loaded by fss (parameter
+ * native_module) unless simplification or sharing of subexpressions is
+ * turned off.
+ */
+int main(int argc, char *argv[]) {
+  if (argc<3) {
+    std::cerr << "Usage: fss-compile INPUT MODULE" << std::endl;
+    return 1;
+  }
+  const std::string inputFile(argv[1]);
+  const std::string moduleFile(argv[2]);
+  const std::string sourceFile(moduleFile + ".cpp");
+  int exitCode = 0;
+  SatProblem *satProblem = 0;
+  try {
+    // Read input data
+    satProblem = new SatProblem;
+    static const char INPUT_STDIN[] = "-";
+    if (inputFile == INPUT_STDIN)
+      satProblem->loadFromInput();
+    else
+      satProblem->loadFromFile(inputFile);
+    if (satProblem->hasError())
+      throw GenericException("Invalid input data");
+
+    // Same program as fss uses by default (parameters simplify and
+    // share_subexpr)
+    satProblem->simplify();
+    satProblem->shareSubexpressions();
+
+    // Generate source code
+    std::ofstream source(sourceFile.c_str());
+    if (!source)
+      throw GenericException("Can't write to '" + sourceFile + "'");
+    NativeModule::writeSource(satProblem, source);
+    source.close();
+    if (!source)
+      throw GenericException("Can't write to '" + sourceFile + "'");
+
+    // Build shared object by system compiler
+    const char *cxx = getenv("CXX");
+    const char *cxxFlags = getenv("CXXFLAGS");
+    std::vector<std::string> args;
+    splitWords((cxx) ? cxx : "c++", args);
+    splitWords((cxxFlags) ? cxxFlags : "-O2", args);
+    if (args.empty())
+      throw GenericException("No compiler given by CXX");
+    args.push_back("-shared");
+    args.push_back("-fPIC");
+    args.push_back("-o");
+    args.push_back(moduleFile);
+    args.push_back(sourceFile);
+    for(unsigned i=0; i<args.size(); i++)
+      std::cout << args[i] << ((i+1 < args.size()) ? " " : "\n");
+    std::cout << std::flush;
+    if (!runProgram(args))
+      throw GenericException("Compilation of '" + sourceFile + "' failed");
+  }
+  catch (GenericException e) {
+    printError(e.getText());
+    exitCode = 1;
+  }
+  delete satProblem;
+  return exitCode;
+}
@@ -17,15 +17,31 @@
  * along with fss.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <limits.h>
+#include <unistd.h>
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <vector>
 #include <ga/GAParameter.h>
 #include <ga/GAStatistics.h>
 #include "fssIO.h"
 #include "SatProblem.h"
+#include "BigNumber.h"
+#include "FormulaCode.h"
+#include "LaneKernel.h"
+#include "JitEvaluator.h"
+#include "NativeModule.h"
+#include "ShortCircuitEvaluator.h"
 #include "BlindSatSolver.h"
+#include "CdclSatSolver.h"
+#include "CountingSatSolver.h"
+#include "DistributedSatSolver.h"
 #include "GaSatSolver.h"
+#include "IslandSatSolver.h"
+#include "LocalSearchSatSolver.h"
+#include "PortfolioSatSolver.h"
 #include "SatSolverObserver.h"
 
 using std::string;
@@ -60,14 +76,112 @@ int main(int argc, char *argv[]) {
       "blind_solver(blind)............. Switch between blind and GA solver.\n"
       "                                 1 means blind solver,\n"
       "                                 0 means GA solver(default).\n"
+      "cdcl_solver(cdcl)............... 1 means complete solver using conflict-driven\n"
+      "                                 clause learning (instead of GA solver).\n"
+      "local_search(ls)................ 1 means solver using stochastic local search\n"
+      "                                 (instead of GA solver).\n"
+      "model_count(count).............. 1 means solver computing exact count of\n"
+      "                                 solutions without enumerating them\n"
+      "                                 (instead of GA solver).\n"
+      "portfolio(portfolio)............ Comma separated list of solvers racing\n"
+      "                                 in parallel threads (instead of GA solver).\n"
+      "                                 Possible solvers are ga, blind, cdcl and ls,\n"
+      "                                 e.g. ga,ga,cdcl,ls. Default is empty.\n"
       "step_width(stepw)............... (only for blind solver) granularity of solver's\n"
       "                                 notifications and control. Default is 16.\n"
+      "gray_code(gray)................. (only for blind solver) 1/0 turns on/off\n"
+      "                                 enumeration of 512 assignment blocks in\n"
+      "                                 Gray code order, which reevaluates only\n"
+      "                                 formulas containing the changed variable.\n"
+      "branch_bound(bnb)............... (only for blind solver) 1/0 turns on/off\n"
+      "                                 depth-first search pruning assignments\n"
+      "                                 which falsify any formula.\n"
+      "listen(listen).................. (only for blind solver) address to listen\n"
+      "                                 on for workers exploring leases of space,\n"
+      "                                 unix:PATH or [HOST:]PORT.\n"
+      "connect(connect)................ (only for blind solver) address of\n"
+      "                                 coordinator to explore leases for.\n"
+      "lease_bits(leaseb).............. (only for blind solver) binary logarithm\n"
+      "                                 of count of assignments in one lease.\n"
+      "                                 Default is 24.\n"
+      "range_start(rstart)............. (only for blind solver) position of the\n"
+      "                                 first assignment to explore (in decimal),\n"
+      "                                 aligned to chunks of 2^step_width\n"
+      "                                 assignments, but at least of lane_bits\n"
+      "                                 assignments (512 in Gray code mode).\n"
+      "                                 Default is 0.\n"
+      "range_end(rend)................. (only for blind solver) position following\n"
+      "                                 the last assignment to explore, aligned\n"
+      "                                 the same way. Default is 2^(count of\n"
+      "                                 variables).\n"
+      "checkpoint_file(ckpt)........... (only for blind and GA solver) file to save\n"
+      "                                 solver's state to periodically.\n"
+      "checkpoint_period(ckptper)...... (only for blind and GA solver) period of\n"
+      "                                 checkpoints in ms. Default is 60000.\n"
+      "resume(resume).................. (only for blind and GA solver) 1 -> Resume\n"
+      "                                 from checkpoint_file if it exists.\n"
+      "threads(threads)................ (only for blind and GA solver) count of\n"
+      "                                 threads exploring the space or evaluating\n"
+      "                                 population. Default is 1, 0 means count\n"
+      "                                 of CPUs.\n"
+      "step_conflicts(stepc)........... (only for CDCL solver) granularity of solver's\n"
+      "                                 notifications and control. Default is 1000.\n"
+      "step_decisions(stepd)........... (only for counting solver) granularity of\n"
+      "                                 solver's notifications and control.\n"
+      "                                 Default is 10000.\n"
+      "max_flips(maxflips)............. (only for local search) count of flips\n"
+      "                                 in one run. Default is 1000000.\n"
+      "noise(noise).................... (only for local search) probability of\n"
+      "                                 random walk. Default is 0.5.\n"
+      "lane_bits(lanes)................ Count of assignments evaluated at once\n"
+      "                                 (64, 128, 256 or 512). Default is 0, which\n"
+      "                                 means the widest one supported by CPU.\n"
+      "simplify(simp).................. 1/0 turns on/off algebraic simplification\n"
+      "                                 of formulas. Default is 1.\n"
+      "share_subexpr(cse).............. 1/0 turns on/off evaluation of common\n"
+      "                                 subexpressions only once. Default is 1.\n"
+      "jit_compile(jit)................ (only for GA solver) 1/0 turns on/off\n"
+      "                                 compilation of formulas to native code.\n"
+      "native_module(native)........... (only for GA solver) shared object built\n"
+      "                                 by fss-compile for the same input_file.\n"
+      "short_circuit(sc)............... (only for GA solver) 1/0 turns on/off\n"
+      "                                 short-circuit evaluation of formula trees\n"
+      "                                 (single thread without islands only).\n"
+      "incremental_eval(inceval)....... (only for GA solver) 1/0 turns on/off\n"
+      "                                 reevaluation of only formulas containing\n"
+      "                                 variables changed since parent genome.\n"
+      "memetic_rate(memrate)........... (only for GA solver) fraction of genomes\n"
+      "                                 refined by local search in each generation.\n"
+      "                                 Default is 0.\n"
+      "memetic_flips(memflips)......... (only for GA solver) count of flips\n"
+      "                                 of refined genome. Default is 100.\n"
+      "formula_weighting(fweight)...... (only for GA solver) 1/0 turns on/off\n"
+      "                                 fitness given by weighted formulas, weights\n"
+      "                                 grow for formulas left unsatisfied.\n"
+      "elite_archive(archive).......... (only for GA solver) count of the best\n"
+      "                                 genomes kept among runs. Default is 0.\n"
+      "elite_seed_rate(seedrate)....... (only for GA solver) fraction of population\n"
+      "                                 seeded from elite archive at start of run.\n"
+      "                                 Default is 0.1.\n"
+      "number_of_populations(npop)..... (only for GA solver) count of islands\n"
+      "                                 evolving in parallel threads. Default is 1,\n"
+      "                                 0 means count of CPUs.\n"
+      "migration_number(nmig).......... (only for GA solver) count of the best\n"
+      "                                 individuals migrating from island to its\n"
+      "                                 neighbours. Default is 5.\n"
+      "migration_interval(migint)...... (only for GA solver) count of generations\n"
+      "                                 between migrations. Default is 10.\n"
+      "migration_topology(migtopo)..... (only for GA solver) neighbours of islands,\n"
+      "                                 ring or complete. Default is ring.\n"
       "min_count_of_solutions(minslns). Minimal count of solutions requested.\n"
       "max_count_of_solutions(maxslns). Maximal count of solutions to look for.\n"
       "max_count_of_runs(maxruns)...... GA is restarted for max. maxruns times if\n"
       "                                 not all minslns solutions are found.\n"
       "max_time_per_run(maxtime)....... Run is be stopped unconditionally if maxtime\n"
       "                                 time is exceed (in miliseconds).\n"
+      "luby_restarts(luby)............. 1/0 turns on/off time limits of runs given\n"
+      "                                 by Luby sequence (1, 1, 2, 1, 1, 2, 4, ...)\n"
+      "                                 in units of maxtime.\n"
       "term_upon_convergence(convterm). 0 -> Run is be stopped after ngen generations.\n"
       "                                 1 -> Run is be stopped upon convergence.\n"
       "\n"
@@ -87,34 +201,88 @@ int main(int argc, char *argv[]) {
   TimedStop           *timedStop = 0;
   FitnessWatch        *fitnessWatch = 0;
   ResultsWatch        *resultsWatch = 0;
+  CheckpointWatch     *checkpointWatch = 0;
   SatItemVector       *results = 0;
   try {
     // Parse cmd-line parameters
     GAParameterList params;
     // GaSatSolver-specific parameters
     GaSatSolver::registerDefaultParameters(params);
+    IslandSatSolver::registerDefaultParameters(params);
 
     // Default values of parameters
     const char DEF_INPUT_FILE[] = "";
     const GABoolean DEF_VERBOSE_MODE = gaFalse;
     const GABoolean DEF_COLOR_OUTPUT = gaFalse;
     const GABoolean DEF_BLIND_SOLVER = gaFalse;
+    const GABoolean DEF_CDCL_SOLVER = gaFalse;
+    const GABoolean DEF_LOCAL_SEARCH = gaFalse;
+    const GABoolean DEF_MODEL_COUNT = gaFalse;
+    const char DEF_PORTFOLIO[] = "";
     const int DEF_MIN_COUNT_OF_SOLUTIONS =  1;
     const int DEF_MAX_COUNT_OF_SOLUTIONS =  8;
     const int DEF_MAX_COUNT_OF_RUNS =       8;
     const int DEF_MAX_TIME_PER_RUN =        0;
+    const GABoolean DEF_LUBY_RESTARTS = gaFalse;
     const int DEF_STEP_WIDTH =              16;
+    const GABoolean DEF_GRAY_CODE = gaFalse;
+    const GABoolean DEF_BRANCH_BOUND = gaFalse;
+    const int DEF_THREADS =                 1;
+    const char DEF_LISTEN[] = "";
+    const char DEF_CONNECT[] = "";
+    const int DEF_LEASE_BITS =              24;
+    const char DEF_RANGE_START[] = "";
+    const char DEF_RANGE_END[] = "";
+    const char DEF_CHECKPOINT_FILE[] = "";
+    const int DEF_CHECKPOINT_PERIOD =       60000;
+    const GABoolean DEF_RESUME = gaFalse;
+    const int DEF_STEP_CONFLICTS =          1000;
+    const int DEF_STEP_DECISIONS =          10000;
+    const int DEF_MAX_FLIPS =               1000000;
+    const float DEF_NOISE =                 0.5;
+    const int DEF_LANE_BITS =               0;
+    const GABoolean DEF_SIMPLIFY = gaTrue;
+    const GABoolean DEF_SHARE_SUBEXPR = gaTrue;
+    const GABoolean DEF_JIT_COMPILE = gaFalse;
+    const char DEF_NATIVE_MODULE[] = "";
+    const GABoolean DEF_SHORT_CIRCUIT = gaFalse;
 
     // Register extra parameters
     params.add("verbose_mode",            "verbose",  GAParameter::BOOLEAN,     &DEF_VERBOSE_MODE);
     params.add("color_output",            "color",    GAParameter::BOOLEAN,     &DEF_COLOR_OUTPUT);
     params.add("blind_solver",            "blind",    GAParameter::BOOLEAN,     &DEF_BLIND_SOLVER);
+    params.add("cdcl_solver",             "cdcl",     GAParameter::BOOLEAN,     &DEF_CDCL_SOLVER);
+    params.add("local_search",            "ls",       GAParameter::BOOLEAN,     &DEF_LOCAL_SEARCH);
+    params.add("model_count",             "count",    GAParameter::BOOLEAN,     &DEF_MODEL_COUNT);
+    params.add("portfolio",               "portfolio",GAParameter::STRING,      &DEF_PORTFOLIO);
     params.add("input_file",              "input",    GAParameter::STRING,      &DEF_INPUT_FILE);
     params.add("min_count_of_solutions",  "minslns",  GAParameter::INT,         &DEF_MIN_COUNT_OF_SOLUTIONS);
     params.add("max_count_of_solutions",  "maxslns",  GAParameter::INT,         &DEF_MAX_COUNT_OF_SOLUTIONS);
     params.add("max_count_of_runs",       "maxruns",  GAParameter::INT,         &DEF_MAX_COUNT_OF_RUNS);
     params.add("max_time_per_run",        "maxtime",  GAParameter::INT,         &DEF_MAX_TIME_PER_RUN);
+    params.add("luby_restarts",           "luby",     GAParameter::BOOLEAN,     &DEF_LUBY_RESTARTS);
     params.add("step_width",              "stepw",    GAParameter::INT,         &DEF_STEP_WIDTH);
+    params.add("gray_code",               "gray",     GAParameter::BOOLEAN,     &DEF_GRAY_CODE);
+    params.add("branch_bound",            "bnb",      GAParameter::BOOLEAN,     &DEF_BRANCH_BOUND);
+    params.add("threads",                 "threads",  GAParameter::INT,         &DEF_THREADS);
+    params.add("listen",                  "listen",   GAParameter::STRING,      &DEF_LISTEN);
+    params.add("connect",                 "connect",  GAParameter::STRING,      &DEF_CONNECT);
+    params.add("lease_bits",              "leaseb",   GAParameter::INT,         &DEF_LEASE_BITS);
+    params.add("range_start",             "rstart",   GAParameter::STRING,      &DEF_RANGE_START);
+    params.add("range_end",               "rend",     GAParameter::STRING,      &DEF_RANGE_END);
+    params.add("checkpoint_file",         "ckpt",     GAParameter::STRING,      &DEF_CHECKPOINT_FILE);
+    params.add("checkpoint_period",       "ckptper",  GAParameter::INT,         &DEF_CHECKPOINT_PERIOD);
+    params.add("resume",                  "resume",   GAParameter::BOOLEAN,     &DEF_RESUME);
+    params.add("step_conflicts",          "stepc",    GAParameter::INT,         &DEF_STEP_CONFLICTS);
+    params.add("step_decisions",          "stepd",    GAParameter::INT,         &DEF_STEP_DECISIONS);
+    params.add("max_flips",               "maxflips", GAParameter::INT,         &DEF_MAX_FLIPS);
+    params.add("noise",                   "noise",    GAParameter::FLOAT,       &DEF_NOISE);
+    params.add("lane_bits",               "lanes",    GAParameter::INT,         &DEF_LANE_BITS);
+    params.add("simplify",                "simp",     GAParameter::BOOLEAN,     &DEF_SIMPLIFY);
+    params.add("share_subexpr",           "cse",      GAParameter::BOOLEAN,     &DEF_SHARE_SUBEXPR);
+    params.add("jit_compile",             "jit",      GAParameter::BOOLEAN,     &DEF_JIT_COMPILE);
+    params.add("native_module",           "native",   GAParameter::STRING,      &DEF_NATIVE_MODULE);
+    params.add("short_circuit",           "sc",       GAParameter::BOOLEAN,     &DEF_SHORT_CIRCUIT);
 
     // parse using GAParameterList class
     params.parse(argc, argv, gaTrue);
@@ -123,6 +291,55 @@ int main(int argc, char *argv[]) {
     GABoolean useBlindSolver= DEF_BLIND_SOLVER;
     params.get("blind_solver", &useBlindSolver);
 
+    // true for CDCL solver
+    GABoolean useCdclSolver= DEF_CDCL_SOLVER;
+    params.get("cdcl_solver", &useCdclSolver);
+
+    // true for local search solver
+    GABoolean useLocalSearch= DEF_LOCAL_SEARCH;
+    params.get("local_search", &useLocalSearch);
+
+    // true for counting solver
+    GABoolean useModelCount= DEF_MODEL_COUNT;
+    params.get("model_count", &useModelCount);
+    // list of solvers racing in parallel
+    const char *szPortfolio=
+      static_cast<const char *>
+      (params("portfolio")->value());
+    std::vector<string> portfolio;
+    if (szPortfolio) {
+      const string list(szPortfolio);
+      for(string::size_type pos=0; pos < list.size();) {
+        string::size_type end = list.find(',', pos);
+        if (string::npos == end)
+          end = list.size();
+        const string name = list.substr(pos, end-pos);
+        if (name != "ga" && name != "blind" && name != "cdcl" && name != "ls")
+          throw GenericException("Unknown solver '" + name + "' in parameter 'portfolio'");
+        portfolio.push_back(name);
+        pos = end + 1;
+      }
+    }
+    const bool usePortfolio= !portfolio.empty();
+    if (1 < !!useBlindSolver + !!useCdclSolver + !!useLocalSearch + !!useModelCount + usePortfolio)
+      throw GenericException("Parameters 'blind_solver', 'cdcl_solver', 'local_search', 'model_count' and 'portfolio' are exclusive");
+    const bool useGaSolver= !useBlindSolver && !useCdclSolver && !useLocalSearch && !useModelCount && !usePortfolio;
+
+    // count of islands (only for GA solver)
+    int populations= 1;
+    params.get("number_of_populations", &populations);
+    const bool useIslands= useGaSolver && 1 != populations;
+
+    // solvers involved (either alone or in portfolio)
+    const bool withGa= useGaSolver
+      || portfolio.end() != std::find(portfolio.begin(), portfolio.end(), "ga");
+    const bool withBlind= useBlindSolver
+      || portfolio.end() != std::find(portfolio.begin(), portfolio.end(), "blind");
+    const bool withCdcl= useCdclSolver
+      || portfolio.end() != std::find(portfolio.begin(), portfolio.end(), "cdcl");
+    const bool withLocalSearch= useLocalSearch
+      || portfolio.end() != std::find(portfolio.begin(), portfolio.end(), "ls");
+
     // turn on/off color output (using escape squences)
     GABoolean useColorOutput= DEF_COLOR_OUTPUT;
     params.get("color_output", &useColorOutput);
@@ -174,6 +391,14 @@ int main(int argc, char *argv[]) {
       maxTime = DEF_MAX_TIME_PER_RUN;
     }
 
+    // Time limits of runs given by Luby sequence
+    GABoolean useLuby= DEF_LUBY_RESTARTS;
+    params.get("luby_restarts", &useLuby);
+    if (useLuby && !maxTime) {
+      printError("Parameter 'luby_restarts' requires 'max_time_per_run'");
+      useLuby = gaFalse;
+    }
+
     // Step width (only for blind solver)
     int stepWidth= DEF_STEP_WIDTH;
     params.get("step_width", &stepWidth);
@@ -182,18 +407,270 @@ int main(int argc, char *argv[]) {
       stepWidth = DEF_STEP_WIDTH;
     }
 
-    if (useBlindSolver) {
-      // exclude parameters for blind solver
+    // Gray code enumeration (only for blind solver)
+    GABoolean useGrayCode= DEF_GRAY_CODE;
+    params.get("gray_code", &useGrayCode);
+
+    // Branch-and-bound search (only for blind solver)
+    GABoolean useBranchBound= DEF_BRANCH_BOUND;
+    params.get("branch_bound", &useBranchBound);
+    if (useGrayCode && useBranchBound)
+      throw GenericException("Parameters 'gray_code' and 'branch_bound' are exclusive");
+
+    // Count of threads (only for blind and GA solver)
+    int threads= DEF_THREADS;
+    params.get("threads", &threads);
+    if (threads < 0) {
+      printError("threads out of range, using default");
+      threads = DEF_THREADS;
+    }
+    if (0 == threads)
+      threads = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+
+    // Distributed search (only for blind solver)
+    const char *szListen=
+      static_cast<const char *>
+      (params("listen")->value());
+    std::string listenOn((szListen) ? szListen : DEF_LISTEN);
+    const char *szConnect=
+      static_cast<const char *>
+      (params("connect")->value());
+    std::string connectTo((szConnect) ? szConnect : DEF_CONNECT);
+    if (!listenOn.empty() && !connectTo.empty())
+      throw GenericException("Parameters 'listen' and 'connect' are exclusive");
+    int leaseBits= DEF_LEASE_BITS;
+    params.get("lease_bits", &leaseBits);
+    if (leaseBits <= 0) {
+      printError("lease_bits out of range, using default");
+      leaseBits = DEF_LEASE_BITS;
+    }
+
+    // Sub-range of assignments (only for blind solver)
+    const char *szRangeStart=
+      static_cast<const char *>
+      (params("range_start")->value());
+    std::string rangeStart((szRangeStart) ? szRangeStart : DEF_RANGE_START);
+    const char *szRangeEnd=
+      static_cast<const char *>
+      (params("range_end")->value());
+    std::string rangeEnd((szRangeEnd) ? szRangeEnd : DEF_RANGE_END);
+
+    // Checkpoints of solver's state (only for blind and GA solver)
+    const char *szCheckpointFile=
+      static_cast<const char *>
+      (params("checkpoint_file")->value());
+    std::string checkpointFile((szCheckpointFile) ? szCheckpointFile : DEF_CHECKPOINT_FILE);
+    int checkpointPeriod= DEF_CHECKPOINT_PERIOD;
+    params.get("checkpoint_period", &checkpointPeriod);
+    if (checkpointPeriod <= 0) {
+      printError("checkpoint_period out of range, using default");
+      checkpointPeriod = DEF_CHECKPOINT_PERIOD;
+    }
+    GABoolean useResume= DEF_RESUME;
+    params.get("resume", &useResume);
+
+    // Conflicts per step (only for CDCL solver)
+    int stepConflicts= DEF_STEP_CONFLICTS;
+    params.get("step_conflicts", &stepConflicts);
+    if (stepConflicts <= 0) {
+      printError("step_conflicts out of range, using default");
+      stepConflicts = DEF_STEP_CONFLICTS;
+    }
+
+    // Decisions per step (only for counting solver)
+    int stepDecisions= DEF_STEP_DECISIONS;
+    params.get("step_decisions", &stepDecisions);
+    if (stepDecisions <= 0) {
+      printError("step_decisions out of range, using default");
+      stepDecisions = DEF_STEP_DECISIONS;
+    }
+
+    // Flips per run (only for local search)
+    int maxFlips= DEF_MAX_FLIPS;
+    params.get("max_flips", &maxFlips);
+    if (maxFlips <= 0) {
+      printError("max_flips out of range, using default");
+      maxFlips = DEF_MAX_FLIPS;
+    }
+
+    // Probability of random walk (only for local search)
+    float noise= DEF_NOISE;
+    params.get("noise", &noise);
+    if (noise < 0.0 || 1.0 < noise) {
+      printError("noise out of range, using default");
+      noise = DEF_NOISE;
+    }
+
+    // Count of assignments evaluated at once, 0 means auto-detect
+    int laneBits= DEF_LANE_BITS;
+    params.get("lane_bits", &laneBits);
+    if (laneBits < 0) {
+      printError("lane_bits out of range, using default");
+      laneBits = DEF_LANE_BITS;
+    }
+
+    // Algebraic simplification of formulas
+    GABoolean useSimplify= DEF_SIMPLIFY;
+    params.get("simplify", &useSimplify);
+
+    // Evaluate common subexpressions only once
+    GABoolean shareSubexpr= DEF_SHARE_SUBEXPR;
+    params.get("share_subexpr", &shareSubexpr);
+
+    // Compile formulas to native code (only for GA solver)
+    GABoolean useJit= DEF_JIT_COMPILE;
+    params.get("jit_compile", &useJit);
+    if (useJit && !JitEvaluator::isSupported()) {
+      printError("JIT compilation is not supported on this platform");
+      useJit = gaFalse;
+    }
+
+    // Shared object built by fss-compile (only for GA solver)
+    const char *szNativeModule=
+      static_cast<const char *>
+      (params("native_module")->value());
+    std::string nativeModule((szNativeModule) ? szNativeModule : DEF_NATIVE_MODULE);
+
+    // Short-circuit evaluation of trees (only for GA solver)
+    GABoolean useShortCircuit= DEF_SHORT_CIRCUIT;
+    params.get("short_circuit", &useShortCircuit);
+
+    // Incremental evaluation of genomes (only for GA solver)
+    GABoolean useIncrementalEval= gaFalse;
+    params.get("incremental_eval", &useIncrementalEval);
+
+    // Local search refinement of genomes (only for GA solver)
+    float memeticRate= 0.0;
+    params.get("memetic_rate", &memeticRate);
+
+    // Dynamic weighting of formulas (only for GA solver)
+    GABoolean useWeighting= gaFalse;
+    params.get("formula_weighting", &useWeighting);
+
+    // Genomes kept among runs (only for GA solver)
+    int eliteArchive= 0;
+    params.get("elite_archive", &eliteArchive);
+
+    // Only one evaluator can replace bytecode interpreter
+    if (1 < !!useJit + !nativeModule.empty() + !!useShortCircuit + !!useIncrementalEval)
+      throw GenericException("Parameters 'jit_compile', 'native_module', 'short_circuit' and 'incremental_eval' are exclusive");
+
+    const string solverName= (useBlindSolver)
+      ? "blind"
+      : (useCdclSolver) ? "CDCL"
+      : (useModelCount) ? "counting"
+      : (usePortfolio) ? "portfolio"
+      : (useLocalSearch) ? "local search" : "GA";
+    if (withBlind || withCdcl || useModelCount) {
+      // exclude parameters for complete solvers
       if (maxRuns != DEF_MAX_COUNT_OF_RUNS) {
-        printError("Parameter 'max_count_of_runs' is irrelevant for blind solver");
+        printError("Parameter 'max_count_of_runs' is irrelevant for " + solverName + " solver");
       }
       maxRuns = 1;
-    } else {
-      // exclude parameters for GA solver
-      if (stepWidth != DEF_STEP_WIDTH) {
-        printError("Parameter 'step_width' is irrelevant for GA solver");
-        stepWidth = DEF_STEP_WIDTH;
+    }
+    if (usePortfolio && useShortCircuit) {
+      // solvers share one SatProblem instance
+      printError("Parameter 'short_circuit' is not supported by portfolio solver");
+      useShortCircuit = gaFalse;
+    }
+    if (!withGa) {
+      // exclude evaluators of GA solver
+      if (useJit) {
+        printError("Parameter 'jit_compile' is irrelevant for " + solverName + " solver");
+        useJit = gaFalse;
+      }
+      if (!nativeModule.empty()) {
+        printError("Parameter 'native_module' is irrelevant for " + solverName + " solver");
+        nativeModule.clear();
+      }
+      if (useShortCircuit) {
+        printError("Parameter 'short_circuit' is irrelevant for " + solverName + " solver");
+        useShortCircuit = gaFalse;
       }
+      if (useIncrementalEval)
+        printError("Parameter 'incremental_eval' is irrelevant for " + solverName + " solver");
+      if (0.0 < memeticRate)
+        printError("Parameter 'memetic_rate' is irrelevant for " + solverName + " solver");
+      if (useWeighting)
+        printError("Parameter 'formula_weighting' is irrelevant for " + solverName + " solver");
+      if (eliteArchive)
+        printError("Parameter 'elite_archive' is irrelevant for " + solverName + " solver");
+    }
+    if (!withBlind && stepWidth != DEF_STEP_WIDTH) {
+      printError("Parameter 'step_width' is irrelevant for " + solverName + " solver");
+      stepWidth = DEF_STEP_WIDTH;
+    }
+    if (!withBlind && useGrayCode) {
+      printError("Parameter 'gray_code' is irrelevant for " + solverName + " solver");
+      useGrayCode = gaFalse;
+    }
+    if (!withBlind && useBranchBound) {
+      printError("Parameter 'branch_bound' is irrelevant for " + solverName + " solver");
+      useBranchBound = gaFalse;
+    }
+    if (!useBlindSolver && !listenOn.empty()) {
+      printError("Parameter 'listen' is irrelevant for " + solverName + " solver");
+      listenOn.clear();
+    }
+    if (!useBlindSolver && !connectTo.empty()) {
+      printError("Parameter 'connect' is irrelevant for " + solverName + " solver");
+      connectTo.clear();
+    }
+    if (listenOn.empty() && leaseBits != DEF_LEASE_BITS) {
+      printError("Parameter 'lease_bits' is irrelevant without 'listen'");
+      leaseBits = DEF_LEASE_BITS;
+    }
+    bool withRange= !rangeStart.empty() || !rangeEnd.empty();
+    if (withRange && (!useBlindSolver || !listenOn.empty() || !connectTo.empty())) {
+      printError("Parameters 'range_start' and 'range_end' are irrelevant for "
+          + ((useBlindSolver) ? string("distributed") : solverName) + " solver");
+      rangeStart.clear();
+      rangeEnd.clear();
+      withRange = false;
+    }
+    const bool plainBlind= useBlindSolver && listenOn.empty() && connectTo.empty();
+    const bool plainGa= useGaSolver && !useIslands;
+    if (!checkpointFile.empty() && !plainBlind && !plainGa) {
+      printError("Parameter 'checkpoint_file' is irrelevant for "
+          + ((useBlindSolver) ? string("distributed")
+            : (useIslands) ? string("island") : solverName) + " solver");
+      checkpointFile.clear();
+    }
+    if (checkpointFile.empty() && checkpointPeriod != DEF_CHECKPOINT_PERIOD) {
+      printError("Parameter 'checkpoint_period' is irrelevant without 'checkpoint_file'");
+      checkpointPeriod = DEF_CHECKPOINT_PERIOD;
+    }
+    if (checkpointFile.empty() && useResume) {
+      printError("Parameter 'resume' is irrelevant without 'checkpoint_file'");
+      useResume = gaFalse;
+    }
+    if (!connectTo.empty())
+      // coordinator decides when to stop
+      maxSlns = INT_MAX;
+    if ((1 < threads || useIslands) && useShortCircuit) {
+      // threads (and islands running in threads) share one evaluator
+      printError("Parameter 'short_circuit' is not supported by more threads or islands");
+      useShortCircuit = gaFalse;
+    }
+    if (!withBlind && !withGa && threads != DEF_THREADS) {
+      printError("Parameter 'threads' is irrelevant for " + solverName + " solver");
+      threads = DEF_THREADS;
+    }
+    if (!withCdcl && stepConflicts != DEF_STEP_CONFLICTS) {
+      printError("Parameter 'step_conflicts' is irrelevant for " + solverName + " solver");
+      stepConflicts = DEF_STEP_CONFLICTS;
+    }
+    if (!useModelCount && stepDecisions != DEF_STEP_DECISIONS) {
+      printError("Parameter 'step_decisions' is irrelevant for " + solverName + " solver");
+      stepDecisions = DEF_STEP_DECISIONS;
+    }
+    if (!withLocalSearch && maxFlips != DEF_MAX_FLIPS) {
+      printError("Parameter 'max_flips' is irrelevant for " + solverName + " solver");
+      maxFlips = DEF_MAX_FLIPS;
+    }
+    if (!withLocalSearch && noise != DEF_NOISE) {
+      printError("Parameter 'noise' is irrelevant for " + solverName + " solver");
+      noise = DEF_NOISE;
     }
 
     if (verboseMode)
@@ -211,6 +688,61 @@ int main(int argc, char *argv[]) {
     if (satProblem->hasError())
       throw GenericException("Invalid input data");
 
+    // Rewrite formulas before evaluation
+    if (useSimplify) {
+      const int nodesBefore = satProblem->getProgram().getNodesCount();
+      satProblem->simplify();
+      std::cout << Color(C_LIGHT_BLUE) << ">>> Simplified formulas: "
+        << nodesBefore << " -> " << satProblem->getProgram().getNodesCount()
+        << " nodes, " << satProblem->getTautologiesCount()
+        << " tautologies and " << satProblem->getContradictionsCount()
+        << " contradictions removed" << Color() << std::endl;
+    }
+    if (shareSubexpr) {
+      const int nodesBefore = satProblem->getProgram().getNodesCount();
+      satProblem->shareSubexpressions();
+      std::cout << Color(C_LIGHT_BLUE) << ">>> Shared subexpressions: "
+        << nodesBefore << " -> " << satProblem->getProgram().getNodesCount()
+        << " nodes" << Color() << std::endl;
+    }
+
+    // Select kernel of bit-parallel evaluation
+    satProblem->setLaneBits(laneBits);
+    ILaneKernel *laneKernel = satProblem->getLaneKernel();
+    std::cout << Color(C_LIGHT_BLUE) << ">>> Using " << laneKernel->getBits()
+      << "-bit lanes (" << laneKernel->getName() << ")" << Color() << std::endl;
+
+    // Replace bytecode interpreter by native code
+    if (useJit) {
+      JitEvaluator *jit = new JitEvaluator(satProblem->getProgram());
+      satProblem->setEvaluator(jit);
+      std::cout << Color(C_LIGHT_BLUE) << ">>> Using JIT compiled formulas ("
+        << jit->getCodeSize() << " bytes)" << Color() << std::endl;
+    }
+    if (!nativeModule.empty()) {
+      satProblem->setEvaluator(new NativeModuleEvaluator(nativeModule, satProblem));
+      std::cout << Color(C_LIGHT_BLUE) << ">>> Using native module '"
+        << nativeModule << "'" << Color() << std::endl;
+    }
+    if (useShortCircuit) {
+      ShortCircuitEvaluator *sc = new ShortCircuitEvaluator(satProblem->getProgram());
+      satProblem->setEvaluator(sc);
+      std::cout << Color(C_LIGHT_BLUE) << ">>> Using short-circuit evaluation ("
+        << sc->getNodesCount() << " nodes)" << Color() << std::endl;
+    }
+    if (useIncrementalEval)
+      std::cout << Color(C_LIGHT_BLUE) << ">>> Using incremental evaluation of genomes"
+        << Color() << std::endl;
+    if (withGa && 0.0 < memeticRate)
+      std::cout << Color(C_LIGHT_BLUE) << ">>> Using local search refinement of "
+        << FixedFloat(3,1) << memeticRate*100.0 << "% of genomes" << Color() << std::endl;
+    if (withGa && useWeighting)
+      std::cout << Color(C_LIGHT_BLUE) << ">>> Using dynamic weights of formulas"
+        << Color() << std::endl;
+    if (withGa && 0 < eliteArchive)
+      std::cout << Color(C_LIGHT_BLUE) << ">>> Using elite archive of "
+        << eliteArchive << " genomes" << Color() << std::endl;
+
     // Write out compilation statistics
     const int varsCount = satProblem->getVarsCount();
     std::cout << Color(C_YELLOW) << "--- Formulas count: " << Color(C_RED) << satProblem->getFormulasCount() << std::endl;
@@ -228,20 +760,119 @@ int main(int argc, char *argv[]) {
     if (useBlindSolver) {
 
       // create blind solver
-      satSolver = new BlindSatSolver(satProblem, stepWidth);
-      std::cout << Color(C_LIGHT_BLUE) << ">>> Using blind solver" << Color() << std::endl;
-
-      // attach progress indicator
-      const int progressBits = satProblem->getVarsCount()-stepWidth;
-      if (progressBits > 0) {
-        progressWatch = new ProgressWatch(satSolver, 1<<progressBits, std::cout);
-        satSolver->addObserver(progressWatch);
+      BlindSatSolver::Mode mode = BlindSatSolver::MODE_LANES;
+      if (useGrayCode)
+        mode = BlindSatSolver::MODE_GRAY_CODE;
+      if (useBranchBound)
+        mode = BlindSatSolver::MODE_BRANCH_AND_BOUND;
+      if (!listenOn.empty()) {
+        // workers explore the space
+        DistributedSatSolver *distSolver = new DistributedSatSolver(satProblem, listenOn, mode, leaseBits);
+        satSolver = distSolver;
+        std::cout << Color(C_LIGHT_BLUE) << ">>> Using distributed blind solver"
+          << ((useGrayCode) ? " (Gray code order)" : "")
+          << ((useBranchBound) ? " (branch and bound)" : "")
+          << " listening on " << listenOn << Color() << std::endl;
+
+        // attach progress indicator
+        if (satProblem->getVarsCount() > leaseBits) {
+          progressWatch = new ProgressWatch(distSolver, std::cout);
+          satSolver->addObserver(progressWatch);
+        }
+      } else {
+        BlindSatSolver *blindSolver = new BlindSatSolver(satProblem, stepWidth, mode, threads);
+        satSolver = blindSolver;
+        std::cout << Color(C_LIGHT_BLUE) << ">>> Using blind solver"
+          << ((useGrayCode) ? " (Gray code order)" : "")
+          << ((useBranchBound) ? " (branch and bound)" : "");
+        if (1 < threads)
+          std::cout << " with " << threads << " threads";
+        if (!connectTo.empty())
+          std::cout << " for coordinator " << connectTo;
+        std::cout << Color() << std::endl;
+
+        if (withRange) {
+          // explore only sub-range of assignments
+          BigNumber from;
+          BigNumber to = BigNumber::power2(satProblem->getVarsCount());
+          if (!rangeStart.empty() && !from.fromString(rangeStart))
+            throw GenericException("Invalid number in parameter 'range_start': " + rangeStart);
+          if (!rangeEnd.empty() && !to.fromString(rangeEnd))
+            throw GenericException("Invalid number in parameter 'range_end': " + rangeEnd);
+          blindSolver->setRange(from, to);
+          std::cout << Color(C_LIGHT_BLUE) << ">>> Exploring assignments from "
+            << from.toString() << " to " << to.toString() << Color() << std::endl;
+        }
+
+        // attach progress indicator
+        if (connectTo.empty() && satProblem->getVarsCount() > stepWidth) {
+          progressWatch = new ProgressWatch(blindSolver, std::cout);
+          satSolver->addObserver(progressWatch);
+        }
+        if (!connectTo.empty())
+          // explore leases of coordinator
+          satSolver = new DistributedWorker(blindSolver, connectTo);
+      }
+    } else if (useCdclSolver) {
+
+      // create CDCL solver
+      satSolver = new CdclSatSolver(satProblem, stepConflicts);
+      std::cout << Color(C_LIGHT_BLUE) << ">>> Using CDCL solver" << Color() << std::endl;
+    } else if (useModelCount) {
+
+      // create counting solver
+      satSolver = new CountingSatSolver(satProblem, stepDecisions);
+      std::cout << Color(C_LIGHT_BLUE) << ">>> Using counting solver" << Color() << std::endl;
+    } else if (usePortfolio) {
+
+      // create solvers racing in parallel
+      BlindSatSolver::Mode mode = BlindSatSolver::MODE_LANES;
+      if (useGrayCode)
+        mode = BlindSatSolver::MODE_GRAY_CODE;
+      if (useBranchBound)
+        mode = BlindSatSolver::MODE_BRANCH_AND_BOUND;
+      PortfolioSatSolver *portfolioSolver = new PortfolioSatSolver(satProblem, maxSlns);
+      satSolver = portfolioSolver;
+      std::cout << Color(C_LIGHT_BLUE) << ">>> Using portfolio solver (";
+      for(unsigned i=0; i<portfolio.size(); i++) {
+        const string &name = portfolio[i];
+        if (name == "ga") {
+          portfolioSolver->addSolver(GaSatSolver::create(satProblem, params), false);
+          std::cout << "GA";
+        } else if (name == "blind") {
+          portfolioSolver->addSolver(new BlindSatSolver(satProblem, stepWidth, mode, threads), true);
+          std::cout << "blind";
+        } else if (name == "cdcl") {
+          portfolioSolver->addSolver(new CdclSatSolver(satProblem, stepConflicts), true);
+          std::cout << "CDCL";
+        } else {
+          portfolioSolver->addSolver(new LocalSearchSatSolver(satProblem, maxFlips, noise), false);
+          std::cout << "local search";
+        }
+        std::cout << ((i+1 < portfolio.size()) ? ", " : ")");
       }
+      std::cout << Color() << std::endl;
+    } else if (useLocalSearch) {
+
+      // create local search solver
+      satSolver = new LocalSearchSatSolver(satProblem, maxFlips, noise);
+      std::cout << Color(C_LIGHT_BLUE) << ">>> Using local search solver" << Color() << std::endl;
+    } else if (useIslands) {
+
+      // create island model of GA
+      IslandSatSolver *islandSolver = IslandSatSolver::create(satProblem, params);
+      satSolver = islandSolver;
+      std::cout << Color(C_LIGHT_BLUE) << ">>> Using GAlib solver with "
+        << islandSolver->getIslandsCount() << " islands" << Color() << std::endl;
     } else {
 
       // create GA solver
-      satSolver = GaSatSolver::create(satProblem, params);
-      std::cout << Color(C_LIGHT_BLUE) << ">>> Using GAlib solver" << Color() << std::endl;
+      GaSatSolver *gaSolver = GaSatSolver::create(satProblem, params);
+      satSolver = gaSolver;
+      std::cout << Color(C_LIGHT_BLUE) << ">>> Using GAlib solver";
+      if (1 < gaSolver->getThreadsCount())
+        std::cout << " with " << gaSolver->getThreadsCount() << " threads";
+      std::cout << Color() << std::endl;
     }
 
     // Display message if maxFitness is increased
@@ -257,18 +888,44 @@ int main(int argc, char *argv[]) {
       // Run will be stopped if its time exceeds
       timedStop = createAttached<TimedStop>(satSolver, maxTime);
 
+    // Save solver's state periodically
+    ICheckpointable *checkpointable = dynamic_cast<ICheckpointable *>(satSolver);
+    if (!checkpointFile.empty()) {
+      checkpointWatch = new CheckpointWatch(satSolver, checkpointable,
+          checkpointFile, checkpointPeriod);
+      satSolver->addObserver(checkpointWatch);
+    }
+
     int totalSolutions = 0;
     float timeTotal = 0.0;
     for(int i=0; i<maxRuns; i++) {
-      if (1<maxRuns)
-        std::cout << Color(C_GREEN) << ">>> Run" << std::setw(4) << i+1 << " of" << std::setw(4) << maxRuns << Color() << std::endl;
+      if (useLuby)
+        // Restart scheduled by Luby sequence
+        timedStop->setTimeout(maxTime * luby(i));
+      if (1<maxRuns) {
+        std::cout << Color(C_GREEN) << ">>> Run" << std::setw(4) << i+1 << " of" << std::setw(4) << maxRuns;
+        if (useLuby)
+          std::cout << " (time limit " << maxTime * luby(i) << " ms)";
+        std::cout << Color() << std::endl;
+      }
 
       // Initialization
       satSolver->reset();
       fitnessWatch->reset();
+      if (useResume && 0==i && 0==access(checkpointFile.c_str(), F_OK)) {
+        // Continue where the previous process stopped
+        checkpointable->loadCheckpoint(checkpointFile);
+        std::cout << Color(C_LIGHT_BLUE) << ">>> Resumed from checkpoint " << checkpointFile;
+        if (plainGa)
+          std::cout << " (generation " << dynamic_cast<GaSatSolver *>(satSolver)->getGenerationsCount() << ")";
+        std::cout << Color() << std::endl;
+      }
 
       // Start progress
       satSolver->start();
+      if (checkpointWatch)
+        // Final state of run
+        checkpointWatch->save();
 
       // Fetch progresse's results
       delete results;
@@ -277,7 +934,16 @@ int main(int argc, char *argv[]) {
       totalSolutions+= runSolutions;
       const float timeElapsed= satSolver->getTimeElapsed()/1000.0;
       timeTotal+= timeElapsed;
-      std::cout
+      if (useModelCount) {
+        // Solutions are counted, not enumerated
+        CountingSatSolver *countingSolver= dynamic_cast<CountingSatSolver *>(satSolver);
+        if (countingSolver->isExhausted()) std::cout
+          << Color(C_GREEN) << "<<< Counted " << countingSolver->getModelsCount().toString()
+          << " solutions in " << FixedFloat(3,2) << timeElapsed << " s" << Color() << std::endl;
+        else std::cout
+          << Color(C_GREEN) << "<<< Counting not finished in " << FixedFloat(3,2) << timeElapsed
+          << " s" << Color() << std::endl;
+      } else std::cout
         << Color(C_GREEN) << "<<< Found" << std::setw(5) << runSolutions << " solutions"
         << " in " << FixedFloat(3,2) << timeElapsed << " s" << Color() << std::endl;
       if (1<maxRuns) std::cout
@@ -293,7 +959,71 @@ int main(int argc, char *argv[]) {
     results->writeOut(satSolver->getProblem(), std::cout);
     std::cout << Color() << std::endl;
 
-    if (verboseMode && !useBlindSolver) {
+    bool exhausted = false;
+    if (useBlindSolver && !listenOn.empty())
+      exhausted = dynamic_cast<DistributedSatSolver *>(satSolver)->isExhausted();
+    else if (useBlindSolver && connectTo.empty())
+      exhausted = dynamic_cast<BlindSatSolver *>(satSolver)->isExhausted();
+    if (useCdclSolver)
+      exhausted = dynamic_cast<CdclSatSolver *>(satSolver)->isExhausted();
+    if (usePortfolio)
+      exhausted = dynamic_cast<PortfolioSatSolver *>(satSolver)->isExhausted();
+    if (useModelCount) {
+      CountingSatSolver *countingSolver= dynamic_cast<CountingSatSolver *>(satSolver);
+      exhausted = countingSolver->isExhausted() && countingSolver->getModelsCount().isZero();
+      if (verboseMode)
+        std::cout << Color(C_CYAN)
+          << "decisions: " << countingSolver->getDecisionsCount() << std::endl
+          << "cache hits: " << countingSolver->getCacheHitsCount()
+          << Color() << std::endl;
+    }
+    if (exhausted && withRange)
+      // only part of space explored
+      std::cout << Color(C_RED) << ((totalSolutions)
+          ? "<<< No more solutions exist in range"
+          : "<<< No solution exists in range")
+        << Color() << std::endl;
+    else if (exhausted)
+      std::cout << Color(C_RED) << ((totalSolutions)
+          ? "<<< No more solutions exist"
+          : "<<< Problem is unsatisfiable")
+        << Color() << std::endl;
+
+    if (useCdclSolver) {
+      CdclSatSolver *cdclSolver= dynamic_cast<CdclSatSolver *>(satSolver);
+      if (verboseMode)
+        std::cout << Color(C_CYAN)
+          << "conflicts: " << cdclSolver->getConflictsCount() << std::endl
+          << "decisions: " << cdclSolver->getDecisionsCount() << std::endl
+          << "learned clauses: " << cdclSolver->getLearntsCount()
+          << Color() << std::endl;
+    }
+
+    if (verboseMode && !listenOn.empty()) {
+      DistributedSatSolver *distSolver= dynamic_cast<DistributedSatSolver *>(satSolver);
+      std::cout << Color(C_CYAN) << "leases re-issued: " << distSolver->getReissuedCount()
+        << Color() << std::endl;
+    }
+    if (verboseMode && !connectTo.empty()) {
+      DistributedWorker *worker= dynamic_cast<DistributedWorker *>(satSolver);
+      std::cout << Color(C_CYAN) << "leases explored: " << worker->getLeasesCount()
+        << Color() << std::endl;
+    }
+
+    if (verboseMode && useLocalSearch) {
+      LocalSearchSatSolver *lsSolver= dynamic_cast<LocalSearchSatSolver *>(satSolver);
+      std::cout << Color(C_CYAN) << "flips: " << lsSolver->getFlipsCount()
+        << Color() << std::endl;
+    }
+
+    if (verboseMode && useIslands) {
+      IslandSatSolver *islandSolver= dynamic_cast<IslandSatSolver *>(satSolver);
+      for(int i=0; i<islandSolver->getIslandsCount(); i++) {
+        GAStatistics stats= islandSolver->getIsland(i)->getStatistics();
+        std::cout << std::endl << Color(C_CYAN) << "island " << i+1 << ":" << std::endl
+          << stats << Color() << std::endl;
+      }
+    } else if (verboseMode && useGaSolver) {
       GaSatSolver *gaSolver= dynamic_cast<GaSatSolver *>(satSolver);
       GAStatistics stats= gaSolver->getStatistics();
       std::cout << std::endl << Color(C_CYAN) << stats << Color() << std::endl;
@@ -305,6 +1035,7 @@ int main(int argc, char *argv[]) {
   }
   // Final clean-up
   delete results;
+  delete checkpointWatch;
   delete resultsWatch;
   delete fitnessWatch;
   delete timedStop;